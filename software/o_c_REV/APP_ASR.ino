@@ -668,19 +668,19 @@ public:
          else if (!digitalReadFast(TR4)) 
             _octave--;
          
+         // scale buffer outputs:
+         if (_mult != MULT_ONE) {
+           for (int i = 0; i < NUM_ASR_CHANNELS; ++i) {
+             int32_t _sample = signed_multiply_32x16b(multipliers[_mult], _asr_buffer[i]);
+             _asr_buffer[i] = signed_saturate_rshift(_sample, 16, 0);
+           }
+         }
+
          // quantize buffer outputs:
+         quantizer_.ProcessBatch(_asr_buffer, _asr_buffer, NUM_ASR_CHANNELS, _root << 7, _transpose);
          for (int i = 0; i < NUM_ASR_CHANNELS; ++i) {
 
-             int32_t _sample = _asr_buffer[i];
-          
-            // scale sample
-             if (_mult != MULT_ONE) {  
-               _sample = signed_multiply_32x16b(multipliers[_mult], _sample);
-               _sample = signed_saturate_rshift(_sample, 16, 0);
-             }
-
-             _sample = quantizer_.Process(_sample, _root << 7, _transpose);
-             _sample = OC::DAC::pitch_to_scaled_voltage_dac(static_cast<DAC_CHANNEL>(i), _sample, _octave, OC::DAC::get_voltage_scaling(i));
+             int32_t _sample = OC::DAC::pitch_to_scaled_voltage_dac(static_cast<DAC_CHANNEL>(i), _asr_buffer[i], _octave, OC::DAC::get_voltage_scaling(i));
              scrolling_history_[i].Push(_sample);
              _asr_buffer[i] = _sample;
          }
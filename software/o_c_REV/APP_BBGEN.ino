@@ -143,8 +143,8 @@ public:
       segments[mapping - BB_CV_MAPPING_GRAVITY] += (cvs[cv_setting - BB_SETTING_CV1]) << (16 - bb_cv_rshift) ;
   }
 
-  template <DAC_CHANNEL dac_channel>
-  void Update(uint32_t triggers, const int32_t cvs[ADC_CHANNEL_LAST]) {
+  // Apply settings and CVs for the next block of ticks
+  void Configure(const int32_t cvs[ADC_CHANNEL_LAST]) {
 
     s[0] = SCALE8_16(static_cast<int32_t>(get_gravity()));
     s[1] = SCALE8_16(static_cast<int32_t>(get_bounce_loss()));
@@ -167,6 +167,10 @@ public:
 
     // hard reset forces the bouncing ball to start at level_[0] on rising gate.
     bb_.set_hard_reset(get_hard_reset());
+  }
+
+  template <DAC_CHANNEL dac_channel>
+  void Update(uint32_t triggers) {
 
     OC::DigitalInput trigger_input = get_trigger_input();
     uint8_t gate_state = 0;
@@ -239,19 +243,31 @@ public:
     ui.cursor.Init(BB_SETTING_GRAVITY, BB_SETTING_LAST - 1);
   }
 
-  void ISR() {
-    cv1.push(OC::ADC::value<ADC_CHANNEL_1>());
-    cv2.push(OC::ADC::value<ADC_CHANNEL_2>());
-    cv3.push(OC::ADC::value<ADC_CHANNEL_3>());
-    cv4.push(OC::ADC::value<ADC_CHANNEL_4>());
+  void BeginBlock() {
+    const int32_t cv[ADC_CHANNEL_LAST] = {
+      OC::ADC::value<ADC_CHANNEL_1>(), OC::ADC::value<ADC_CHANNEL_2>(),
+      OC::ADC::value<ADC_CHANNEL_3>(), OC::ADC::value<ADC_CHANNEL_4>() };
+    for (size_t i = 0; i < OC::kAppBlockSize; ++i) {
+      cv1.push(cv[ADC_CHANNEL_1]);
+      cv2.push(cv[ADC_CHANNEL_2]);
+      cv3.push(cv[ADC_CHANNEL_3]);
+      cv4.push(cv[ADC_CHANNEL_4]);
+    }
 
     const int32_t cvs[ADC_CHANNEL_LAST] = { cv1.value(), cv2.value(), cv3.value(), cv4.value() };
+    balls_[0].Configure(cvs);
+    balls_[1].Configure(cvs);
+    balls_[2].Configure(cvs);
+    balls_[3].Configure(cvs);
+  }
+
+  void ISR() {
     uint32_t triggers = OC::DigitalInputs::clocked();
 
-    balls_[0].Update<DAC_CHANNEL_A>(triggers, cvs);
-    balls_[1].Update<DAC_CHANNEL_B>(triggers, cvs);
-    balls_[2].Update<DAC_CHANNEL_C>(triggers, cvs);
-    balls_[3].Update<DAC_CHANNEL_D>(triggers, cvs);
+    balls_[0].Update<DAC_CHANNEL_A>(triggers);
+    balls_[1].Update<DAC_CHANNEL_B>(triggers);
+    balls_[2].Update<DAC_CHANNEL_C>(triggers);
+    balls_[3].Update<DAC_CHANNEL_D>(triggers);
   }
 
   enum LeftEditMode {
@@ -319,6 +335,11 @@ void BBGEN_handleAppEvent(OC::AppEvent event) {
 void BBGEN_loop() {
 }
 
+// The menu only shows settings
+uint32_t BBGEN_displayState() {
+  return 0;
+}
+
 void BBGEN_menu() {
 
   menu::QuadTitleBar::Draw();
@@ -403,3 +424,7 @@ void BBGEN_screensaver() {
 void FASTRUN BBGEN_isr() {
   bbgen.ISR();
 }
+
+void FASTRUN BBGEN_beginBlock() {
+  bbgen.BeginBlock();
+}
@@ -269,8 +269,8 @@ public:
      segments[mapping - BYTEBEAT_CV_MAPPING_FIRST] += (cvs[cv_setting - BYTEBEAT_SETTING_CV1] * 65536) >> bytebeat_cv_rshift;
   }
 
-  template <DAC_CHANNEL dac_channel>
-  void Update(uint32_t triggers, const int32_t cvs[ADC_CHANNEL_LAST]) {
+  // Apply settings and CVs for the next block of ticks
+  void Configure(const int32_t cvs[ADC_CHANNEL_LAST]) {
 
     int32_t s[kMaxByteBeatParameters];
     s[0] = SCALE8_16(static_cast<int32_t>(get_equation() << 4));
@@ -297,6 +297,10 @@ public:
     }
        
     bytebeat_.Configure(s, get_step_mode(), get_loop_mode()) ; 
+  }
+
+  template <DAC_CHANNEL dac_channel>
+  void Update(uint32_t triggers) {
 
     OC::DigitalInput trigger_input = get_trigger_input();
     uint8_t gate_state = 0;
@@ -398,19 +402,31 @@ public:
     ui.cursor.AdjustEnd(bytebeats_[0].num_enabled_settings() - 1);
   }
 
-  void ISR() {
-    cv1.push(OC::ADC::value<ADC_CHANNEL_1>());
-    cv2.push(OC::ADC::value<ADC_CHANNEL_2>());
-    cv3.push(OC::ADC::value<ADC_CHANNEL_3>());
-    cv4.push(OC::ADC::value<ADC_CHANNEL_4>());
+  void BeginBlock() {
+    const int32_t cv[ADC_CHANNEL_LAST] = {
+      OC::ADC::value<ADC_CHANNEL_1>(), OC::ADC::value<ADC_CHANNEL_2>(),
+      OC::ADC::value<ADC_CHANNEL_3>(), OC::ADC::value<ADC_CHANNEL_4>() };
+    for (size_t i = 0; i < OC::kAppBlockSize; ++i) {
+      cv1.push(cv[ADC_CHANNEL_1]);
+      cv2.push(cv[ADC_CHANNEL_2]);
+      cv3.push(cv[ADC_CHANNEL_3]);
+      cv4.push(cv[ADC_CHANNEL_4]);
+    }
 
     const int32_t cvs[ADC_CHANNEL_LAST] = { cv1.value(), cv2.value(), cv3.value(), cv4.value() };
+    bytebeats_[0].Configure(cvs);
+    bytebeats_[1].Configure(cvs);
+    bytebeats_[2].Configure(cvs);
+    bytebeats_[3].Configure(cvs);
+  }
+
+  void ISR() {
     uint32_t triggers = OC::DigitalInputs::clocked();
 
-    bytebeats_[0].Update<DAC_CHANNEL_A>(triggers, cvs);
-    bytebeats_[1].Update<DAC_CHANNEL_B>(triggers, cvs);
-    bytebeats_[2].Update<DAC_CHANNEL_C>(triggers, cvs);
-    bytebeats_[3].Update<DAC_CHANNEL_D>(triggers, cvs);
+    bytebeats_[0].Update<DAC_CHANNEL_A>(triggers);
+    bytebeats_[1].Update<DAC_CHANNEL_B>(triggers);
+    bytebeats_[2].Update<DAC_CHANNEL_C>(triggers);
+    bytebeats_[3].Update<DAC_CHANNEL_D>(triggers);
   }
 
   enum LeftEditMode {
@@ -483,6 +499,11 @@ void BYTEBEATGEN_handleAppEvent(OC::AppEvent event) {
 void BYTEBEATGEN_loop() {
 }
 
+// The menu only shows settings
+uint32_t BYTEBEATGEN_displayState() {
+  return 0;
+}
+
 void BYTEBEATGEN_menu() {
   
   menu::QuadTitleBar::Draw();
@@ -599,3 +620,7 @@ void BYTEBEATGEN_screensaver() {
 void FASTRUN BYTEBEATGEN_isr() {
   bytebeatgen.ISR();
 }
+
+void FASTRUN BYTEBEATGEN_beginBlock() {
+  bytebeatgen.BeginBlock();
+}
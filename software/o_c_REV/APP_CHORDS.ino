@@ -798,17 +798,21 @@ public:
         CONSTRAIN(_voicing, 0,  OC::Chords::CHORDS_VOICING_LAST - 1);
       }
       
-      int32_t quantized = quantizer_.Process(pitch, root << 7, transpose);
-      // main sample, S/H:
-      sample_a = temp_sample = OC::DAC::pitch_to_scaled_voltage_dac(DAC_CHANNEL_A, quantized, octave + OC::inversion[_inversion][0], OC::DAC::get_voltage_scaling(DAC_CHANNEL_A));
- 
-      // now derive chords ...
-      transpose += OC::qualities[_quality][1];
-      int32_t sample_b  = quantizer_.Process(pitch, root << 7, transpose);
-      transpose += OC::qualities[_quality][2];
-      int32_t sample_c  = quantizer_.Process(pitch, root << 7, transpose);
-      transpose += OC::qualities[_quality][3];
-      int32_t sample_d  = quantizer_.Process(pitch, root << 7, transpose);
+      // main sample, S/H, and derived chord notes, all from the same pitch
+      const int32_t pitches[4] = { pitch, pitch, pitch, pitch };
+      int32_t transposes[4];
+      transposes[0] = transpose;
+      for (int i = 1; i < 4; ++i) {
+        transpose += OC::qualities[_quality][i];
+        transposes[i] = transpose;
+      }
+      int32_t quantized[4];
+      quantizer_.ProcessBatch(pitches, quantized, 4, root << 7, transposes);
+
+      sample_a = temp_sample = OC::DAC::pitch_to_scaled_voltage_dac(DAC_CHANNEL_A, quantized[0], octave + OC::inversion[_inversion][0], OC::DAC::get_voltage_scaling(DAC_CHANNEL_A));
+      int32_t sample_b = quantized[1];
+      int32_t sample_c = quantized[2];
+      int32_t sample_d = quantized[3];
 
       //todo voicing for root note
       sample_b = OC::DAC::pitch_to_scaled_voltage_dac(DAC_CHANNEL_B, sample_b, octave + OC::voicing[_voicing][1] + OC::inversion[_inversion][1], OC::DAC::get_voltage_scaling(DAC_CHANNEL_B));
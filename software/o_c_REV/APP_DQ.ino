@@ -396,6 +396,7 @@ public:
     
     trigger_delay_.Init();
     quantizer_.Init();
+    quantizer_.EnableDirectIndex(&quantizer_index_);
     update_scale(true, 0, false);
     trigger_display_.Init();
     update_enabled_settings();
@@ -1038,6 +1039,8 @@ private:
 
   util::TriggerDelay<OC::kMaxTriggerDelayTicks> trigger_delay_;
   braids::Quantizer quantizer_;
+  // Continuous trigger modes search the codebook a lot
+  braids::Quantizer::DirectIndex quantizer_index_;
   OC::DigitalInputDisplay trigger_display_;
 
   // internal CV sources;
@@ -126,9 +126,15 @@ public:
 
   streams::LorenzGenerator lorenz;
   bool frozen_;
+  // Frequencies for the current block
+  int32_t freq1, freq2;
 
   // ISR update is at 16.666kHz, we don't need it that fast so smooth the values to ~1Khz
   static constexpr int32_t kSmoothing = 16;
+  // Likewise the attractors are integrated at ~1kHz and interpolated; the
+  // integration is spread over the ticks, so the isr processes one tick even
+  // though the settings are only read once per block
+  static constexpr uint8_t kControlRate = 4;
 
   SmoothedValue<int32_t, kSmoothing> cv_freq1;
   SmoothedValue<int32_t, kSmoothing> cv_freq2;
@@ -140,7 +146,10 @@ void LorenzGenerator::Init() {
   InitDefaults();
   lorenz.Init(0);
   lorenz.Init(1);
+  lorenz.set_control_rate(kControlRate);
+  lorenz.set_integrator(streams::LORENZ_INTEGRATOR_HEUN);
   frozen_= false;
+  freq1 = freq2 = 0;
 }
 
 const char* const lorenz_freq_range_names[5] = {
@@ -172,26 +181,30 @@ struct {
   menu::ScreenCursor<menu::kScreenLines> cursor;
 } lorenz_generator_state;
 
-void FASTRUN LORENZ_isr() {
-
-  bool reset1_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_1>();
-  bool reset2_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_2>();
-  bool reset_both_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_3>();
-  bool freeze = OC::DigitalInputs::read_immediate<OC::DIGITAL_INPUT_4>();
-
-  lorenz_generator.cv_freq1.push(OC::ADC::value<ADC_CHANNEL_1>());
-  lorenz_generator.cv_rho1.push(OC::ADC::value<ADC_CHANNEL_2>());
-  lorenz_generator.cv_freq2.push(OC::ADC::value<ADC_CHANNEL_3>());
-  lorenz_generator.cv_rho2.push(OC::ADC::value<ADC_CHANNEL_4>());
+// Update CVs and configure the generator from settings for the next block of
+// ticks; CV smoothing is updated once per tick so the response is the same as
+// when configuring every tick.
+void FASTRUN LORENZ_beginBlock() {
+
+  const int32_t cv_freq1 = OC::ADC::value<ADC_CHANNEL_1>();
+  const int32_t cv_rho1 = OC::ADC::value<ADC_CHANNEL_2>();
+  const int32_t cv_freq2 = OC::ADC::value<ADC_CHANNEL_3>();
+  const int32_t cv_rho2 = OC::ADC::value<ADC_CHANNEL_4>();
+  for (size_t i = 0; i < OC::kAppBlockSize; ++i) {
+    lorenz_generator.cv_freq1.push(cv_freq1);
+    lorenz_generator.cv_rho1.push(cv_rho1);
+    lorenz_generator.cv_freq2.push(cv_freq2);
+    lorenz_generator.cv_rho2.push(cv_rho2);
+  }
 
   // Range in settings is (0-256] so this gets scaled to (0,65535]
   // CV value is 12 bit so also needs scaling
 
   int32_t freq1 = SCALE8_16(lorenz_generator.get_freq1()) + (lorenz_generator.cv_freq1.value() * 16);
-  freq1 = USAT16(freq1);
+  lorenz_generator.freq1 = USAT16(freq1);
 
   int32_t freq2 = SCALE8_16(lorenz_generator.get_freq2()) + (lorenz_generator.cv_freq2.value() * 16);
-  freq2 = USAT16(freq2);
+  lorenz_generator.freq2 = USAT16(freq2);
 
   const int32_t rho_lower_limit = 4 << 8 ;
   const int32_t rho_upper_limit = 127 << 8 ;
@@ -217,13 +230,21 @@ void FASTRUN LORENZ_isr() {
 
   uint8_t out_d = lorenz_generator.get_out_d() ;
   lorenz_generator.lorenz.set_out_d(out_d);
+}
+
+void FASTRUN LORENZ_isr() {
+
+  bool reset1_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_1>();
+  bool reset2_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_2>();
+  bool reset_both_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_3>();
+  bool freeze = OC::DigitalInputs::read_immediate<OC::DIGITAL_INPUT_4>();
 
   if (reset_both_phase) {
     reset1_phase = true ;
     reset2_phase = true ;
   }
   if (!freeze && !lorenz_generator.frozen())
-    lorenz_generator.lorenz.Process(freq1, freq2, reset1_phase, reset2_phase, lorenz_generator.get_freq_range1(), lorenz_generator.get_freq_range2());
+    lorenz_generator.lorenz.Process(lorenz_generator.freq1, lorenz_generator.freq2, reset1_phase, reset2_phase, lorenz_generator.get_freq_range1(), lorenz_generator.get_freq_range2());
 
   OC::DAC::set<DAC_CHANNEL_A>(lorenz_generator.lorenz.dac_code(0));
   OC::DAC::set<DAC_CHANNEL_B>(lorenz_generator.lorenz.dac_code(1));
@@ -252,19 +273,30 @@ size_t LORENZ_restore(const void *storage) {
 void LORENZ_loop() {
 }
 
+// Frequencies including CV, as displayed in the menu
+static inline int32_t LORENZ_menuFreq1() {
+  int32_t freq1 = SCALE8_16(lorenz_generator.get_freq1()) + (lorenz_generator.cv_freq1.value() * 16);
+  return USAT16(freq1) >> 8;
+}
+
+static inline int32_t LORENZ_menuFreq2() {
+  int32_t freq2 = SCALE8_16(lorenz_generator.get_freq2()) + (lorenz_generator.cv_freq2.value() * 16);
+  return USAT16(freq2) >> 8;
+}
+
+uint32_t LORENZ_displayState() {
+  return (LORENZ_menuFreq2() << 8) | LORENZ_menuFreq1();
+}
+
 void LORENZ_menu() {
 
   menu::DualTitleBar::Draw();
   graphics.print("Freq1 ");
-  int32_t freq1 = SCALE8_16(lorenz_generator.get_freq1()) + (lorenz_generator.cv_freq1.value() * 16);
-  freq1 = USAT16(freq1);
-  graphics.print(freq1 >> 8);
+  graphics.print(LORENZ_menuFreq1());
 
   menu::DualTitleBar::SetColumn(1);
   graphics.print("Freq2 ");
-  int32_t freq2 = SCALE8_16(lorenz_generator.get_freq2()) + (lorenz_generator.cv_freq2.value() * 16);
-  freq2 = USAT16(freq2);
-  graphics.print(freq2 >> 8);
+  graphics.print(LORENZ_menuFreq2());
 
   menu::DualTitleBar::Selected(lorenz_generator_state.selected_generator);
 
@@ -167,9 +167,18 @@ public:
     freq_mult_ = freq_mult;
   }
 
+  int32_t freq() const {
+    return freq_;
+  }
+
+  void set_freq(int32_t freq) {
+    freq_ = freq;
+  }
+
   frames::PolyLfo lfo;
   bool frozen_;
   uint8_t freq_mult_;
+  int32_t freq_;
 
   // ISR update is at 16.666kHz, we don't need it that fast so smooth the values to ~1Khz
   static constexpr int32_t kSmoothing = 16;
@@ -185,6 +194,7 @@ void PolyLfo::Init() {
   lfo.Init();
   frozen_= false;
   freq_mult_ = 0x3; // == x2 / default
+  freq_ = 0;
 }
 
 const char* const freq_range_names[12] = {
@@ -241,16 +251,21 @@ struct {
 
 } poly_lfo_state;
 
-void FASTRUN POLYLFO_isr() {
+// Update CVs and configure the LFO from settings for the next block of ticks;
+// CV smoothing is updated once per tick so the response is the same as when
+// configuring every tick.
+void FASTRUN POLYLFO_beginBlock() {
 
-  bool reset_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_1>();
-  bool freeze = OC::DigitalInputs::read_immediate<OC::DIGITAL_INPUT_2>();
-  bool tempo_sync = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_3>();
- 
-  poly_lfo.cv_freq.push(OC::ADC::value<ADC_CHANNEL_1>());
-  poly_lfo.cv_shape.push(OC::ADC::value<ADC_CHANNEL_2>());
-  poly_lfo.cv_spread.push(OC::ADC::value<ADC_CHANNEL_3>());
-  poly_lfo.cv_mappable.push(OC::ADC::value<ADC_CHANNEL_4>());
+  const int32_t cv_freq = OC::ADC::value<ADC_CHANNEL_1>();
+  const int32_t cv_shape = OC::ADC::value<ADC_CHANNEL_2>();
+  const int32_t cv_spread = OC::ADC::value<ADC_CHANNEL_3>();
+  const int32_t cv_mappable = OC::ADC::value<ADC_CHANNEL_4>();
+  for (size_t i = 0; i < OC::kAppBlockSize; ++i) {
+    poly_lfo.cv_freq.push(cv_freq);
+    poly_lfo.cv_shape.push(cv_shape);
+    poly_lfo.cv_spread.push(cv_spread);
+    poly_lfo.cv_mappable.push(cv_mappable);
+  }
 
   // Range in settings is (0-256] so this gets scaled to (0,65535]
   // CV value is 12 bit so also needs scaling
@@ -336,9 +351,17 @@ void FASTRUN POLYLFO_isr() {
   // div/multiply frequency if TR4 / gate high
   int8_t freq_mult = digitalReadFast(TR4) ? 0xFF : poly_lfo.tr4_multiplier();
   poly_lfo.set_freq_mult(freq_mult);
+  poly_lfo.set_freq(freq);
+}
+
+void FASTRUN POLYLFO_isr() {
+
+  bool reset_phase = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_1>();
+  bool freeze = OC::DigitalInputs::read_immediate<OC::DIGITAL_INPUT_2>();
+  bool tempo_sync = OC::DigitalInputs::clocked<OC::DIGITAL_INPUT_3>();
 
   if (!freeze && !poly_lfo.frozen())
-    poly_lfo.lfo.Render(freq, reset_phase, tempo_sync, freq_mult);
+    poly_lfo.lfo.Render(poly_lfo.freq(), reset_phase, tempo_sync, poly_lfo.freq_mult());
 
   OC::DAC::set<DAC_CHANNEL_A>(poly_lfo.lfo.dac_code(0));
   OC::DAC::set<DAC_CHANNEL_B>(poly_lfo.lfo.dac_code(1));
@@ -371,6 +394,16 @@ void POLYLFO_loop() {
 static const size_t kSmallPreviewBufferSize = 32;
 uint16_t preview_buffer[kSmallPreviewBufferSize];
 
+uint32_t POLYLFO_displayState() {
+  if (poly_lfo.get_tap_tempo())
+    return 0;
+  // Ch A frequency (incl. CV) and the TR4 multiplier indicator
+  uint32_t state = poly_lfo.lfo.get_phase_increment_ch1();
+  if (poly_lfo.freq_mult() < 0xFF)
+    state ^= 0x80000000;
+  return state;
+}
+
 void POLYLFO_menu() {
 
   menu::DefaultTitleBar::Draw();
@@ -396,6 +396,7 @@ public:
     bytebeat_.Init();
     int_seq_.Init(get_int_seq_start(), get_int_seq_length());
     quantizer_.Init();
+    quantizer_.EnableDirectIndex(&quantizer_index_);
     update_scale(true, false);
     trigger_display_.Init();
     update_enabled_settings();
@@ -1077,6 +1078,8 @@ private:
   peaks::ByteBeat bytebeat_ ;
   util::IntegerSequence int_seq_ ;
   braids::Quantizer quantizer_;
+  // Continuous trigger modes search the codebook a lot
+  braids::Quantizer::DirectIndex quantizer_index_;
   OC::DigitalInputDisplay trigger_display_;
 
   int num_enabled_settings_;
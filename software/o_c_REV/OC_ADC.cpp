@@ -9,7 +9,10 @@ namespace OC {
 /*static*/ ADC::CalibrationData *ADC::calibration_data_;
 /*static*/ uint32_t ADC::raw_[ADC_CHANNEL_LAST];
 /*static*/ uint32_t ADC::smoothed_[ADC_CHANNEL_LAST];
+/*static*/ ADCFilter ADC::filters_[ADC_CHANNEL_LAST];
 /*static*/ volatile bool ADC::ready_;
+/*static*/ ADC::Snapshot ADC::snapshots_[2];
+/*static*/ const ADC::Snapshot * volatile ADC::snapshot_ = &ADC::snapshots_[0];
 
 constexpr uint16_t ADC::SCA_CHANNEL_ID[DMA_NUM_CH]; // ADCx_SCA register channel numbers
 DMAChannel* dma0 = new DMAChannel(false); // dma0 channel, fills adcbuffer_0
@@ -27,7 +30,10 @@ DMAMEM static volatile uint16_t __attribute__((aligned(DMA_BUF_SIZE+0))) adcbuff
   calibration_data_ = calibration_data;
   std::fill(raw_, raw_ + ADC_CHANNEL_LAST, 0);
   std::fill(smoothed_, smoothed_ + ADC_CHANNEL_LAST, 0);
+  for (auto &filter : filters_)
+    filter.Init();
   std::fill(adcbuffer_0, adcbuffer_0 + DMA_BUF_SIZE, 0);
+  UpdateSnapshot();
   
   adc_.enableDMA();
 }
@@ -91,27 +97,39 @@ void ADC::Init_DMA() {
     ADC::ready_ = false;
     
     /* 
-     *  collect  results from adcbuffer_0; as things are, there's DMA_BUF_SIZE = 16 samples in the buffer. 
+     *  collect  results from adcbuffer_0; as things are, there's DMA_BUF_SIZE = 16 samples in the buffer,
+     *  i.e. ADCFilter::kSamplesPerScan = 4 interleaved samples per channel.
     */
-    uint32_t value;
-   
-    value = (adcbuffer_0[0] + adcbuffer_0[4] + adcbuffer_0[8] + adcbuffer_0[12]) >> 2; // / 4 = DMA_BUF_SIZE / DMA_NUM_CH
-    update<ADC_CHANNEL_1>(value); 
+    update<ADC_CHANNEL_1>(adcbuffer_0);
+    update<ADC_CHANNEL_2>(adcbuffer_0);
+    update<ADC_CHANNEL_3>(adcbuffer_0);
+    update<ADC_CHANNEL_4>(adcbuffer_0);
 
-    value = (adcbuffer_0[1] + adcbuffer_0[5] + adcbuffer_0[9] + adcbuffer_0[13]) >> 2;
-    update<ADC_CHANNEL_2>(value); 
-
-    value = (adcbuffer_0[2] + adcbuffer_0[6] + adcbuffer_0[10] + adcbuffer_0[14]) >> 2;
-    update<ADC_CHANNEL_3>(value); 
-
-    value = (adcbuffer_0[3] + adcbuffer_0[7] + adcbuffer_0[11] + adcbuffer_0[15]) >> 2;
-    update<ADC_CHANNEL_4>(value); 
+    UpdateSnapshot();
 
     /* restart */
     dma0->enable();
   }
 }
 
+/*static*/ void FASTRUN ADC::UpdateSnapshot() {
+  // Fill the snapshot that isn't current, then publish it
+  Snapshot &snapshot = snapshots_[snapshot_ == &snapshots_[0] ? 1 : 0];
+  const int32_t pitch_cv_scale = calibration_data_->pitch_cv_scale;
+  for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel) {
+    const int32_t offset = calibration_data_->offset[channel];
+    const uint32_t raw = raw_[channel] >> kAdcValueShift;
+    const uint32_t smoothed = smoothed_[channel] >> kAdcValueShift;
+    const int32_t value = offset - smoothed;
+    snapshot.raw[channel] = raw;
+    snapshot.smoothed[channel] = smoothed;
+    snapshot.value[channel] = value;
+    snapshot.pitch[channel] = (value * pitch_cv_scale) >> 12;
+    snapshot.raw_pitch[channel] = ((offset - static_cast<int32_t>(raw)) * pitch_cv_scale) >> 12;
+  }
+  snapshot_ = &snapshot;
+}
+
 /*static*/ void ADC::CalibratePitch(int32_t c2, int32_t c4) {
   // This is the method used by the Mutable Instruments calibration and
   // extrapolates from two octaves. I guess an alternative would be to get the
@@ -123,4 +141,22 @@ void ADC::Init_DMA() {
   }
 }
 
+/*static*/ void ADC::set_filter_preset(ADC_CHANNEL channel, FilterPreset preset) {
+  switch (preset) {
+    case FILTER_PRESET_SMOOTH:
+      set_filter(channel, ADC_FILTER_ONE_POLE, kSmoothShift);
+      break;
+    case FILTER_PRESET_FAST:
+      set_filter(channel, ADC_FILTER_BOX);
+      break;
+    case FILTER_PRESET_MEDIAN:
+      set_filter(channel, ADC_FILTER_MEDIAN);
+      break;
+    case FILTER_PRESET_DEFAULT:
+    default:
+      set_filter(channel, ADC_FILTER_ONE_POLE, ADCFilter::kDefaultShift);
+      break;
+  }
+}
+
 }; // namespace OC
@@ -2,6 +2,7 @@
 #define OC_ADC_H_
 
 #include "src/drivers/ADC/OC_util_ADC.h"
+#include "OC_ADC_filter.h"
 #include "OC_config.h"
 #include "OC_options.h"
 
@@ -27,8 +28,7 @@ class ADC {
 public:
 
   static constexpr uint8_t kAdcResolution = 12;
-  static constexpr uint32_t kAdcSmoothing = 4;
-  static constexpr uint32_t kAdcSmoothBits = 8; // fractional bits for smoothing
+  static constexpr uint32_t kAdcSmoothBits = ADCFilter::kFractionalBits; // fractional bits for smoothing
   static constexpr uint16_t kDefaultPitchCVScale = SEMITONES << 7;
 
   // These values should be tweaked so startSingleRead/readSingle run in main ISR update time
@@ -46,48 +46,97 @@ public:
     int16_t pitch_cv_offset;
   };
 
+  // All derived values for all channels are calculated once per completed
+  // scan and published together, so readers never see channels (or values)
+  // from different scans. Changes to the calibration data take effect with
+  // the next scan.
+  struct Snapshot {
+    uint32_t raw[ADC_CHANNEL_LAST]; // raw_value
+    uint32_t smoothed[ADC_CHANNEL_LAST]; // smoothed_raw_value
+    int32_t value[ADC_CHANNEL_LAST]; // value, i.e. calibrated & smoothed
+    int32_t pitch[ADC_CHANNEL_LAST]; // pitch_value
+    int32_t raw_pitch[ADC_CHANNEL_LAST]; // raw_pitch_value
+  };
+
   static void Init(CalibrationData *calibration_data);
   static void Init_DMA();
   static void DMA_ISR();
   static void Scan_DMA();
 
+  // @return latest snapshot; stays valid (and unchanged) until the next-but-one
+  // scan, so it's safe to use for the duration of an ISR
+  static const Snapshot &snapshot() {
+    return *snapshot_;
+  }
+
   template <ADC_CHANNEL channel>
   static int32_t value() {
-    return calibration_data_->offset[channel] - (smoothed_[channel] >> kAdcValueShift);
+    return snapshot_->value[channel];
   }
 
   static int32_t value(ADC_CHANNEL channel) {
-    return calibration_data_->offset[channel] - (smoothed_[channel] >> kAdcValueShift);
+    return snapshot_->value[channel];
   }
 
   static uint32_t raw_value(ADC_CHANNEL channel) {
-    return raw_[channel] >> kAdcValueShift;
+    return snapshot_->raw[channel];
   }
 
   static uint32_t smoothed_raw_value(ADC_CHANNEL channel) {
-    return smoothed_[channel] >> kAdcValueShift;
+    return snapshot_->smoothed[channel];
   }
 
   static int32_t pitch_value(ADC_CHANNEL channel) {
-    return (value(channel) * calibration_data_->pitch_cv_scale) >> 12;
+    return snapshot_->pitch[channel];
   }
 
   static int32_t raw_pitch_value(ADC_CHANNEL channel) {
-    int32_t value = calibration_data_->offset[channel] - raw_value(channel);
-    return (value * calibration_data_->pitch_cv_scale) >> 12;
+    return snapshot_->raw_pitch[channel];
   }
 
   static void CalibratePitch(int32_t c2, int32_t c4);
 
+  // Select the filter that produces the smoothed values for a channel; the
+  // default is ADC_FILTER_ONE_POLE with ADCFilter::kDefaultShift. Takes effect
+  // with the next scan.
+  static void set_filter(ADC_CHANNEL channel, ADCFilterType type, uint8_t shift = ADCFilter::kDefaultShift) {
+    filters_[channel].Configure(type, shift);
+  }
+
+  static ADCFilterType filter_type(ADC_CHANNEL channel) {
+    return filters_[channel].type();
+  }
+
+  static uint8_t filter_shift(ADC_CHANNEL channel) {
+    return filters_[channel].shift();
+  }
+
+  // Filter configurations selectable in the calibration menu
+  enum FilterPreset : uint8_t {
+    FILTER_PRESET_DEFAULT, // one-pole with kDefaultShift
+    FILTER_PRESET_SMOOTH,  // one-pole with kSmoothShift; less noise, e.g. for pitch
+    FILTER_PRESET_FAST,    // box; least latency, e.g. for modulation
+    FILTER_PRESET_MEDIAN,  // median; rejects spikes
+    FILTER_PRESET_LAST
+  };
+
+  static constexpr uint8_t kSmoothShift = 4;
+
+  static void set_filter_preset(ADC_CHANNEL channel, FilterPreset preset);
+
 private:
 
+  static_assert(DMA_BUF_SIZE == ADCFilter::kSamplesPerScan * DMA_NUM_CH, "ADC buffer size mismatch");
+  static_assert(kAdcScanResolution == ADCFilter::kSampleBits, "ADC scan resolution mismatch");
+  static_assert(kAdcResolution == ADCFilter::kResolution, "ADC resolution mismatch");
+
   template <ADC_CHANNEL channel>
-  static void update(uint32_t value) {
-    value = (value  >> (kAdcScanResolution - kAdcResolution)) << kAdcSmoothBits;
-    raw_[channel] = value;
-    // division should be shift if kAdcSmoothing is power-of-two
-    value = (smoothed_[channel] * (kAdcSmoothing - 1) + value) / kAdcSmoothing;
-    smoothed_[channel] = value;
+  static void update(const volatile uint16_t *buffer) {
+    uint16_t samples[ADCFilter::kSamplesPerScan];
+    for (size_t i = 0; i < ADCFilter::kSamplesPerScan; ++i)
+      samples[i] = buffer[channel + i * DMA_NUM_CH];
+    raw_[channel] = ADCFilter::Mean(samples);
+    smoothed_[channel] = filters_[channel].Process(samples);
   }
 
   static ::ADC adc_;
@@ -97,6 +146,12 @@ private:
 
   static uint32_t raw_[ADC_CHANNEL_LAST];
   static uint32_t smoothed_[ADC_CHANNEL_LAST];
+  static ADCFilter filters_[ADC_CHANNEL_LAST];
+
+  static Snapshot snapshots_[2];
+  static const Snapshot * volatile snapshot_;
+
+  static void UpdateSnapshot();
 
   /*  
    *   below: channel ids for the ADCx_SCA register: we have 4 inputs
@@ -0,0 +1,128 @@
+#ifndef OC_ADC_FILTER_H_
+#define OC_ADC_FILTER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace OC {
+
+enum ADCFilterType : uint8_t {
+  ADC_FILTER_BYPASS,   // most recent sample of the scan
+  ADC_FILTER_BOX,      // mean of the samples of the scan
+  ADC_FILTER_ONE_POLE, // mean of the samples, then one-pole lowpass
+  ADC_FILTER_MEDIAN,   // median of the means of the last three scans
+  ADC_FILTER_TYPE_LAST
+};
+
+// Filter for one ADC channel. Each scan yields kSamplesPerScan samples per
+// channel (with kSampleBits resolution), which are decimated to one value per
+// scan with kResolution bits and kFractionalBits fractional bits.
+//
+// The filters trade latency for noise: bypass has the least latency (but the
+// full noise of a single conversion), the box filter averages over one scan,
+// the one-pole smoothes over ~2^shift scans, and the median rejects spikes
+// that only last one scan at the cost of one scan of latency.
+//
+// Configure can be called while the ISR is using the filter; worst case is one
+// scan with a mixed configuration.
+class ADCFilter {
+public:
+  static constexpr size_t kSamplesPerScan = 4;
+  static constexpr uint32_t kSampleBits = 16;
+  static constexpr uint32_t kResolution = 12;
+  static constexpr uint32_t kFractionalBits = 8;
+  static constexpr uint8_t kMaxShift = 8;
+  static constexpr uint8_t kDefaultShift = 2;
+
+  void Init() {
+    type_ = ADC_FILTER_ONE_POLE;
+    shift_ = kDefaultShift;
+    Reset(0);
+  }
+
+  // Switching filters doesn't reset the state, so the output continues from
+  // the last value.
+  void Configure(ADCFilterType type, uint8_t shift) {
+    if (shift > kMaxShift)
+      shift = kMaxShift;
+    if (type != type_)
+      history_[0] = history_[1] = value_;
+    shift_ = shift;
+    type_ = type;
+  }
+
+  void Reset(uint32_t value) {
+    value_ = history_[0] = history_[1] = value;
+  }
+
+  ADCFilterType type() const {
+    return type_;
+  }
+
+  uint8_t shift() const {
+    return shift_;
+  }
+
+  // @return last output
+  uint32_t value() const {
+    return value_;
+  }
+
+  // Samples are in order of conversion, i.e. the last one is the most recent.
+  static inline uint32_t Mean(const uint16_t *samples) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < kSamplesPerScan; ++i)
+      sum += samples[i];
+    return Scale(sum / kSamplesPerScan);
+  }
+
+  uint32_t Process(const uint16_t *samples) {
+    uint32_t value;
+    switch (type_) {
+      case ADC_FILTER_BYPASS:
+        value = Scale(samples[kSamplesPerScan - 1]);
+        break;
+      case ADC_FILTER_BOX:
+        value = Mean(samples);
+        break;
+      case ADC_FILTER_MEDIAN: {
+        uint32_t mean = Mean(samples);
+        value = Median(history_[0], history_[1], mean);
+        history_[0] = history_[1];
+        history_[1] = mean;
+      }
+      break;
+      case ADC_FILTER_ONE_POLE:
+      default:
+        // y = ((n - 1) * y + x) / n, n = 2^shift
+        value = (value_ * ((1U << shift_) - 1) + Mean(samples)) >> shift_;
+        break;
+    }
+    value_ = value;
+    return value;
+  }
+
+private:
+  ADCFilterType type_;
+  uint8_t shift_;
+  uint32_t value_;
+  uint32_t history_[2];
+
+  static inline uint32_t Scale(uint32_t sample) {
+    return (sample >> (kSampleBits - kResolution)) << kFractionalBits;
+  }
+
+  static inline uint32_t Median(uint32_t a, uint32_t b, uint32_t c) {
+    if (a > b) {
+      uint32_t t = a; a = b; b = t;
+    }
+    // a <= b
+    if (c <= a) return a;
+    if (c >= b) return b;
+    return c;
+  }
+};
+
+}; // namespace OC
+
+#endif // OC_ADC_FILTER_H_
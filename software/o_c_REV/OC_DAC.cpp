@@ -41,6 +41,10 @@
 #include "OC_autotune_presets.h"
 #include "OC_autotune.h"
 
+#ifdef OC_DAC_DMA
+#include <DMAChannel.h>
+#endif
+
 #define SPICLOCK_30MHz   (SPI_CTAR_PBR(0) | SPI_CTAR_BR(0) | SPI_CTAR_DBR) //(60 / 2) * ((1+1)/2) = 30 MHz (= 24MHz, when F_BUS == 48000000)
 
 namespace OC {
@@ -77,8 +81,64 @@ void DAC::Init(CalibrationData *calibration_data) {
     SPIFIFO.begin(DAC_CS, SPICLOCK_30MHz, SPI_MODE0);  
 
   set_all(0xffff);
+#ifdef OC_DAC_DMA
+  // DMA isn't set up until Init_DMA
+  WriteChannels();
+#else
   Update();
+#endif
+}
+
+#ifdef OC_DAC_DMA
+// DAC_CS (pin 10) is PCS0, so the SPI hardware handles chip select for the
+// DMA transfer.
+static_assert(DAC_CS == 10, "DAC_CS must be PCS0 for DMA transfer");
+static constexpr uint32_t kDacPCS = 0x01;
+
+static DMAChannel *dac_dma = nullptr;
+static uint32_t dac_frames[DAC::kFrameWords];
+
+/*static*/
+void DAC::Init_DMA(DMAChannel &spi_tx_dma) {
+  dac_dma = &spi_tx_dma;
+  dac_dma->triggerAtHardwareEvent(DMAMUX_SOURCE_SPI0_TX);
+  dac_dma->disableOnCompletion();
+}
+
+/*static*/
+void DAC::StartTransfer() {
+  BuildFrames<kFlip180, kInvertOutput>(values_, kDacPCS, dac_frames);
+
+  // The display's page transfer uses the same channel, so the whole TCD is
+  // set up for each transfer
+  dac_dma->TCD->SADDR = dac_frames;
+  dac_dma->TCD->SOFF = 4;
+  dac_dma->TCD->ATTR = 0x202; // 32-bit source and destination
+  dac_dma->TCD->NBYTES = 4;
+  dac_dma->TCD->SLAST = -static_cast<int32_t>(sizeof(dac_frames));
+  dac_dma->TCD->DADDR = &SPI0_PUSHR;
+  dac_dma->TCD->DOFF = 0;
+  dac_dma->TCD->DLASTSGA = 0;
+  dac_dma->TCD->BITER = kFrameWords;
+  dac_dma->TCD->CITER = kFrameWords;
+
+  SPI0_SR = 0xFF0F0000;
+  SPI0_RSER = SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
+  dac_dma->enable();
+}
+
+/*static*/
+void DAC::EndTransfer() {
+  // The DMA is complete once the last entry is in the TX FIFO; the SPI is
+  // only free after the end of queue has been sent. The transfer takes a few
+  // us, and is started well before this is called.
+  while (!(SPI0_SR & SPI_SR_EOQF)) { }
+  dac_dma->clearComplete();
+  dac_dma->disable();
+  SPI0_RSER = 0;
+  SPI0_SR = 0xFF0F0000;
 }
+#endif
 
 /*static*/
 uint8_t DAC::calibration_data_used(uint8_t channel_id) {
@@ -223,68 +283,45 @@ uint16_t DAC::history_[DAC_CHANNEL_LAST][DAC::kHistoryDepth];
 volatile size_t DAC::history_tail_;
 /*static*/ 
 uint8_t DAC::DAC_scaling[DAC_CHANNEL_LAST];
+/*static*/
+const DAC::VoltageScalingFactor DAC::voltage_scaling_factors_[VOLTAGE_SCALING_LAST] = {
+  { 1, 0 },      // 1V/oct
+  { 25548, 15 }, // Wendy Carlos alpha scale - scale by 0.77995; 2^15 * 0.77995 = 25547.571
+  { 20917, 15 }, // Wendy Carlos beta scale - scale by 0.63833; 2^15 * 0.63833 = 20916.776
+  { 11501, 15 }, // Wendy Carlos gamma scale - scale by 0.35099; 2^15 * 0.35099 = 11501.2403
+  { 25969, 14 }, // Bohlen-Pierce macrotonal scale - scale by 1.585; 2^14 * 1.585 = 25968.64
+  { 1, 1 },      // Quartertone scaling (just down-scales to 0.5V/oct)
+  #ifdef BUCHLA_SUPPORT
+  { 19661, 14 }, // 1.2V/oct
+  { 2, 0 },      // 2V/oct
+  #endif
+};
 }; // namespace OC
 
 void set8565_CHA(uint32_t data) {
-  #ifdef BUCHLA_cOC
-  uint32_t _data = data;
-  #else
-  uint32_t _data = OC::DAC::MAX_VALUE - data;
-  #endif
-  #ifdef FLIP_180
-  SPIFIFO.write(0b00010110, SPI_CONTINUE);
-  #else
-  SPIFIFO.write(0b00010000, SPI_CONTINUE);
-  #endif
-  SPIFIFO.write16(_data);
+  SPIFIFO.write(OC::DAC::frame_command<OC::DAC::kFlip180>(DAC_CHANNEL_A), SPI_CONTINUE);
+  SPIFIFO.write16(OC::DAC::frame_data<OC::DAC::kInvertOutput>(data));
   SPIFIFO.read();
   SPIFIFO.read();
 }
 
 void set8565_CHB(uint32_t data) {
-  #ifdef BUCHLA_cOC
-  uint32_t _data = data;
-  #else
-  uint32_t _data = OC::DAC::MAX_VALUE - data;
-  #endif
-  #ifdef FLIP_180
-  SPIFIFO.write(0b00010100, SPI_CONTINUE);
-  #else
-  SPIFIFO.write(0b00010010, SPI_CONTINUE);
-  #endif
-  SPIFIFO.write16(_data);
+  SPIFIFO.write(OC::DAC::frame_command<OC::DAC::kFlip180>(DAC_CHANNEL_B), SPI_CONTINUE);
+  SPIFIFO.write16(OC::DAC::frame_data<OC::DAC::kInvertOutput>(data));
   SPIFIFO.read();
   SPIFIFO.read();
 }
 
 void set8565_CHC(uint32_t data) {
-  #ifdef BUCHLA_cOC
-  uint32_t _data = data;
-  #else
-  uint32_t _data = OC::DAC::MAX_VALUE - data;
-  #endif
-  #ifdef FLIP_180
-  SPIFIFO.write(0b00010010, SPI_CONTINUE);
-  #else
-  SPIFIFO.write(0b00010100, SPI_CONTINUE);
-  #endif
-  SPIFIFO.write16(_data);
+  SPIFIFO.write(OC::DAC::frame_command<OC::DAC::kFlip180>(DAC_CHANNEL_C), SPI_CONTINUE);
+  SPIFIFO.write16(OC::DAC::frame_data<OC::DAC::kInvertOutput>(data));
+  SPIFIFO.read();
   SPIFIFO.read();
-  SPIFIFO.read(); 
 }
 
 void set8565_CHD(uint32_t data) {
-  #ifdef BUCHLA_cOC
-  uint32_t _data = data;
-  #else
-  uint32_t _data = OC::DAC::MAX_VALUE - data;
-  #endif
-  #ifdef FLIP_180
-  SPIFIFO.write(0b00010000, SPI_CONTINUE);
-  #else
-  SPIFIFO.write(0b00010110, SPI_CONTINUE);
-  #endif
-  SPIFIFO.write16(_data);
+  SPIFIFO.write(OC::DAC::frame_command<OC::DAC::kFlip180>(DAC_CHANNEL_D), SPI_CONTINUE);
+  SPIFIFO.write16(OC::DAC::frame_data<OC::DAC::kInvertOutput>(data));
   SPIFIFO.read();
   SPIFIFO.read();
 }
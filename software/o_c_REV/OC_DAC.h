@@ -1,6 +1,7 @@
 #ifndef OC_DAC_H_
 #define OC_DAC_H_
 
+#include <Arduino.h>
 #include <stdint.h>
 #include <string.h>
 #include "OC_config.h"
@@ -32,6 +33,10 @@ enum OutputVoltageScaling {
   VOLTAGE_SCALING_LAST  
 } ;
 
+#ifdef OC_DAC_DMA
+class DMAChannel;
+#endif
+
 namespace OC {
 
 class DAC {
@@ -55,6 +60,12 @@ public:
   };
 
   static void Init(CalibrationData *calibration_data);
+#ifdef OC_DAC_DMA
+  // The DAC transfer shares the SPI0 TX DMA channel with the display
+  static void Init_DMA(DMAChannel &spi_tx_dma);
+  // Wait until the transfer started by Update is done, and release the SPI
+  static void EndTransfer();
+#endif
 
   static uint8_t calibration_data_used(uint8_t channel_id);
   static void set_auto_channel_calibration_data(uint8_t channel_id);
@@ -103,19 +114,7 @@ public:
   // @return DAC output value
   static int32_t pitch_to_dac(DAC_CHANNEL channel, int32_t pitch, int32_t octave_offset) {
     pitch += (kOctaveZero + octave_offset) * 12 << 7;
-    
-    CONSTRAIN(pitch, 0, (120 << 7));
-
-    const int32_t octave = pitch / (12 << 7);
-    const int32_t fractional = pitch - octave * (12 << 7);
-
-    int32_t sample = calibration_data_->calibrated_octaves[channel][octave];
-    if (fractional) {
-      int32_t span = calibration_data_->calibrated_octaves[channel][octave + 1] - sample;
-      sample += (fractional * span) / (12 << 7);
-    }
-
-    return sample;
+    return interpolate_octaves(channel, pitch);
   }
 
   // Specialised versions with voltage scaling
@@ -128,51 +127,13 @@ public:
     pitch += (octave_offset * 12) << 7;
 
  
-    switch (voltage_scaling) {
-      case VOLTAGE_SCALING_1V_PER_OCT:    // 1V/oct
-          // do nothing
-          break;
-      case VOLTAGE_SCALING_CARLOS_ALPHA:  // Wendy Carlos alpha scale - scale by 0.77995
-          pitch = (pitch * 25548) >> 15;  // 2^15 * 0.77995 = 25547.571
-          break;
-      case VOLTAGE_SCALING_CARLOS_BETA:   // Wendy Carlos beta scale - scale by 0.63833 
-          pitch = (pitch * 20917) >> 15;  // 2^15 * 0.63833 = 20916.776
-          break;
-      case VOLTAGE_SCALING_CARLOS_GAMMA:  // Wendy Carlos gamma scale - scale by 0.35099
-          pitch = (pitch * 11501) >> 15;  // 2^15 * 0.35099 = 11501.2403
-          break;
-      case VOLTAGE_SCALING_BOHLEN_PIERCE: // Bohlen-Pierce macrotonal scale - scale by 1.585
-          pitch = (pitch * 25969) >> 14;  // 2^14 * 1.585 = 25968.64
-          break;
-      case VOLTAGE_SCALING_QUARTERTONE:   // Quartertone scaling (just down-scales to 0.5V/oct)
-          pitch = pitch >> 1;
-          break;
-      #ifdef BUCHLA_SUPPORT
-      case VOLTAGE_SCALING_1_2V_PER_OCT:  // 1.2V/oct
-          pitch = (pitch * 19661) >> 14;
-          break;
-      case VOLTAGE_SCALING_2V_PER_OCT:    // 2V/oct
-          pitch = pitch << 1;
-          break;
-      #endif    
-      default: 
-          break;
+    if (voltage_scaling < VOLTAGE_SCALING_LAST) {
+      const VoltageScalingFactor &factor = voltage_scaling_factors_[voltage_scaling];
+      pitch = (pitch * factor.multiplier) >> factor.shift;
     }
 
     pitch += (kOctaveZero * 12) << 7;
-   
-    CONSTRAIN(pitch, 0, (120 << 7));
-
-    const int32_t octave = pitch / (12 << 7);
-    const int32_t fractional = pitch - octave * (12 << 7);
-
-    int32_t sample = calibration_data_->calibrated_octaves[channel][octave];
-    if (fractional) {
-      int32_t span = calibration_data_->calibrated_octaves[channel][octave + 1] - sample;
-      sample += (fractional * span) / (12 << 7);
-    }
-
-    return sample;
+    return interpolate_octaves(channel, pitch);
   }
     
   // Set channel to semitone value
@@ -215,10 +176,11 @@ public:
 
   static void Update() {
 
-    set8565_CHA(values_[DAC_CHANNEL_A]);
-    set8565_CHB(values_[DAC_CHANNEL_B]);
-    set8565_CHC(values_[DAC_CHANNEL_C]);
-    set8565_CHD(values_[DAC_CHANNEL_D]);
+#ifdef OC_DAC_DMA
+    StartTransfer();
+#else
+    WriteChannels();
+#endif
 
     size_t tail = history_tail_;
     history_[DAC_CHANNEL_A][tail] = values_[DAC_CHANNEL_A];
@@ -243,7 +205,92 @@ public:
       *dst++ = *src++;
   }
 
+  // DAC8565 frames are a command byte (single-channel update, DB21-20 = 01,
+  // channel address in DB18-17) followed by the 16-bit data word. The jacks
+  // map to the channels in reverse order when FLIP_180 is set, and the output
+  // stage is inverting unless BUCHLA_cOC.
+#ifdef FLIP_180
+  static constexpr bool kFlip180 = true;
+#else
+  static constexpr bool kFlip180 = false;
+#endif
+#ifdef BUCHLA_cOC
+  static constexpr bool kInvertOutput = false;
+#else
+  static constexpr bool kInvertOutput = true;
+#endif
+
+  template <bool flip_180>
+  static constexpr uint8_t frame_command(DAC_CHANNEL channel) {
+    return 0x10 | ((flip_180 ? DAC_CHANNEL_D - channel : channel) << 1);
+  }
+
+  template <bool invert>
+  static constexpr uint16_t frame_data(uint32_t value) {
+    return invert ? MAX_VALUE - value : value;
+  }
+
+  // Number of SPI0_PUSHR entries for one update of all channels
+  static constexpr size_t kFrameWords = 2 * DAC_CHANNEL_LAST;
+
+  // Build the SPI0_PUSHR entries for all channels, using chip select pcs.
+  // The command is sent with 8-bit frames (CTAR0), the data with 16-bit
+  // frames (CTAR1), and the last entry ends the queue.
+  template <bool flip_180, bool invert>
+  static void BuildFrames(const uint32_t *values, uint32_t pcs, uint32_t *frames) {
+    for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel) {
+      *frames++ = frame_command<flip_180>(static_cast<DAC_CHANNEL>(channel)) | SPI_PUSHR_PCS(pcs) | SPI_PUSHR_CONT;
+      *frames++ = frame_data<invert>(values[channel]) | SPI_PUSHR_PCS(pcs) | SPI_PUSHR_CTAS(1);
+    }
+    frames[-1] |= SPI_PUSHR_EOQ;
+  }
+
 private:
+#ifdef OC_DAC_DMA
+  static void StartTransfer();
+#endif
+
+  static void WriteChannels() {
+    set8565_CHA(values_[DAC_CHANNEL_A]);
+    set8565_CHB(values_[DAC_CHANNEL_B]);
+    set8565_CHC(values_[DAC_CHANNEL_C]);
+    set8565_CHD(values_[DAC_CHANNEL_D]);
+  }
+
+  // Scaling is pitch * multiplier >> shift
+  struct VoltageScalingFactor {
+    int32_t multiplier;
+    int32_t shift;
+  };
+  static const VoltageScalingFactor voltage_scaling_factors_[VOLTAGE_SCALING_LAST];
+
+  // x / 3 for any 32-bit x, using the reciprocal instead of a division
+  static inline uint32_t div3(uint32_t x) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(x) * 0xaaaaaaabULL) >> 33);
+  }
+
+  // Interpolate the calibrated octave values for pitch with 12 * 128 bit per
+  // octave. Same result as dividing by (12 << 7), rounding towards zero.
+  static int32_t interpolate_octaves(DAC_CHANNEL channel, int32_t pitch) {
+    CONSTRAIN(pitch, 0, (120 << 7));
+
+    // (12 << 7) = 3 << 9
+    const int32_t octave = div3(pitch >> 9);
+    const int32_t fractional = pitch - octave * (12 << 7);
+
+    const uint16_t *octaves = calibration_data_->calibrated_octaves[channel] + octave;
+    int32_t sample = octaves[0];
+    if (fractional) {
+      int32_t delta = fractional * (octaves[1] - sample);
+      if (delta < 0)
+        sample -= div3(-delta >> 9);
+      else
+        sample += div3(delta >> 9);
+    }
+
+    return sample;
+  }
+
   static CalibrationData *calibration_data_;
   static uint32_t values_[DAC_CHANNEL_LAST];
   static uint16_t history_[DAC_CHANNEL_LAST][kHistoryDepth];
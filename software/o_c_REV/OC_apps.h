@@ -25,9 +25,19 @@
 
 #include "UI/ui_events.h"
 #include "util/util_misc.h"
+#include "OC_DAC.h"
 
 namespace OC {
 
+// Apps can optionally split their per-tick work: BeginBlock reads settings
+// and CVs and configures the app once every kAppBlockSize ticks, and isr then
+// renders a single tick with that configuration. This amortizes the setup
+// over the block while the rendering stays spread over the ticks, so no tick
+// costs more than running the setup every tick. CV and settings changes have
+// up to a block of extra latency; triggers are still handled on the tick they
+// arrive.
+static constexpr size_t kAppBlockSize = 4;
+
 enum AppEvent {
   APP_EVENT_SUSPEND,
   APP_EVENT_RESUME,
@@ -64,6 +74,12 @@ struct App {
   void (*HandleEncoderEvent)(const UI::Event &);
 
   void (*isr)();
+  void (*BeginBlock)(); // optional, called before isr every kAppBlockSize ticks
+
+  // Optional: version of everything the menu displays that can change without
+  // a UI event (e.g. values that include CV). If set, the menu is only
+  // redrawn if this, or the UI state, changes.
+  uint32_t (*DisplayState)();
 };
 
 namespace apps {
@@ -72,12 +88,22 @@ namespace apps {
 
   void Init(bool reset_settings);
 
+  void BlockISR();
+
   inline void ISR() __attribute__((always_inline));
   inline void ISR() {
-    if (current_app && current_app->isr)
-      current_app->isr();
+    if (current_app) {
+      if (current_app->BeginBlock)
+        BlockISR();
+      else if (current_app->isr)
+        current_app->isr();
+    }
   }
 
+  // Continue saving settings, if a save is in progress; called from the main loop
+  // @return true if nothing left to save
+  bool SaveStep();
+
   App *find(uint16_t id);
   int index_of(uint16_t id);
 
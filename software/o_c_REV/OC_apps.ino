@@ -21,17 +21,22 @@
 // SOFTWARE.
 
 #include "OC_apps.h"
+#include "OC_apps_storage.h"
 #include "OC_digital_inputs.h"
 #include "OC_autotune.h"
 
 #define DECLARE_APP(a, b, name, prefix, isr) \
+  DECLARE_APP_EX(a, b, name, prefix, isr, nullptr, nullptr)
+
+// App with optional block setup (\sa OC::kAppBlockSize) and display state
+#define DECLARE_APP_EX(a, b, name, prefix, isr, begin_block, display_state) \
 { TWOCC<a,b>::value, name, \
   prefix ## _init, prefix ## _storageSize, prefix ## _save, prefix ## _restore, \
   prefix ## _handleAppEvent, \
   prefix ## _loop, prefix ## _menu, prefix ## _screensaver, \
   prefix ## _handleButtonEvent, \
   prefix ## _handleEncoderEvent, \
-  isr \
+  isr, begin_block, display_state \
 }
 
 #ifdef BORING_APP_NAMES
@@ -41,12 +46,12 @@ OC::App available_apps[] = {
   DECLARE_APP('A','T', "Vectors", Automatonnetz, Automatonnetz_isr),
   DECLARE_APP('Q','Q', "4x Quantizer", QQ, QQ_isr),
   DECLARE_APP('D','Q', "2x Quantizer", DQ, DQ_isr),
-  DECLARE_APP('P','L', "Quadrature LFO", POLYLFO, POLYLFO_isr),
-  DECLARE_APP('L','R', "Lorenz", LORENZ, LORENZ_isr),
+  DECLARE_APP_EX('P','L', "Quadrature LFO", POLYLFO, POLYLFO_isr, POLYLFO_beginBlock, POLYLFO_displayState),
+  DECLARE_APP_EX('L','R', "Lorenz", LORENZ, LORENZ_isr, LORENZ_beginBlock, LORENZ_displayState),
   DECLARE_APP('E','G', "4x EG", ENVGEN, ENVGEN_isr),
   DECLARE_APP('S','Q', "2x Sequencer", SEQ, SEQ_isr),
-  DECLARE_APP('B','B', "Balls", BBGEN, BBGEN_isr),
-  DECLARE_APP('B','Y', "Bytebeats", BYTEBEATGEN, BYTEBEATGEN_isr),
+  DECLARE_APP_EX('B','B', "Balls", BBGEN, BBGEN_isr, BBGEN_beginBlock, BBGEN_displayState),
+  DECLARE_APP_EX('B','Y', "Bytebeats", BYTEBEATGEN, BYTEBEATGEN_isr, BYTEBEATGEN_beginBlock, BYTEBEATGEN_displayState),
   DECLARE_APP('C','Q', "Chords", CHORDS, CHORDS_isr),
   DECLARE_APP('R','F', "Voltages", REFS, REFS_isr)
 };
@@ -57,12 +62,12 @@ OC::App available_apps[] = {
   DECLARE_APP('A','T', "Automatonnetz", Automatonnetz, Automatonnetz_isr),
   DECLARE_APP('Q','Q', "Quantermain", QQ, QQ_isr),
   DECLARE_APP('D','Q', "Meta-Q", DQ, DQ_isr),
-  DECLARE_APP('P','L', "Quadraturia", POLYLFO, POLYLFO_isr),
-  DECLARE_APP('L','R', "Low-rents", LORENZ, LORENZ_isr),
+  DECLARE_APP_EX('P','L', "Quadraturia", POLYLFO, POLYLFO_isr, POLYLFO_beginBlock, POLYLFO_displayState),
+  DECLARE_APP_EX('L','R', "Low-rents", LORENZ, LORENZ_isr, LORENZ_beginBlock, LORENZ_displayState),
   DECLARE_APP('E','G', "Piqued", ENVGEN, ENVGEN_isr),
   DECLARE_APP('S','Q', "Sequins", SEQ, SEQ_isr),
-  DECLARE_APP('B','B', "Dialectic Ping Pong", BBGEN, BBGEN_isr),
-  DECLARE_APP('B','Y', "Viznutcracker sweet", BYTEBEATGEN, BYTEBEATGEN_isr),
+  DECLARE_APP_EX('B','B', "Dialectic Ping Pong", BBGEN, BBGEN_isr, BBGEN_beginBlock, BBGEN_displayState),
+  DECLARE_APP_EX('B','Y', "Viznutcracker sweet", BYTEBEATGEN, BYTEBEATGEN_isr, BYTEBEATGEN_beginBlock, BYTEBEATGEN_displayState),
   DECLARE_APP('C','Q', "Acid Curds", CHORDS, CHORDS_isr),
   DECLARE_APP('R','F', "References", REFS, REFS_isr)
 };
@@ -72,50 +77,17 @@ static constexpr int NUM_AVAILABLE_APPS = ARRAY_SIZE(available_apps);
 
 namespace OC {
 
-// Global settings are stored separately to actual app setings.
-// The theory is that they might not change as often.
-struct GlobalSettings {
-  static constexpr uint32_t FOURCC = FOURCC<'O','C','S',2>::value;
-
-  bool encoders_enable_acceleration;
-  bool reserved0;
-  bool reserved1;
-  uint32_t DAC_scaling;
-  uint16_t current_app_id;
-  
-  OC::Scale user_scales[OC::Scales::SCALE_USER_LAST];
-  OC::Pattern user_patterns[OC::Patterns::PATTERN_USER_ALL];
-  OC::Chord user_chords[OC::Chords::CHORDS_USER_LAST];
-  OC::Autotune_data auto_calibration_data[DAC_CHANNEL_LAST];
-};
-
-// App settings are packed into a single blob of binary data; each app's chunk
-// gets its own header with id and the length of the entire chunk. This makes
-// this a bit more flexible during development.
-// Chunks are aligned on 2-byte boundaries for arbitrary reasons (thankfully M4
-// allows unaligned access...)
-struct AppChunkHeader {
-  uint16_t id;
-  uint16_t length;
-} __attribute__((packed));
-
-struct AppData {
-  static constexpr uint32_t FOURCC = FOURCC<'O','C','A',4>::value;
-
-  static constexpr size_t kAppDataSize = EEPROM_APPDATA_BINARY_SIZE;
-  char data[kAppDataSize];
-  size_t used;
-};
-
-typedef PageStorage<EEPROMStorage, EEPROM_GLOBALSETTINGS_START, EEPROM_GLOBALSETTINGS_END, GlobalSettings> GlobalSettingsStorage;
-typedef PageStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, AppData> AppDataStorage;
-
 GlobalSettings global_settings;
 GlobalSettingsStorage global_settings_storage;
 
 AppData app_settings;
 AppDataStorage app_data_storage;
 
+// Settings are written incrementally so the main loop (and display) doesn't
+// stall for the entire EEPROM write; this is the max. number of bytes written
+// per call to apps::SaveStep.
+static constexpr size_t kSettingsSaveBytesPerStep = 32;
+
 static constexpr int DEFAULT_APP_INDEX = 0;
 static const uint16_t DEFAULT_APP_ID = available_apps[DEFAULT_APP_INDEX].id;
 
@@ -129,28 +101,34 @@ void save_global_settings() {
   // scaling settings:
   global_settings.DAC_scaling = OC::DAC::store_scaling();
   
-  global_settings_storage.Save(global_settings);
-  SERIAL_PRINTLN("Saved global settings: page_index %d", global_settings_storage.page_index());
+  if (global_settings_storage.BeginSave(global_settings))
+    SERIAL_PRINTLN("Saving global settings...");
 }
 
+// Serializing all apps at once takes a while, so save_app_data only starts
+// it: apps::SaveStep serializes one app per call, and begins saving when all
+// are done. Apps are always saved in the same order, so unchanged chunks stay
+// in place and only actual changes end up in the journal.
+static size_t save_app_index = NUM_AVAILABLE_APPS;
+
 void save_app_data() {
   SERIAL_PRINTLN("Save app data... (%u bytes available)", OC::AppData::kAppDataSize);
 
   app_settings.used = 0;
-  char *data = app_settings.data;
-  char *data_end = data + OC::AppData::kAppDataSize;
-
-  size_t start_app = random(NUM_AVAILABLE_APPS);
-  for (size_t i = 0; i < NUM_AVAILABLE_APPS; ++i) {
-    const auto &app = available_apps[(start_app + i) % NUM_AVAILABLE_APPS];
-    size_t storage_size = app.storageSize() + sizeof(AppChunkHeader);
-    if (storage_size & 1) ++storage_size; // Align chunks on 2-byte boundaries
-    if (storage_size > sizeof(AppChunkHeader) && app.Save) {
-      if (data + storage_size > data_end) {
-        SERIAL_PRINTLN("%s: ERROR: %u BYTES NEEDED, %u BYTES AVAILABLE OF %u BYTES TOTAL", app.name, storage_size, data_end - data, AppData::kAppDataSize);
-        continue;
-      }
+  save_app_index = 0;
+}
+
+static void save_next_app() {
+  const auto &app = available_apps[save_app_index++];
+  char *data = app_settings.data + app_settings.used;
+  char *data_end = app_settings.data + OC::AppData::kAppDataSize;
 
+  size_t storage_size = app.storageSize() + sizeof(AppChunkHeader);
+  if (storage_size & 1) ++storage_size; // Align chunks on 2-byte boundaries
+  if (storage_size > sizeof(AppChunkHeader) && app.Save) {
+    if (data + storage_size > data_end) {
+      SERIAL_PRINTLN("%s: ERROR: %u BYTES NEEDED, %u BYTES AVAILABLE OF %u BYTES TOTAL", app.name, storage_size, data_end - data, AppData::kAppDataSize);
+    } else {
       AppChunkHeader *chunk = reinterpret_cast<AppChunkHeader *>(data);
       chunk->id = app.id;
       chunk->length = storage_size;
@@ -160,12 +138,14 @@ void save_app_data() {
         app.Save(chunk + 1);
       #endif
       app_settings.used += chunk->length;
-      data += chunk->length;
     }
   }
-  SERIAL_PRINTLN("App settings used: %u/%u", app_settings.used, EEPROM_APPDATA_BINARY_SIZE);
-  app_data_storage.Save(app_settings);
-  SERIAL_PRINTLN("Saved app settings in page_index %d", app_data_storage.page_index());
+
+  if (save_app_index == NUM_AVAILABLE_APPS) {
+    SERIAL_PRINTLN("App settings used: %u/%u", app_settings.used, EEPROM_APPDATA_BINARY_SIZE);
+    if (app_data_storage.BeginSave(app_settings))
+      SERIAL_PRINTLN("Saving app settings...");
+  }
 }
 
 void restore_app_data() {
@@ -219,13 +199,43 @@ void restore_app_data() {
 
 namespace apps {
 
+static size_t app_block_ticks = 0;
+
 void set_current_app(int index) {
   current_app = &available_apps[index];
   global_settings.current_app_id = current_app->id;
+  // New app starts with fresh block
+  app_block_ticks = 0;
+}
+
+void FASTRUN BlockISR() {
+  if (!app_block_ticks) {
+    current_app->BeginBlock();
+    app_block_ticks = kAppBlockSize;
+  }
+  --app_block_ticks;
+  current_app->isr();
 }
 
 App *current_app = &available_apps[DEFAULT_APP_INDEX];
 
+bool SaveStep() {
+  if (save_app_index < NUM_AVAILABLE_APPS) {
+    save_next_app();
+    return false;
+  }
+
+  // One storage at a time, so at most kSettingsSaveBytesPerStep are written
+  if (global_settings_storage.saving()) {
+    if (global_settings_storage.SaveStep(kSettingsSaveBytesPerStep))
+      SERIAL_PRINTLN("Saved global settings: page_index %d", global_settings_storage.page_index());
+  } else if (app_data_storage.saving()) {
+    if (app_data_storage.SaveStep(kSettingsSaveBytesPerStep))
+      SERIAL_PRINTLN("Saved app settings in page_index %d, journal %u", app_data_storage.page_index(), app_data_storage.journal_used());
+  }
+  return !global_settings_storage.saving() && !app_data_storage.saving();
+}
+
 App *find(uint16_t id) {
   for (auto &app : available_apps)
     if (app.id == id) return &app;
@@ -290,11 +300,12 @@ void Init(bool reset_settings) {
       DAC::restore_scaling(global_settings.DAC_scaling); // recover output scaling settings
     }
 
-    SERIAL_PRINTLN("Load app data: size is %u, PAGESIZE=%u, PAGES=%u, LENGTH=%u",
+    SERIAL_PRINTLN("Load app data: size is %u, PAGESIZE=%u, PAGES=%u, LENGTH=%u, JOURNAL_ADDR=%u",
                   sizeof(AppData),
                   AppDataStorage::PAGESIZE,
                   AppDataStorage::PAGES,
-                  AppDataStorage::LENGTH);
+                  AppDataStorage::LENGTH,
+                  AppDataStorage::JOURNAL_ADDR);
 
     if (!app_data_storage.Load(app_settings)) {
       SERIAL_PRINTLN("Data not loaded, using defaults!");
@@ -400,10 +411,12 @@ void Ui::AppSettings() {
     if (save) {
       save_global_settings();
       save_app_data();
-      // draw message:
+      // draw message, whatever isn't saved by then continues in the main loop
       int cnt = 0;
-      while(idle_time() < SETTINGS_SAVE_TIMEOUT_MS)
+      while(idle_time() < SETTINGS_SAVE_TIMEOUT_MS) {
+        apps::SaveStep();
         draw_save_message((cnt++) >> 4);
+      }
     }
   }
 
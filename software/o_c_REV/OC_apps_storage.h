@@ -0,0 +1,69 @@
+#ifndef OC_APPS_STORAGE_H_
+#define OC_APPS_STORAGE_H_
+
+#include "OC_autotune.h"
+#include "OC_chords.h"
+#include "OC_config.h"
+#include "OC_patterns.h"
+#include "OC_scales.h"
+#include "util/util_pagestorage.h"
+#include "util/EEPROMStorage.h"
+
+namespace OC {
+
+// Global settings are stored separately to actual app setings.
+// The theory is that they might not change as often.
+struct GlobalSettings {
+  static constexpr uint32_t FOURCC = FOURCC<'O','C','S',2>::value;
+
+  bool encoders_enable_acceleration;
+  bool reserved0;
+  bool reserved1;
+  uint32_t DAC_scaling;
+  uint16_t current_app_id;
+
+  OC::Scale user_scales[OC::Scales::SCALE_USER_LAST];
+  OC::Pattern user_patterns[OC::Patterns::PATTERN_USER_ALL];
+  OC::Chord user_chords[OC::Chords::CHORDS_USER_LAST];
+  OC::Autotune_data auto_calibration_data[DAC_CHANNEL_LAST];
+};
+
+// App settings are packed into a single blob of binary data; each app's chunk
+// gets its own header with id and the length of the entire chunk. This makes
+// this a bit more flexible during development.
+// Chunks are aligned on 2-byte boundaries for arbitrary reasons (thankfully M4
+// allows unaligned access...)
+struct AppChunkHeader {
+  uint16_t id;
+  uint16_t length;
+} __attribute__((packed));
+
+struct AppData {
+  static constexpr uint32_t FOURCC = FOURCC<'O','C','A',4>::value;
+
+  static constexpr size_t kAppDataSize = EEPROM_APPDATA_BINARY_SIZE;
+  char data[kAppDataSize];
+  size_t used;
+};
+
+// Each region only has room for a single page, so the space left over after
+// it is used for journal records: small changes don't require writing the
+// entire page, and the page can be rewritten without losing the data if the
+// power goes out during a save (\sa PageStorage).
+typedef PageStorage<EEPROMStorage, EEPROM_GLOBALSETTINGS_START, EEPROM_GLOBALSETTINGS_END, GlobalSettings> GlobalSettingsPages;
+typedef PageStorage<EEPROMStorage, EEPROM_GLOBALSETTINGS_START, EEPROM_GLOBALSETTINGS_END, GlobalSettings,
+                    STORAGE_UPDATE, true,
+                    GlobalSettingsPages::LENGTH - GlobalSettingsPages::PAGES * GlobalSettingsPages::PAGESIZE> GlobalSettingsStorage;
+typedef PageStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, AppData> AppDataPages;
+typedef PageStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, AppData,
+                    STORAGE_UPDATE, true,
+                    AppDataPages::LENGTH - AppDataPages::PAGES * AppDataPages::PAGESIZE> AppDataStorage;
+
+static_assert(GlobalSettingsStorage::PAGES > 1 || GlobalSettingsStorage::JOURNAL_ADDR < EEPROM_GLOBALSETTINGS_END,
+              "Global settings need either two pages or a journal");
+static_assert(AppDataStorage::PAGES > 1 || AppDataStorage::JOURNAL_ADDR < EEPROM_APPDATA_END,
+              "App data needs either two pages or a journal");
+
+}; // namespace OC
+
+#endif // OC_APPS_STORAGE_H_
@@ -44,7 +44,8 @@ struct CalibrationData {
   uint8_t display_offset;
   uint32_t flags;
   uint8_t screensaver_timeout; // 0: default, else seconds
-  uint8_t reserved0[3];
+  uint8_t adc_filters; // ADC::FilterPreset per channel, 2 bits each
+  uint8_t reserved0[2];
   #ifdef VOR
     /* less complicated this way than adding it to DAC::CalibrationData... */
     uint32_t v_bias; // upper 2 bytes: asymmetric; lower 2 bytes: bipolar.
@@ -61,8 +62,18 @@ struct CalibrationData {
     flags = (flags & ~CALIBRATION_FLAG_ENCODER_MASK) | raw_config;
     return static_cast<EncoderConfig>(raw_config);
   }
+
+  ADC::FilterPreset adc_filter_preset(ADC_CHANNEL channel) const {
+    return static_cast<ADC::FilterPreset>((adc_filters >> (channel * 2)) & 0x3);
+  }
+
+  void set_adc_filter_preset(ADC_CHANNEL channel, int preset) {
+    adc_filters = (adc_filters & ~(0x3 << (channel * 2))) | ((preset & 0x3) << (channel * 2));
+  }
 };
 
+static_assert(ADC::FILTER_PRESET_LAST <= 4, "ADC filter presets don't fit in 2 bits");
+
 static_assert(sizeof(DAC::CalibrationData) == 88, "DAC::CalibrationData size changed!");
 static_assert(sizeof(ADC::CalibrationData) == 12, "ADC::CalibrationData size changed!");
 static_assert(sizeof(CalibrationData) == 116, "Calibration data size changed!");
@@ -60,7 +60,8 @@ const OC::CalibrationData kCalibrationDefaults = {
   SH1106_128x64_Driver::kDefaultOffset,
   OC_CALIBRATION_DEFAULT_FLAGS,
   SCREENSAVER_TIMEOUT_S, 
-  { 0, 0, 0 }, // reserved0
+  0, // adc_filters: all default
+  { 0, 0 }, // reserved0
   #ifdef VOR
   DAC::VBiasBipolar | (DAC::VBiasAsymmetric << 16) // default v_bias values
   #else
@@ -133,6 +134,7 @@ enum CALIBRATION_STEP {
   
   CV_OFFSET_0, CV_OFFSET_1, CV_OFFSET_2, CV_OFFSET_3,
   ADC_PITCH_C2, ADC_PITCH_C4,
+  CV_FILTER_0, CV_FILTER_1, CV_FILTER_2, CV_FILTER_3,
   CALIBRATION_SCREENSAVER_TIMEOUT,
   CALIBRATION_EXIT,
   CALIBRATION_STEP_LAST,
@@ -151,6 +153,7 @@ enum CALIBRATION_TYPE {
   CALIBRATE_ADC_3V,
   CALIBRATE_DISPLAY,
   CALIBRATE_SCREENSAVER,
+  CALIBRATE_ADC_FILTER,
 };
 
 struct CalibrationStep {
@@ -400,7 +403,12 @@ const CalibrationStep calibration_steps[CALIBRATION_STEP_LAST] = {
     { ADC_PITCH_C2, "CV Scaling 1V", "CV1: Input 1V (C2)", "[R] Long press to set", default_footer, CALIBRATE_ADC_1V, 0, nullptr, 0, 0 },
     { ADC_PITCH_C4, "CV Scaling 3V", "CV1: Input 3V (C4)", "[R] Long press to set", default_footer, CALIBRATE_ADC_3V, 0, nullptr, 0, 0 },
   #endif
-  
+
+  { CV_FILTER_0, "CV1 Filter", "Filter", default_help_r, default_footer, CALIBRATE_ADC_FILTER, ADC_CHANNEL_1, OC::Strings::adc_filter_presets, 0, OC::ADC::FILTER_PRESET_LAST - 1 },
+  { CV_FILTER_1, "CV2 Filter", "Filter", default_help_r, default_footer, CALIBRATE_ADC_FILTER, ADC_CHANNEL_2, OC::Strings::adc_filter_presets, 0, OC::ADC::FILTER_PRESET_LAST - 1 },
+  { CV_FILTER_2, "CV3 Filter", "Filter", default_help_r, default_footer, CALIBRATE_ADC_FILTER, ADC_CHANNEL_3, OC::Strings::adc_filter_presets, 0, OC::ADC::FILTER_PRESET_LAST - 1 },
+  { CV_FILTER_3, "CV4 Filter", "Filter", default_help_r, default_footer, CALIBRATE_ADC_FILTER, ADC_CHANNEL_4, OC::Strings::adc_filter_presets, 0, OC::ADC::FILTER_PRESET_LAST - 1 },
+
   { CALIBRATION_SCREENSAVER_TIMEOUT, "Screensaver", "Timeout (s)", default_help_r, default_footer, CALIBRATE_SCREENSAVER, 0, nullptr, (OC::Ui::kLongPressTicks * 2 + 500) / 1000, SCREENSAVER_TIMEOUT_MAX_S },
 
   { CALIBRATION_EXIT, "Calibration complete", "Save values? ", select_help, end_footer, CALIBRATE_NONE, 0, OC::Strings::no_yes, 0, 1 }
@@ -544,6 +552,10 @@ void OC::Ui::Calibrate() {
         SERIAL_PRINTLN("timeout=%d", calibration_state.encoder_value);
         break;
 
+      case CALIBRATE_ADC_FILTER:
+        calibration_state.encoder_value = OC::calibration_data.adc_filter_preset(static_cast<ADC_CHANNEL>(next_step->index));
+        break;
+
       case CALIBRATE_NONE:
       default:
         if (CALIBRATION_EXIT != next_step->step) {
@@ -613,6 +625,13 @@ void calibration_draw(const CalibrationState &state) {
       graphics.drawFrame(0, 0, 128, 64);
       break;
 
+    case CALIBRATE_ADC_FILTER:
+      graphics.print(step->message);
+      graphics.setPrintPos(kValueX - 12, y + 2);
+      graphics.print(step->value_str[state.encoder_value]);
+      menu::DrawEditIcon(kValueX - 12, y, state.encoder_value, step->min, step->max);
+      break;
+
     case CALIBRATE_ADC_1V:
     case CALIBRATE_ADC_3V:
       graphics.setPrintPos(menu::kIndentDx, y + 2);
@@ -725,6 +744,12 @@ void calibration_update(CalibrationState &state) {
       DAC::set_all_octave(0);
       OC::calibration_data.screensaver_timeout = state.encoder_value;
       break;
+    case CALIBRATE_ADC_FILTER:
+      // Applied after calibration, so the offsets above are measured with the
+      // default filters
+      DAC::set_all_octave(0);
+      OC::calibration_data.set_adc_filter_preset(static_cast<ADC_CHANNEL>(step->index), state.encoder_value);
+      break;
   }
 }
 
@@ -6,7 +6,7 @@ namespace OC {
     Chord user_chords[Chords::CHORDS_USER_LAST];
 
     /*static*/
-    const int Chords::NUM_CHORD_PROGRESSIONS = 0x4;
+    constexpr int Chords::NUM_CHORD_PROGRESSIONS;
     const int Chords::NUM_CHORDS_TOTAL = OC::Chords::CHORDS_USER_LAST; // = 8
     const int Chords::NUM_CHORDS_PROPERTIES = sizeof(Chord);
     const int Chords::NUM_CHORDS = Chords::NUM_CHORDS_TOTAL / Chords::NUM_CHORD_PROGRESSIONS;
@@ -13,7 +13,7 @@ public:
   static const int NUM_CHORDS_TOTAL;
   static const int NUM_CHORDS;
   static const int NUM_CHORDS_PROPERTIES;
-  static const int NUM_CHORD_PROGRESSIONS;
+  static constexpr int NUM_CHORD_PROGRESSIONS = 0x4;
 
   enum CHORD_SLOTS
   {
@@ -5,6 +5,7 @@
 #include "OC_debug.h"
 #include "OC_menus.h"
 #include "OC_ui.h"
+#include "braids_quantizer.h"
 #include "util/util_misc.h"
 #include "extern/dspinst.h"
 
@@ -42,6 +43,11 @@ namespace DEBUG {
   debug::AveragedCycles ISR_cycles;
   debug::AveragedCycles UI_cycles;
   debug::AveragedCycles MENU_draw_cycles;
+  debug::CycleHistogram ISR_histogram;
+  debug::CycleHistogram UI_histogram;
+  debug::CycleHistogram MENU_draw_histogram;
+  uint32_t MENU_redraws;
+  uint32_t MENU_redraws_skipped;
   uint32_t UI_event_count;
   uint32_t UI_max_queue_depth;
   uint32_t UI_queue_overflow;
@@ -50,6 +56,29 @@ namespace DEBUG {
     debug::CycleMeasurement::Init();
     DebugPins::Init();
   }
+
+  void ResetHistograms() {
+    ISR_histogram.Reset();
+    UI_histogram.Reset();
+    MENU_draw_histogram.Reset();
+  }
+
+  static void dump_histogram(const char *name, const debug::CycleHistogram &histogram) {
+    serial_printf("%s: n=%u max=%u (%uus) app=%04x tick=%u\n",
+                  name, histogram.count(), histogram.max_value(),
+                  debug::cycles_to_us(histogram.max_value()),
+                  histogram.max_tag(), histogram.max_timestamp());
+    for (size_t i = 0; i < debug::CycleHistogram::kNumBuckets; ++i) {
+      if (histogram.bucket(i))
+        serial_printf("  >=%6u: %u\n", debug::CycleHistogram::bucket_value(i), histogram.bucket(i));
+    }
+  }
+
+  void DumpHistograms() {
+    dump_histogram("CORE", ISR_histogram);
+    dump_histogram("POLL", UI_histogram);
+    dump_histogram("MENU", MENU_draw_histogram);
+  }
 }; // namespace DEBUG
 
 static void debug_menu_core() {
@@ -89,6 +118,36 @@ static void debug_menu_gfx() {
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.min_value()),
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.value()),
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.max_value()));
+
+  graphics.setPrintPos(2, 32);
+  graphics.printf("DRAW %u SKIP %u", DEBUG::MENU_redraws, DEBUG::MENU_redraws_skipped);
+}
+
+// Bars are log2(count) high, one bucket per column
+static void debug_menu_histogram(const debug::CycleHistogram &histogram) {
+  graphics.setPrintPos(2, 12);
+  graphics.printf("max %uus %04x", debug::cycles_to_us(histogram.max_value()), histogram.max_tag());
+  graphics.setPrintPos(2, 22);
+  graphics.printf("@%u", histogram.max_timestamp());
+
+  for (size_t i = 0; i < debug::CycleHistogram::kNumBuckets; ++i) {
+    uint32_t count = histogram.bucket(i);
+    weegfx::coord_t h = count ? 32 - __builtin_clz(count) : 0;
+    if (h)
+      graphics.drawRect(i * 8, 64 - h, 7, h);
+  }
+}
+
+static void debug_menu_isr_histogram() {
+  debug_menu_histogram(DEBUG::ISR_histogram);
+}
+
+static void debug_menu_ui_histogram() {
+  debug_menu_histogram(DEBUG::UI_histogram);
+}
+
+static void debug_menu_menu_histogram() {
+  debug_menu_histogram(DEBUG::MENU_draw_histogram);
 }
 
 static void debug_menu_adc() {
@@ -110,6 +169,17 @@ static void debug_menu_adc() {
 //      graphics.setPrintPos(2, 52); graphics.print(ADC::fail_flag1());
 }
 
+static void debug_menu_quantizer() {
+  graphics.setPrintPos(2, 12);
+  graphics.print("Codebook cache");
+
+  graphics.setPrintPos(2, 22);
+  graphics.printf("hit  %u", braids::CodebookCache::hits());
+
+  graphics.setPrintPos(2, 32);
+  graphics.printf("miss %u", braids::CodebookCache::misses());
+}
+
 struct DebugMenu {
   const char *title;
   void (*display_fn)();
@@ -119,6 +189,10 @@ static const DebugMenu debug_menus[] = {
   { " CORE", debug_menu_core },
   { " GFX", debug_menu_gfx },
   { " ADC", debug_menu_adc },
+  { " QUANT", debug_menu_quantizer },
+  { " CORE HIST", debug_menu_isr_histogram },
+  { " POLL HIST", debug_menu_ui_histogram },
+  { " MENU HIST", debug_menu_menu_histogram },
 #ifdef POLYLFO_DEBUG  
   { " POLYLFO", POLYLFO_debug },
 #endif // POLYLFO_DEBUG
@@ -165,6 +239,11 @@ void Ui::DebugStats() {
         ++current_menu;
         if (!current_menu->title || !current_menu->display_fn)
           current_menu = &debug_menus[0];
+      } else if (UI::EVENT_BUTTON_PRESS == event.type) {
+        if (CONTROL_BUTTON_UP == event.control)
+          DEBUG::DumpHistograms();
+        else if (CONTROL_BUTTON_DOWN == event.control)
+          DEBUG::ResetHistograms();
       }
     }
   }
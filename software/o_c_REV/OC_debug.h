@@ -16,6 +16,16 @@ namespace DEBUG {
   extern debug::AveragedCycles UI_cycles;
   extern debug::AveragedCycles MENU_draw_cycles;
 
+  extern debug::CycleHistogram ISR_histogram;
+  extern debug::CycleHistogram UI_histogram;
+  extern debug::CycleHistogram MENU_draw_histogram;
+
+  extern uint32_t MENU_redraws;
+  extern uint32_t MENU_redraws_skipped;
+
+  void ResetHistograms();
+  void DumpHistograms();
+
   extern uint32_t UI_event_count;
   extern uint32_t UI_max_queue_depth;
   extern uint32_t UI_queue_overflow;
@@ -37,6 +47,10 @@ public:
 #define OC_DEBUG_PROFILE_SCOPE(var) \
   debug::ScopedCycleMeasurement cycles(var)
 
+// Additionally track histogram, tagged with e.g. the app id and a timestamp
+#define OC_DEBUG_PROFILE_SCOPE_HISTOGRAM(var, histogram, tag, timestamp) \
+  debug::ScopedCycleMeasurement cycles(var, histogram, tag, timestamp)
+
 #define OC_DEBUG_RESET_CYCLES(counter, count, var) \
   do { \
     if (!((counter) & (count - 1))) \
@@ -3,6 +3,7 @@
 #include "OC_digital_inputs.h"
 #include "OC_gpio.h"
 #include "OC_options.h"
+#include "util/util_profiling.h"
 
 /*static*/
 uint32_t OC::DigitalInputs::clocked_mask_;
@@ -10,6 +11,24 @@ uint32_t OC::DigitalInputs::clocked_mask_;
 /*static*/
 volatile uint32_t OC::DigitalInputs::clocked_[DIGITAL_INPUT_LAST];
 
+/*static*/
+util::EdgeQueue<OC::DigitalInputs::kMaxEdgesPerTick> OC::DigitalInputs::edge_queues_[DIGITAL_INPUT_LAST];
+
+/*static*/
+uint32_t OC::DigitalInputs::scan_timestamp_;
+
+/*static*/
+size_t OC::DigitalInputs::num_edges_[DIGITAL_INPUT_LAST];
+
+/*static*/
+uint32_t OC::DigitalInputs::edge_timestamps_[DIGITAL_INPUT_LAST][kMaxEdgesPerTick];
+
+/*static*/
+uint32_t OC::DigitalInputs::last_edges_[DIGITAL_INPUT_LAST];
+
+/*static*/
+uint32_t OC::DigitalInputs::edge_periods_[DIGITAL_INPUT_LAST];
+
 void FASTRUN tr1_ISR() {  
   OC::DigitalInputs::clock<OC::DIGITAL_INPUT_1>();
 }  // main clock
@@ -39,18 +58,27 @@ void OC::DigitalInputs::Init() {
     {TR4, tr4_ISR},
   };
 
+  // Edges are timestamped with the cycle counter
+  debug::CycleMeasurement::Init();
+
+  clocked_mask_ = 0;
+  std::fill(clocked_, clocked_ + DIGITAL_INPUT_LAST, 0);
+  for (auto &queue : edge_queues_)
+    queue.Init();
+  scan_timestamp_ = 0;
+  std::fill(num_edges_, num_edges_ + DIGITAL_INPUT_LAST, 0);
+  std::fill(last_edges_, last_edges_ + DIGITAL_INPUT_LAST, 0);
+  std::fill(edge_periods_, edge_periods_ + DIGITAL_INPUT_LAST, 0);
+
   for (auto pin : pins) {
     pinMode(pin.pin, OC_GPIO_TRx_PINMODE);
     attachInterrupt(pin.pin, pin.isr_fn, FALLING);
   }
 
-  clocked_mask_ = 0;
-  std::fill(clocked_, clocked_ + DIGITAL_INPUT_LAST, 0);
-
-  // Assume the priority of pin change interrupts is lower or equal to the
-  // thread where ::Scan function is called. Otherwise a safer mechanism is
-  // required to avoid conflicts (LDREX/STREX or store ARM_DWT_CYCCNT in the
-  // array to check for changes.
+  // The edge queues are lock-free, but the clocked_ flag (only used when a
+  // queue overflows) assumes the priority of pin change interrupts is lower or
+  // equal to the thread where ::Scan function is called. Otherwise a safer
+  // mechanism is required to avoid conflicts (LDREX/STREX).
   //
   // A really nice approach would be to use the FTM timer mechanism and avoid
   // the ISR altogether, but this only works for one of the pins. Using more
@@ -83,4 +111,6 @@ void OC::DigitalInputs::Scan() {
     ScanInput<DIGITAL_INPUT_2>() |
     ScanInput<DIGITAL_INPUT_3>() |
     ScanInput<DIGITAL_INPUT_4>();
+  // After the queues are drained, so all edges of this tick are in the past
+  scan_timestamp_ = ARM_DWT_CYCCNT;
 }
@@ -5,6 +5,7 @@
 #include "OC_config.h"
 #include "OC_core.h"
 #include "OC_gpio.h"
+#include "util/util_edge_queue.h"
 
 namespace OC {
 
@@ -61,8 +62,44 @@ public:
     return !digitalReadFast(InputPinMap(input));
   }
 
+  // Each edge is timestamped with the cycle counter (ARM_DWT_CYCCNT) in the pin
+  // ISR, so timing derived from clocks (e.g. period measurement) isn't limited
+  // to tick resolution. The edges of the current tick, i.e. those since the
+  // previous Scan, are available until the next Scan.
+  static constexpr size_t kMaxEdgesPerTick = 4;
+  static constexpr uint32_t kCyclesPerTick = (F_CPU / 1000000UL) * OC_CORE_TIMER_RATE;
+
+  // @return number of edges of input in current tick
+  static inline size_t edges(DigitalInput input) {
+    return num_edges_[input];
+  }
+
+  // @return cycle counter timestamp of edge in current tick
+  static inline uint32_t edge_timestamp(DigitalInput input, size_t edge) {
+    return edge_timestamps_[input][edge];
+  }
+
+  // @return sub-tick offset of edge in current tick, i.e. cycles between the
+  // edge and the Scan. Normally < kCyclesPerTick, unless the core ISR was late.
+  static inline uint32_t edge_offset(DigitalInput input, size_t edge) {
+    return scan_timestamp_ - edge_timestamps_[input][edge];
+  }
+
+  // @return cycles between the two most recent edges of input, or 0 if there
+  // weren't two edges yet
+  static inline uint32_t edge_period(DigitalInput input) {
+    return edge_periods_[input];
+  }
+
+  // @return number of edges dropped because the ISR queue was full
+  static inline uint32_t edge_overflows(DigitalInput input) {
+    return edge_queues_[input].overflows();
+  }
+
   template <DigitalInput input> static inline void clock() {
-    clocked_[input] = 1;
+    // If the queue is full the edge still clocks the input
+    if (!edge_queues_[input].Push(ARM_DWT_CYCCNT))
+      clocked_[input] = 1;
   }
 
 private:
@@ -81,13 +118,31 @@ private:
   static uint32_t clocked_mask_;
   static volatile uint32_t clocked_[DIGITAL_INPUT_LAST];
 
+  static util::EdgeQueue<kMaxEdgesPerTick> edge_queues_[DIGITAL_INPUT_LAST];
+  static uint32_t scan_timestamp_;
+  static size_t num_edges_[DIGITAL_INPUT_LAST];
+  static uint32_t edge_timestamps_[DIGITAL_INPUT_LAST][kMaxEdgesPerTick];
+  static uint32_t last_edges_[DIGITAL_INPUT_LAST];
+  static uint32_t edge_periods_[DIGITAL_INPUT_LAST];
+
   template <DigitalInput input>
   static uint32_t ScanInput() {
+    size_t num_edges = 0;
+    uint32_t timestamp;
+    while (num_edges < kMaxEdgesPerTick && edge_queues_[input].Pop(timestamp)) {
+      edge_timestamps_[input][num_edges++] = timestamp;
+      if (last_edges_[input])
+        edge_periods_[input] = timestamp - last_edges_[input];
+      // 0 is reserved for "no edge yet"
+      last_edges_[input] = timestamp ? timestamp : 1;
+    }
+    num_edges_[input] = num_edges;
+
     if (clocked_[input]) {
       clocked_[input] = 0;
       return DIGITAL_INPUT_MASK(input);
     } else {
-      return 0;
+      return num_edges ? DIGITAL_INPUT_MASK(input) : 0;
     }
   }
 };
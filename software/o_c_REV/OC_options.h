@@ -30,6 +30,8 @@
 //#define DAC8564
 /* ------------ 0 / 10V range ---------------------------------------------------------------------------------------------------------------------------  */
 //#define IO_10V
+/* ------------ update DAC via DMA instead of blocking SPI writes (experimental, not yet measured on hardware) ------------------------------------------  */
+//#define OC_DAC_DMA
 
 
 /* do not edit the stuff below (unless ... ) */
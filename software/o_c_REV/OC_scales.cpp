@@ -9,7 +9,7 @@ Scale user_scales[Scales::SCALE_USER_LAST];
 Scale dummy_scale;
 
 /*static*/
-const int Scales::NUM_SCALES = OC::Scales::SCALE_USER_LAST + sizeof(braids::scales) / sizeof(braids::scales[0]);
+constexpr int Scales::NUM_SCALES;
 
 /*static*/
 void Scales::Init() {
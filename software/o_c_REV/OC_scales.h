@@ -2,6 +2,7 @@
 #define OS_SCALES_H_
 
 #include "braids_quantizer.h"
+#include "braids_quantizer_scales.h"
 
 // Common scales and stuff
 namespace OC {
@@ -14,8 +15,6 @@ static constexpr int kMinScaleLength = 4;
 class Scales {
 public:
 
-  static const int NUM_SCALES;
-
   enum {
     SCALE_USER_0,
     SCALE_USER_1,
@@ -26,6 +25,8 @@ public:
     SCALE_NONE = SCALE_USER_LAST,
   };
 
+  static constexpr int NUM_SCALES = SCALE_USER_LAST + sizeof(braids::scales) / sizeof(braids::scales[0]);
+
   static void Init();
   static const Scale &GetScale(int index);
 };
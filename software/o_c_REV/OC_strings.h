@@ -26,6 +26,7 @@ namespace OC {
     extern const char * const off_on[];
     extern const char * const scaling_string[];
     extern const char * const encoder_config_strings[];
+    extern const char * const adc_filter_presets[];
     extern const char * const bytebeat_equation_names[];
     extern const char * const envelope_shapes[];
     extern const char * const integer_sequence_names[];
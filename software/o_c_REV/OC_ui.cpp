@@ -27,6 +27,7 @@ Ui ui;
 
 void Ui::Init() {
   ticks_ = 0;
+  dispatched_events_ = 0;
   set_screensaver_timeout(SCREENSAVER_TIMEOUT_S);
 
   #ifdef VOR
@@ -158,6 +159,7 @@ UiMode Ui::DispatchEvents(App *app) {
       default:
         break;
     }
+    ++dispatched_events_;
     MENU_REDRAW = 1;
   }
 
@@ -96,6 +96,11 @@ public:
     return ticks_;
   }
 
+  // @return number of events dispatched to apps so far
+  inline uint32_t dispatched_events() const {
+    return dispatched_events_;
+  }
+
   inline void SetButtonIgnoreMask() {
     button_ignore_mask_ = button_state_;
   }
@@ -113,6 +118,7 @@ public:
 private:
 
   uint32_t ticks_;
+  uint32_t dispatched_events_;
   uint32_t screensaver_timeout_;
 
   UI::Button buttons_[CONTROL_BUTTON_LAST];
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 namespace braids {
 
@@ -38,6 +39,96 @@ void SortScale(Scale &scale) {
   std::sort(scale.notes, scale.notes + scale.num_notes);
 }
 
+namespace {
+
+struct CodebookCacheEntry {
+  uint32_t hash;
+  uint32_t last_used;
+  int16_t span;
+  uint16_t num_notes; // 0 if entry is unused
+  int16_t notes[16];
+  int16_t codebook[128];
+};
+
+CodebookCacheEntry codebook_cache[CodebookCache::kNumEntries];
+uint32_t codebook_cache_clock = 0;
+volatile bool codebook_cache_busy = false;
+
+inline uint32_t codebook_hash(const int16_t *notes, size_t num_notes, int16_t span) {
+  uint32_t hash = static_cast<uint16_t>(span);
+  while (num_notes--)
+    hash = hash * 31 + static_cast<uint16_t>(*notes++);
+  return hash;
+}
+
+inline bool codebook_matches(const CodebookCacheEntry &entry, uint32_t hash,
+                             const int16_t *notes, size_t num_notes, int16_t span) {
+  return entry.hash == hash && entry.num_notes == num_notes && entry.span == span &&
+      !memcmp(entry.notes, notes, num_notes * sizeof(int16_t));
+}
+
+};
+
+/*static*/ uint32_t CodebookCache::hits_ = 0;
+/*static*/ uint32_t CodebookCache::misses_ = 0;
+
+/*static*/ void CodebookCache::Clear() {
+  for (auto &entry : codebook_cache)
+    entry.num_notes = 0;
+  hits_ = misses_ = 0;
+}
+
+/*static*/ bool CodebookCache::Lookup(const int16_t *notes, size_t num_notes, int16_t span, int16_t *codebook) {
+  if (codebook_cache_busy) {
+    ++misses_;
+    return false;
+  }
+  codebook_cache_busy = true;
+
+  const uint32_t hash = codebook_hash(notes, num_notes, span);
+  bool hit = false;
+  for (auto &entry : codebook_cache) {
+    if (codebook_matches(entry, hash, notes, num_notes, span)) {
+      entry.last_used = ++codebook_cache_clock;
+      memcpy(codebook, entry.codebook, sizeof(entry.codebook));
+      hit = true;
+      break;
+    }
+  }
+  if (hit)
+    ++hits_;
+  else
+    ++misses_;
+
+  codebook_cache_busy = false;
+  return hit;
+}
+
+/*static*/ void CodebookCache::Insert(const int16_t *notes, size_t num_notes, int16_t span, const int16_t *codebook) {
+  if (codebook_cache_busy)
+    return;
+  codebook_cache_busy = true;
+
+  CodebookCacheEntry *victim = &codebook_cache[0];
+  for (auto &entry : codebook_cache) {
+    if (!entry.num_notes) {
+      victim = &entry;
+      break;
+    }
+    if (entry.last_used < victim->last_used)
+      victim = &entry;
+  }
+
+  victim->hash = codebook_hash(notes, num_notes, span);
+  victim->last_used = ++codebook_cache_clock;
+  victim->span = span;
+  victim->num_notes = num_notes;
+  memcpy(victim->notes, notes, num_notes * sizeof(int16_t));
+  memcpy(victim->codebook, codebook, sizeof(victim->codebook));
+
+  codebook_cache_busy = false;
+}
+
 
 void Quantizer::Init() {
   enabled_ = true;
@@ -48,6 +139,123 @@ void Quantizer::Init() {
   for (int16_t i = 0; i < 128; ++i) {
     codebook_[i] = (i - 64) << 7;
   }
+  direct_index_ = nullptr;
+  direct_index_valid_ = false;
+}
+
+#ifdef BUCHLA_4U
+static constexpr int32_t kPitchOffset = (12 << 7) << 2;
+#else
+static constexpr int32_t kPitchOffset = (12 << 7) << 1;
+#endif
+
+void Quantizer::Configure(const int16_t* notes, int16_t scale_span, size_t num_notes, uint16_t mask) {
+  enabled_ = notes != NULL && num_notes != 0 && scale_span != 0 && (mask & ~(0xffff<<num_notes));
+  if (enabled_) {
+
+    // Build up array that contains only the enabled notes, and use that to
+    // generate the codebook. This avoids a bunch of issues and checks in the
+    // main generating loop.
+    size_t num_enabled_notes = 0;
+    for (size_t i = 0; i < num_notes; ++i) {
+      if (mask & 1)
+        enabled_notes_[num_enabled_notes++] = notes[i];
+      mask >>= 1;
+    }
+
+    if (!CodebookCache::Lookup(enabled_notes_, num_enabled_notes, scale_span, codebook_)) {
+      BuildCodebook(num_enabled_notes, scale_span);
+      CodebookCache::Insert(enabled_notes_, num_enabled_notes, scale_span, codebook_);
+    }
+    if (direct_index_)
+      BuildDirectIndex();
+  }
+}
+
+void Quantizer::BuildCodebook(size_t num_enabled_notes, int16_t scale_span) {
+  const int16_t *notes = enabled_notes_;
+
+  int32_t octave = 0;
+  size_t note = 0;
+  int16_t span = scale_span;
+  int16_t *codebook;
+
+  codebook = &codebook_[0];
+
+  for (int32_t i = 0; i < 64; ++i) {
+    int32_t up = notes[note] + span * octave;
+    int32_t down = notes[num_enabled_notes - 1 - note] + (-octave - 1) * span;
+    CLIP(up)
+    CLIP(down)
+    *(codebook + 64 + i) = up;
+    *(codebook + 63 - i) = down;
+    ++note;
+    if (note >= num_enabled_notes) {
+      note = 0;
+      ++octave;
+    }
+  }
+}
+
+void Quantizer::BuildDirectIndex() {
+  // The index only gives the same results as the binary search if the
+  // searched part of the codebook is sorted (which it should be anyway).
+  direct_index_valid_ = std::is_sorted(&codebook_[3], &codebook_[126]);
+  if (!direct_index_valid_)
+    return;
+
+  // Each codeword is the upper bound for the buckets that start below it
+  // (and at or above the previous one)
+  uint8_t *upper_bounds = direct_index_->upper_bounds;
+  size_t bucket = 0;
+  for (int16_t i = 3; i < 126; ++i) {
+    size_t end = (codebook_[i] + 0x8000 + (1 << kDirectIndexShift) - 1) >> kDirectIndexShift;
+    if (end > bucket) {
+      memset(upper_bounds + bucket, i, end - bucket);
+      bucket = end;
+    }
+  }
+  memset(upper_bounds + bucket, 126, kDirectIndexSize - bucket);
+}
+
+int16_t Quantizer::Search(int32_t pitch) const {
+  int16_t upper_bound_index;
+  if (direct_index_ && direct_index_valid_) {
+    const int16_t value = static_cast<int16_t>(pitch);
+    upper_bound_index = direct_index_->upper_bounds[(value + 0x8000) >> kDirectIndexShift];
+    while (upper_bound_index < 126 && codebook_[upper_bound_index] <= value)
+      ++upper_bound_index;
+  } else {
+    upper_bound_index = std::upper_bound(
+        &codebook_[3],
+        &codebook_[126],
+        static_cast<int16_t>(pitch)) - &codebook_[0];
+  }
+  int16_t lower_bound_index = upper_bound_index - 2;
+
+  int16_t best_distance = 16384;
+  int16_t q = -1;
+  for (int16_t i = lower_bound_index; i <= upper_bound_index; ++i) {
+    int16_t distance = abs(pitch - codebook_[i]);
+    if (distance < best_distance) {
+      best_distance = distance;
+      q = i;
+    }
+  }
+  return q;
+}
+
+void Quantizer::Select(int16_t q, int32_t transpose) {
+  // Enlarge the current voronoi cell a bit for hysteresis.
+  previous_boundary_ = (9 * codebook_[q - 1] + 7 * codebook_[q]) >> 4;
+  next_boundary_ = (9 * codebook_[q + 1] + 7 * codebook_[q]) >> 4;
+
+  // Apply transpose after setting up boundaries
+  q += transpose;
+  if (q < 1) q = 1;
+  else if (q > 126) q = 126;
+  codeword_ = codebook_[q];
+  transpose_ = transpose;
 }
 
 int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
@@ -56,51 +264,60 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
   }
 
   pitch -= root;
-  #ifdef BUCHLA_4U
-    pitch -= ((12 << 7) << 2);
-  #else
-    pitch -= ((12 << 7) << 1);
-  #endif
+  pitch -= kPitchOffset;
   if (pitch >= previous_boundary_ && pitch <= next_boundary_ && transpose == transpose_) {
     // We're still in the voronoi cell for the active codeword.
-    pitch = codeword_;
   } else {
     // Search for the nearest neighbour in the codebook.
-    int16_t upper_bound_index = std::upper_bound(
-        &codebook_[3],
-        &codebook_[126],
-        static_cast<int16_t>(pitch)) - &codebook_[0];
-    int16_t lower_bound_index = upper_bound_index - 2;
-
-    int16_t best_distance = 16384;
-    int16_t q = -1;
-    for (int16_t i = lower_bound_index; i <= upper_bound_index; ++i) {
-      int16_t distance = abs(pitch - codebook_[i]);
-      if (distance < best_distance) {
-        best_distance = distance;
-        q = i;
+    Select(Search(pitch), transpose);
+  }
+  return codeword_ + root + kPitchOffset;
+}
+
+namespace {
+struct ConstantTranspose {
+  int32_t transpose;
+  int32_t operator [](size_t) const {
+    return transpose;
+  }
+};
+};
+
+template <typename Transposes>
+void Quantizer::ProcessBatchImpl(const int32_t *pitches, int32_t *results, size_t num,
+                                 int32_t root, Transposes transposes) {
+  if (!enabled_) {
+    std::copy(pitches, pitches + num, results);
+    return;
+  }
+
+  const int32_t offset = root + kPitchOffset;
+  // The search only depends on the pitch, so the last result can be re-used
+  // as long as the pitch doesn't change.
+  int32_t searched_pitch = 0;
+  int16_t searched_q = -1;
+  for (size_t i = 0; i < num; ++i) {
+    const int32_t pitch = pitches[i] - offset;
+    const int32_t transpose = transposes[i];
+    if (pitch < previous_boundary_ || pitch > next_boundary_ || transpose != transpose_) {
+      if (searched_q < 0 || pitch != searched_pitch) {
+        searched_q = Search(pitch);
+        searched_pitch = pitch;
       }
+      Select(searched_q, transpose);
     }
-
-    // Enlarge the current voronoi cell a bit for hysteresis.
-    previous_boundary_ = (9 * codebook_[q - 1] + 7 * codebook_[q]) >> 4;
-    next_boundary_ = (9 * codebook_[q + 1] + 7 * codebook_[q]) >> 4;
-
-    // Apply transpose after setting up boundaries
-    q += transpose;
-    if (q < 1) q = 1;
-    else if (q > 126) q = 126;
-    codeword_ = codebook_[q];
-    transpose_ = transpose;
-    pitch = codeword_;
+    results[i] = codeword_ + offset;
   }
-  pitch += root;
-  #ifdef BUCHLA_4U
-    pitch += ((12 << 7) << 2);
-  #else
-    pitch += ((12 << 7) << 1);
-  #endif
-  return pitch;
+}
+
+void Quantizer::ProcessBatch(const int32_t *pitches, int32_t *results, size_t num,
+                             int32_t root, int32_t transpose) {
+  ProcessBatchImpl(pitches, results, num, root, ConstantTranspose{transpose});
+}
+
+void Quantizer::ProcessBatch(const int32_t *pitches, int32_t *results, size_t num,
+                             int32_t root, const int32_t *transposes) {
+  ProcessBatchImpl(pitches, results, num, root, transposes);
 }
 
 int32_t Quantizer::Lookup(int32_t index) const {
@@ -36,24 +36,87 @@ namespace braids {
   
 struct Scale {
   int16_t span;
-  size_t num_notes;
+  uint32_t num_notes;
   int16_t notes[16];
 };
 
 void SortScale(Scale &);
 
+// Codebooks only depend on the enabled notes and the span, so recently built
+// ones are kept in a small cache shared by all quantizers. Switching back to
+// a recent scale or mask (e.g. mask rotation or scale CV) then copies the
+// codebook instead of rebuilding it. Since entries are keyed on the notes
+// themselves, edits to user scales never hit stale entries.
+//
+// Configure can be called from the main loop and ISR; if the ISR interrupts
+// an access, it just bypasses the cache.
+class CodebookCache {
+ public:
+  static const size_t kNumEntries = 8;
+
+  static void Clear();
+
+  // Copy codebook for notes & span if available
+  static bool Lookup(const int16_t *notes, size_t num_notes, int16_t span, int16_t *codebook);
+  // Add codebook, replacing the least recently used entry
+  static void Insert(const int16_t *notes, size_t num_notes, int16_t span, const int16_t *codebook);
+
+  static uint32_t hits() {
+    return hits_;
+  }
+
+  static uint32_t misses() {
+    return misses_;
+  }
+
+ private:
+  static uint32_t hits_;
+  static uint32_t misses_;
+};
+
 class Quantizer {
  public:
+  // The direct index maps the (16-bit) pitch, in buckets of
+  // 1 << kDirectIndexShift, to the first codeword above the bucket start.
+  // Searches start from there, so they take constant time as long as
+  // codewords are about a bucket apart (one step for semitones).
+  static const int kDirectIndexShift = 7;
+  static const size_t kDirectIndexSize = 0x10000 >> kDirectIndexShift;
+
+  struct DirectIndex {
+    uint8_t upper_bounds[kDirectIndexSize];
+  };
+
   Quantizer() { }
   ~Quantizer() { }
   
   void Init();
+
+  // Use (and maintain) direct index for codebook searches instead of a
+  // binary search. The index memory is provided by the caller, so quantizers
+  // that don't use it don't pay for it; nullptr disables it again.
+  void EnableDirectIndex(DirectIndex *direct_index) {
+    direct_index_ = direct_index;
+    if (direct_index_ && enabled_)
+      BuildDirectIndex();
+  }
   
   int32_t Process(int32_t pitch) {
     return Process(pitch, 0, 0);
   }
   
   int32_t Process(int32_t pitch, int32_t root, int32_t transpose);
+
+  // Quantize num pitches against the same codebook in one pass. The results
+  // (and the hysteresis state afterwards) are the same as calling
+  // Process(pitches[i], root, transpose) for each pitch in order, but runs of
+  // the same pitch (e.g. chords) only search the codebook once. Results can
+  // be written to pitches in-place.
+  void ProcessBatch(const int32_t *pitches, int32_t *results, size_t num,
+                    int32_t root, int32_t transpose);
+  // Same, with a transpose per pitch
+  void ProcessBatch(const int32_t *pitches, int32_t *results, size_t num,
+                    int32_t root, const int32_t *transposes);
   
   void Configure(const Scale& scale, uint16_t mask = 0xffff) {
     Configure(scale.notes, scale.span, scale.num_notes, mask);
@@ -74,44 +137,22 @@ class Quantizer {
   int32_t transpose_;
   int32_t previous_boundary_;
   int32_t next_boundary_;
-  inline void Configure(const int16_t* notes, int16_t scale_span, size_t num_notes, uint16_t mask)
-  {  
-    enabled_ = notes != NULL && num_notes != 0 && scale_span != 0 && (mask & ~(0xffff<<num_notes));
-    if (enabled_) {
-  
-      // Build up array that contains only the enabled notes, and use that to
-      // generate the codebook. This avoids a bunch of issues and checks in the
-      // main generating loop.
-      size_t num_enabled_notes = 0;
-      for (size_t i = 0; i < num_notes; ++i) {
-        if (mask & 1)
-          enabled_notes_[num_enabled_notes++] = notes[i];
-        mask >>= 1;
-      }
-      notes = enabled_notes_;
-     
-      int32_t octave = 0;
-      size_t note = 0;
-      int16_t span = scale_span;
-      int16_t *codebook;
-      
-      codebook = &codebook_[0];
-    
-      for (int32_t i = 0; i < 64; ++i) {
-        int32_t up = notes[note] + span * octave;
-        int32_t down = notes[num_enabled_notes - 1 - note] + (-octave - 1) * span;
-        CLIP(up)
-        CLIP(down)
-        *(codebook + 64 + i) = up;
-        *(codebook + 63 - i) = down;
-        ++note;
-        if (note >= num_enabled_notes) {
-          note = 0;
-          ++octave;
-        }
-      }
-    }
-  }
+  DirectIndex *direct_index_;
+  bool direct_index_valid_;
+
+  void BuildDirectIndex();
+
+  // Index of nearest neighbour in codebook
+  int16_t Search(int32_t pitch) const;
+  // Set up voronoi cell for codeword q, and apply transpose
+  void Select(int16_t q, int32_t transpose);
+
+  template <typename Transposes>
+  void ProcessBatchImpl(const int32_t *pitches, int32_t *results, size_t num,
+                        int32_t root, Transposes transposes);
+
+  void Configure(const int16_t* notes, int16_t scale_span, size_t num_notes, uint16_t mask);
+  void BuildCodebook(size_t num_enabled_notes, int16_t scale_span);
 
   DISALLOW_COPY_AND_ASSIGN(Quantizer);
 };
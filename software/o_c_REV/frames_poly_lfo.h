@@ -253,6 +253,10 @@ class PolyLfo {
     return(static_cast<float>(16666.6666666666666666667f * static_cast<double>(phase_increment_ch1_) / static_cast<double>(0xffffffff)));
   }
 
+  inline uint32_t get_phase_increment_ch1() const {
+    return phase_increment_ch1_;
+  }
+
   inline long get_sync_counter() {
     return sync_counter_;
   }
@@ -52,7 +52,8 @@ const bool DUMMY = false;
 IntervalTimer UI_timer;
 
 void FASTRUN UI_timer_ISR() {
-  OC_DEBUG_PROFILE_SCOPE(OC::DEBUG::UI_cycles);
+  OC_DEBUG_PROFILE_SCOPE_HISTOGRAM(OC::DEBUG::UI_cycles, OC::DEBUG::UI_histogram,
+                                   OC::apps::current_app->id, OC::CORE::ticks);
   OC::ui.Poll();
   OC_DEBUG_RESET_CYCLES(OC::ui.ticks(), 2048, OC::DEBUG::UI_cycles);
 }
@@ -64,7 +65,8 @@ volatile uint32_t OC::CORE::ticks = 0;
 
 void FASTRUN CORE_timer_ISR() {
   DEBUG_PIN_SCOPE(OC_GPIO_DEBUG_PIN2);
-  OC_DEBUG_PROFILE_SCOPE(OC::DEBUG::ISR_cycles);
+  OC_DEBUG_PROFILE_SCOPE_HISTOGRAM(OC::DEBUG::ISR_cycles, OC::DEBUG::ISR_histogram,
+                                   OC::apps::current_app->id, OC::CORE::ticks);
 
   // DAC and display share SPI. By first updating the DAC values, then starting
   // a DMA transfer to the display things are fairly nicely interleaved. In the
@@ -72,7 +74,9 @@ void FASTRUN CORE_timer_ISR() {
 
   display::Flush();
   OC::DAC::Update();
+#ifndef OC_DAC_DMA
   display::Update();
+#endif
 
   // see OC_ADC.h for details; empirically (with current parameters), Scan_DMA() picks up new samples @ 5.55kHz
   OC::ADC::Scan_DMA();
@@ -81,6 +85,13 @@ void FASTRUN CORE_timer_ISR() {
   // need extra precautions.
   OC::DigitalInputs::Scan();
 
+#ifdef OC_DAC_DMA
+  // The DAC transfer runs while the inputs are scanned; once it's done, the
+  // display can have the SPI.
+  OC::DAC::EndTransfer();
+  display::Update();
+#endif
+
 #ifndef OC_UI_SEPARATE_ISR
   TODO needs a counter
   UI_timer_ISR();
@@ -108,6 +119,9 @@ void setup() {
   OC::ADC::Init(&OC::calibration_data.adc); // Yes, it's using the calibration_data before it's loaded...
   OC::ADC::Init_DMA();
   OC::DAC::Init(&OC::calibration_data.dac);
+#ifdef OC_DAC_DMA
+  OC::DAC::Init_DMA(SH1106_128x64_Driver::spi_tx_dma());
+#endif
 
   display::Init();
 
@@ -140,51 +154,102 @@ void setup() {
     ui_mode = OC::UI_MODE_MENU;
   }
   OC::ui.set_screensaver_timeout(OC::calibration_data.screensaver_timeout);
+  for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+    OC::ADC::set_filter_preset(static_cast<ADC_CHANNEL>(channel), OC::calibration_data.adc_filter_preset(static_cast<ADC_CHANNEL>(channel)));
 
   // initialize apps
   OC::apps::Init(reset_settings);
 }
 
+/*  ---------    display  --------  */
+
+// The menu state as of the last redraw. Apps that implement DisplayState are
+// only redrawn if that, or the app, or UI events have changed since then.
+// NOTE Under VOR the bias popup isn't tracked, so everything is redrawn.
+struct MenuDrawState {
+  const OC::App *app;
+  uint32_t ui_events;
+  uint32_t display_state;
+};
+static MenuDrawState menu_draw_state = { nullptr, 0, 0 };
+
+static void invalidate_menu() {
+  menu_draw_state.app = nullptr;
+}
+
+static bool menu_changed() {
+#ifdef VOR
+  return true;
+#else
+  const OC::App *app = OC::apps::current_app;
+  return !app->DisplayState ||
+      menu_draw_state.app != app ||
+      menu_draw_state.ui_events != OC::ui.dispatched_events() ||
+      menu_draw_state.display_state != app->DisplayState();
+#endif
+}
+
+void FASTRUN redraw_display() {
+  if (OC::UI_MODE_MENU == ui_mode && !menu_changed()) {
+    ++OC::DEBUG::MENU_redraws_skipped;
+    MENU_REDRAW = 0;
+    LAST_REDRAW_TIME = millis();
+    return;
+  }
+
+  GRAPHICS_BEGIN_FRAME(false); // Don't busy wait
+    if (OC::UI_MODE_MENU == ui_mode) {
+      OC::App *app = OC::apps::current_app;
+      menu_draw_state.app = app;
+      menu_draw_state.ui_events = OC::ui.dispatched_events();
+      if (app->DisplayState)
+        menu_draw_state.display_state = app->DisplayState();
+
+      OC_DEBUG_RESET_CYCLES(OC::DEBUG::MENU_redraws, 512, OC::DEBUG::MENU_draw_cycles);
+      OC_DEBUG_PROFILE_SCOPE_HISTOGRAM(OC::DEBUG::MENU_draw_cycles, OC::DEBUG::MENU_draw_histogram,
+                                       app->id, OC::CORE::ticks);
+      app->DrawMenu();
+      ++OC::DEBUG::MENU_redraws;
+
+      #ifdef VOR
+        // JEJ:On app screens, show the bias popup, if necessary
+        VBiasManager *vbias_m = vbias_m->get();
+        vbias_m->DrawPopupPerhaps();
+      #endif
+
+    } else {
+      invalidate_menu();
+      OC::apps::current_app->DrawScreensaver();
+    }
+    MENU_REDRAW = 0;
+    LAST_REDRAW_TIME = millis();
+  GRAPHICS_END_FRAME();
+}
+
 /*  ---------    main loop  --------  */
 
 void FASTRUN loop() {
 
   OC::CORE::app_isr_enabled = true;
-  uint32_t menu_redraws = 0;
   while (true) {
 
     // don't change current_app while it's running
     if (OC::UI_MODE_APP_SETTINGS == ui_mode) {
       OC::ui.AppSettings();
       ui_mode = OC::UI_MODE_MENU;
+      invalidate_menu();
     }
 
     // Refresh display
-    if (MENU_REDRAW) {
-      GRAPHICS_BEGIN_FRAME(false); // Don't busy wait
-        if (OC::UI_MODE_MENU == ui_mode) {
-          OC_DEBUG_RESET_CYCLES(menu_redraws, 512, OC::DEBUG::MENU_draw_cycles);
-          OC_DEBUG_PROFILE_SCOPE(OC::DEBUG::MENU_draw_cycles);
-          OC::apps::current_app->DrawMenu();
-          ++menu_redraws;
-          
-          #ifdef VOR
-            // JEJ:On app screens, show the bias popup, if necessary
-            VBiasManager *vbias_m = vbias_m->get();
-            vbias_m->DrawPopupPerhaps();
-          #endif
-          
-        } else {
-          OC::apps::current_app->DrawScreensaver();
-        }
-        MENU_REDRAW = 0;
-        LAST_REDRAW_TIME = millis();
-      GRAPHICS_END_FRAME();
-    }
+    if (MENU_REDRAW)
+      redraw_display();
 
     // Run current app
     OC::apps::current_app->loop();
 
+    // Write pending settings (if any)
+    OC::apps::SaveStep();
+
     // UI events
     OC::UiMode mode = OC::ui.DispatchEvents(OC::apps::current_app);
 
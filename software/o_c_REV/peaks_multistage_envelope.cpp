@@ -40,6 +40,7 @@ void MultistageEnvelope::Init() {
   segment_ = num_segments_;
   phase_ = 0;
   phase_increment_ = 0;
+  segment_dirty_ = true;
   start_value_ = 0;
   value_ = 0;
   attack_reset_behaviour_ = RESET_BEHAVIOUR_NULL;
@@ -61,6 +62,14 @@ void MultistageEnvelope::Init() {
   state_mask_ = 0;
 }
 
+void MultistageEnvelope::UpdateSegment() {
+  const int16_t segment = segment_;
+  segment_increment_ = lut_env_increments[time_[segment] >> 8] >> time_multiplier_[segment];
+  segment_table_ = lookup_table_table[LUT_ENV_LINEAR + shape_[segment]];
+  segment_delta_ = level_[segment + 1] - start_value_;
+  segment_dirty_ = false;
+}
+
 uint16_t MultistageEnvelope::ProcessSingleSample(uint8_t control) {
 
   state_mask_ = 0;
@@ -99,10 +108,12 @@ uint16_t MultistageEnvelope::ProcessSingleSample(uint8_t control) {
       }
     }
     if (segment_ == 0 and amplitude_sampled_) sampled_amplitude_ = amplitude_ ;
+    segment_dirty_ = true;
   } else if ((control & CONTROL_GATE_FALLING) && sustain_point_ && attack_falling_gate_behaviour_ == FALLING_GATE_BEHAVIOUR_HONOUR) {
     start_value_ = value_;
     segment_ = sustain_point_;
     phase_ = 0;
+    segment_dirty_ = true;
   } else if (phase_ < phase_increment_) {
     start_value_ = level_[segment_ + 1];
     ++segment_;
@@ -115,20 +126,20 @@ uint16_t MultistageEnvelope::ProcessSingleSample(uint8_t control) {
     }
     if (segment_ == num_segments_)
       state_mask_ |= ENV_EOC;    
+    segment_dirty_ = true;
   }
   
   bool done = segment_ == num_segments_;
   bool sustained = sustain_point_ && segment_ == sustain_point_ &&
       control & CONTROL_GATE;
 
-  phase_increment_ =
-      sustained || done ? 0 : lut_env_increments[time_[segment_] >> 8] >> time_multiplier_[segment_];
+  if (segment_dirty_)
+    UpdateSegment();
+
+  phase_increment_ = sustained || done ? 0 : segment_increment_;
 
-  int32_t a = start_value_;
-  int32_t b = level_[segment_ + 1];
-  uint16_t t = Interpolate824(
-      lookup_table_table[LUT_ENV_LINEAR + shape_[segment_]], phase_);
-  value_ = a + ((b - a) * (t >> 1) >> 15);
+  uint16_t t = Interpolate824(segment_table_, phase_);
+  value_ = start_value_ + (segment_delta_ * (t >> 1) >> 15);
   phase_ += phase_increment_;
   if (amplitude_sampled_) {
     scaled_value_ = (value_ * sampled_amplitude_) >> 16;
@@ -92,19 +92,20 @@ class MultistageEnvelope {
       segment_ = 0;
       phase_ = 0;
       value_ = 0;
+      segment_dirty_ = true;
     }
   }
   
   inline void set_time(uint16_t segment, uint16_t time) {
-    time_[segment] = time;
+    update_parameter(time_[segment], time);
   }
 
   inline void set_time_multiplier(uint16_t segment, uint16_t time_multiplier) {
-    time_multiplier_[segment] = time_multiplier;
+    update_parameter(time_multiplier_[segment], time_multiplier);
   }
   
   inline void set_level(uint16_t segment, int16_t level) {
-    level_[segment] = level;
+    update_parameter(level_[segment], level);
   }
   
   inline void set_num_segments(uint16_t num_segments) {
@@ -124,22 +125,22 @@ class MultistageEnvelope {
     sustain_point_ = 2;
     sustain_index_ = 2;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = sustain;
-    level_[3] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], sustain);
+    update_parameter(level_[3], 0);
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = release;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], decay);
+    update_parameter(time_[2], release);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = decay_shape_;
-    shape_[2] = release_shape_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], decay_shape_);
+    update_parameter(shape_[2], release_shape_);
 
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = release_multiplier_;
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], decay_multiplier_);
+    update_parameter(time_multiplier_[2], release_multiplier_);
 
     loop_start_ = loop_end_ = 0;
   }
@@ -149,18 +150,18 @@ class MultistageEnvelope {
     sustain_point_ = 0;
     sustain_index_ = 0;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], 0);
 
-    time_[0] = attack;
-    time_[1] = decay;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], decay);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = decay_shape_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], decay_shape_);
 
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], decay_multiplier_);
     
     loop_start_ = loop_start;
     loop_end_ = loop_end;
@@ -177,22 +178,22 @@ class MultistageEnvelope {
     sustain_point_ = 0;
     sustain_index_ = 2;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = sustain;
-    level_[3] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], sustain);
+    update_parameter(level_[3], 0);
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = release;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], decay);
+    update_parameter(time_[2], release);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = decay_shape_;
-    shape_[2] = release_shape_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], decay_shape_);
+    update_parameter(shape_[2], release_shape_);
 
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = release_multiplier_;
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], decay_multiplier_);
+    update_parameter(time_multiplier_[2], release_multiplier_);
     
     loop_start_ = loop_start ;
     loop_end_ = loop_end ;
@@ -203,18 +204,18 @@ class MultistageEnvelope {
     sustain_point_ = 1;
     sustain_index_ = 0;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], 0);
 
-    time_[0] = attack;
-    time_[1] = release;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], release);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = release_shape_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], release_shape_);
 
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = release_multiplier_;
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], release_multiplier_);
     
     loop_start_ = loop_end_ = 0;
   }
@@ -228,26 +229,26 @@ class MultistageEnvelope {
     sustain_point_ = 2;
     sustain_index_ = 2;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = sustain;
-    level_[3] = 32767;
-    level_[4] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], sustain);
+    update_parameter(level_[3], 32767);
+    update_parameter(level_[4], 0);
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = attack;
-    time_[3] = release;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], decay);
+    update_parameter(time_[2], attack);
+    update_parameter(time_[3], release);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = decay_shape_;
-    shape_[2] = attack_shape_;
-    shape_[3] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = attack_multiplier_;
-    time_multiplier_[3] = release_multiplier_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], decay_shape_);
+    update_parameter(shape_[2], attack_shape_);
+    update_parameter(shape_[3], release_shape_);
+
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], decay_multiplier_);
+    update_parameter(time_multiplier_[2], attack_multiplier_);
+    update_parameter(time_multiplier_[3], release_multiplier_);
     
     loop_start_ = loop_end_ = 0;
   }
@@ -263,26 +264,26 @@ class MultistageEnvelope {
     sustain_point_ = 0;
     sustain_index_ = 2;
 
-    level_[0] = 0;
-    level_[1] = 32767;
-    level_[2] = sustain;
-    level_[3] = 32767;
-    level_[4] = 0;
+    update_parameter(level_[0], 0);
+    update_parameter(level_[1], 32767);
+    update_parameter(level_[2], sustain);
+    update_parameter(level_[3], 32767);
+    update_parameter(level_[4], 0);
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = attack;
-    time_[3] = release;
+    update_parameter(time_[0], attack);
+    update_parameter(time_[1], decay);
+    update_parameter(time_[2], attack);
+    update_parameter(time_[3], release);
     
-    shape_[0] = attack_shape_;
-    shape_[1] = decay_shape_;
-    shape_[2] = attack_shape_;
-    shape_[3] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = attack_multiplier_;
-    time_multiplier_[3] = release_multiplier_;
+    update_parameter(shape_[0], attack_shape_);
+    update_parameter(shape_[1], decay_shape_);
+    update_parameter(shape_[2], attack_shape_);
+    update_parameter(shape_[3], release_shape_);
+
+    update_parameter(time_multiplier_[0], attack_multiplier_);
+    update_parameter(time_multiplier_[1], decay_multiplier_);
+    update_parameter(time_multiplier_[2], attack_multiplier_);
+    update_parameter(time_multiplier_[3], release_multiplier_);
    
     loop_start_ = loop_start;
     loop_end_ = loop_end;
@@ -305,6 +306,7 @@ class MultistageEnvelope {
       segment_ = 0;
       phase_ = 0;
       value_ = 0;
+      segment_dirty_ = true;
     }
   }
 
@@ -370,6 +372,17 @@ class MultistageEnvelope {
   uint16_t RenderFastPreview(int16_t *values) const;
 
  private:
+  void UpdateSegment();
+
+  // The values cached for the current segment depend on level_, time_,
+  // time_multiplier_ and shape_, so they're only invalidated by changes
+  template <typename T, typename V>
+  inline void update_parameter(T &parameter, V value) {
+    const T t = static_cast<T>(value);
+    segment_dirty_ |= parameter != t;
+    parameter = t;
+  }
+
   int16_t level_[kMaxNumSegments];
   uint16_t time_[kMaxNumSegments];
   uint16_t time_multiplier_[kMaxNumSegments];
@@ -381,6 +394,13 @@ class MultistageEnvelope {
 
   uint32_t phase_;
   uint32_t phase_increment_;
+
+  // Values for the current segment; recalculated when the segment (re)starts
+  // or its parameters change
+  bool segment_dirty_;
+  uint32_t segment_increment_;
+  const uint16_t *segment_table_;
+  int32_t segment_delta_;
   
   uint16_t num_segments_;
   uint16_t sustain_point_;
@@ -32,6 +32,13 @@
 #ifdef DMA_PAGE_TRANSFER
 #include <DMAChannel.h>
 static DMAChannel page_dma;
+
+/*static*/
+DMAChannel &SH1106_128x64_Driver::spi_tx_dma() {
+  return page_dma;
+}
+#elif defined(OC_DAC_DMA)
+#error "OC_DAC_DMA shares the page DMA channel"
 #endif
 #ifndef SPI_SR_RXCTR
 #define SPI_SR_RXCTR 0XF0
@@ -171,6 +178,10 @@ void SH1106_128x64_Driver::SendPage(uint_fast8_t index, const uint8_t *data) {
   SPI0_SR = 0xFF0F0000;
   SPI0_RSER = SPI_RSER_RFDF_RE | SPI_RSER_RFDF_DIRS | SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
 
+#ifdef OC_DAC_DMA
+  // The DAC transfer uses the same channel with a different TCD
+  page_dma.destination((volatile uint8_t&)SPI0_PUSHR);
+#endif
   page_dma.sourceBuffer(data, kPageSize);
   page_dma.enable(); // go
 #else
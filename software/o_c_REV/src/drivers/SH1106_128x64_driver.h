@@ -26,6 +26,8 @@
 #include <stdint.h>
 #include <string.h>
 
+class DMAChannel;
+
 struct SH1106_128x64_Driver {
   static constexpr size_t kFrameSize = 128 * 64 / 8;
   static constexpr size_t kNumPages = 8;
@@ -38,6 +40,11 @@ struct SH1106_128x64_Driver {
   static void SendPage(uint_fast8_t index, const uint8_t *data);
   static void SPI_send(void *bufr, size_t n);
 
+  // The DMA channel triggered by SPI0 TX. Only one channel may use a trigger
+  // source, so other transfers on the SPI (\sa OC::DAC::Init_DMA) share it
+  // and set up the whole TCD for each transfer.
+  static DMAChannel &spi_tx_dma();
+
   // SH1106 ram is 132x64, so it needs an offset to center data in display.
   // However at least one display (mine) uses offset 0 so it's minimally
   // configurable
@@ -31,7 +31,7 @@
 
 namespace display {
 
-extern FrameBuffer<SH1106_128x64_Driver::kFrameSize, 2> frame_buffer;
+extern FrameBuffer<SH1106_128x64_Driver::kFrameSize, 2, SH1106_128x64_Driver::kPageSize> frame_buffer;
 extern PagedDisplayDriver<SH1106_128x64_Driver> driver;
 
 void Init();
@@ -49,7 +49,7 @@ static inline void Update() {
     driver.Update();
   } else {
     if (frame_buffer.readable())
-      driver.Begin(frame_buffer.readable_frame());
+      driver.Begin(frame_buffer.readable_frame(), frame_buffer.readable_dirty_pages());
   }
 }
 
@@ -13,20 +13,44 @@
 // but allows a new frame to be written while the old one is being
 // transferred.
 // See https://gist.github.com/patrickdowling/0029f58fb20e63d7db9d
+//
+// Frames are split into pages of page_size bytes. When a frame is written,
+// it is compared to the previous frame to find the pages that changed; since
+// frames are read in order, only those need to be sent to the display. If
+// nothing changed, the frame is dropped instead of being made readable.
 
-template <size_t frame_size, size_t frames>
+template <size_t frame_size, size_t frames, size_t page_size = frame_size>
 class FrameBuffer {
 public:
 
   static const size_t kFrameSize = frame_size;
+  static const size_t kPageSize = page_size;
+  static const size_t kNumPages = frame_size / page_size;
+  static const uint32_t kAllPages = 0xffffffff >> (32 - kNumPages);
+
+  static_assert(kNumPages * page_size == frame_size, "Frame size must be multiple of page size");
+  static_assert(kNumPages <= 32, "Too many pages for dirty mask");
 
   FrameBuffer() { }
 
   void Init() {
     memset(frame_memory_, 0, sizeof(frame_memory_));
-    for (size_t f = 0; f < frames; ++f)
+    for (size_t f = 0; f < frames; ++f) {
       frame_buffers_[f] = frame_memory_ + kFrameSize * f;
+      dirty_pages_[f] = kAllPages;
+    }
     write_ptr_ = read_ptr_ = 0;
+    invalidated_ = true;
+  }
+
+  // Force the next written frame to have all pages marked as dirty
+  void Invalidate() {
+    invalidated_ = true;
+  }
+
+  // @return mask of pages in readable frame that changed from previous frame
+  uint32_t readable_dirty_pages() const {
+    return dirty_pages_[read_ptr_ % frames];
   }
 
   size_t writeable() const {
@@ -52,6 +76,21 @@ public:
   }
 
   void written() {
+    size_t index = write_ptr_ % frames;
+    uint32_t dirty_pages = kAllPages;
+    if (!invalidated_) {
+      const uint8_t *frame = frame_buffers_[index];
+      const uint8_t *prev = frame_buffers_[(write_ptr_ + frames - 1) % frames];
+      dirty_pages = 0;
+      for (size_t page = 0; page < kNumPages; ++page) {
+        if (memcmp(frame + page * page_size, prev + page * page_size, page_size))
+          dirty_pages |= (0x1 << page);
+      }
+    }
+    invalidated_ = false;
+    if (!dirty_pages)
+      return;
+    dirty_pages_[index] = dirty_pages;
     ++write_ptr_;
   }
 
@@ -59,6 +98,8 @@ private:
 
   uint8_t frame_memory_[kFrameSize * frames] __attribute__ ((aligned (4)));
   uint8_t *frame_buffers_[frames];
+  uint32_t dirty_pages_[frames];
+  volatile bool invalidated_;
 
   volatile size_t write_ptr_;
   volatile size_t read_ptr_;
@@ -7,6 +7,7 @@
 // In theory parts of the transfer may be done via DMA and the page memory
 // will have to be valid until that completes, so the ::Flush call is used
 // to determine if cleanup is necessary.
+// Only pages set in the dirty mask are sent, the others are skipped.
 template <typename display_driver>
 class PagedDisplayDriver {
 public:
@@ -19,20 +20,20 @@ public:
 
     current_page_index_ = 0;
     current_page_data_ = NULL;
+    dirty_pages_ = 0;
   }
 
-  void Begin(const uint8_t *frame) {
+  void Begin(const uint8_t *frame, uint32_t dirty_pages) {
     current_page_data_ = frame;
-    current_page_index_ = 0;
+    dirty_pages_ = dirty_pages;
+    current_page_index_ = next_dirty_page(0);
   }
 
   void Update() {
     uint_fast8_t page = current_page_index_;
     if (page < display_driver::kNumPages) {
-      const uint8_t *data = current_page_data_;
-      display_driver::SendPage(page, data);
-      current_page_index_ = page + 1;
-      current_page_data_ = data + display_driver::kPageSize;
+      display_driver::SendPage(page, current_page_data_ + page * display_driver::kPageSize);
+      current_page_index_ = next_dirty_page(page + 1);
     }
   }
 
@@ -54,6 +55,14 @@ public:
 private:
   uint_fast8_t current_page_index_;
   const uint8_t *current_page_data_;
+  uint32_t dirty_pages_;
+
+  // @return index of next dirty page from page, or kNumPages if none
+  uint_fast8_t next_dirty_page(uint_fast8_t page) const {
+    while (page < display_driver::kNumPages && !(dirty_pages_ & (0x1 << page)))
+      ++page;
+    return page;
+  }
 
   DISALLOW_COPY_AND_ASSIGN(PagedDisplayDriver);
 };
@@ -45,7 +45,6 @@ const uint8_t test_bitmap[8] = {
 // - Bench templated draw_pixel_row (inlined versions) vs. function pointers
 // - Offer specialized functions w/o clipping or specific draw mode?
 // - Remainder masks as LUT or switch
-// - 32bit ops? Should be possible along x-axis (use SIMD instructions?) but not y (page stride)
 // - Clipping for x, y < 0
 // - Support 16 bit text characters?
 // - Kerning/BBX etc.
@@ -94,6 +93,40 @@ inline void draw_pixel_row(uint8_t *dst, weegfx::coord_t count, const uint8_t *s
   }
 }
 
+// 32-bit version of draw_pixel_row for spans along the x-axis, which is
+// possible since the pixels in a page row are consecutive bytes. Short spans
+// aren't worth the alignment overhead.
+typedef uint32_t __attribute__((__may_alias__)) pixel_word_t;
+
+template <weegfx::DRAW_MODE draw_mode>
+inline void draw_pixel_span(uint8_t *dst, weegfx::coord_t count, uint8_t mask) __attribute__((always_inline));
+
+template <weegfx::DRAW_MODE draw_mode>
+inline void draw_pixel_span(uint8_t *dst, weegfx::coord_t count, uint8_t mask) {
+  if (count >= 8) {
+    while (reinterpret_cast<uintptr_t>(dst) & 0x3) {
+      draw_pixel_row<draw_mode>(dst++, 1, mask);
+      --count;
+    }
+
+    const uint32_t mask32 = mask * 0x01010101U;
+    pixel_word_t *dst32 = reinterpret_cast<pixel_word_t *>(dst);
+    weegfx::coord_t words = count >> 2;
+    while (words--) {
+      switch (draw_mode) {
+        case weegfx::DRAW_NORMAL: *dst32++ |= mask32; break;
+        case weegfx::DRAW_INVERSE: *dst32++ ^= mask32; break;
+        case weegfx::DRAW_OVERWRITE: *dst32++ = mask32; break;
+        case weegfx::DRAW_CLEAR: *dst32++ &= ~mask32; break;
+        default: break;
+      }
+    }
+    dst = reinterpret_cast<uint8_t *>(dst32);
+    count &= 0x3;
+  }
+  draw_pixel_row<draw_mode>(dst, count, mask);
+}
+
 // It's tempting to check if the pixel is != 0, but first measurement shows it
 // actually makes things worse...
 #define SETPIXELS_H(start, count, value) \
@@ -140,19 +173,19 @@ inline void draw_rect(uint8_t *buf, weegfx::coord_t y, weegfx::coord_t w, weegfx
       h -= remainder;
     }
 
-    draw_pixel_row<draw_mode>(buf, w, mask);
+    draw_pixel_span<draw_mode>(buf, w, mask);
     buf += Graphics::kWidth;
   }
 
   remainder = h & 0x7;
   h >>= 3;
   while (h--) {
-    draw_pixel_row<draw_mode>(buf, w, 0xff);
+    draw_pixel_span<draw_mode>(buf, w, 0xff);
     buf += Graphics::kWidth;
   }
 
   if (remainder) {
-    draw_pixel_row<draw_mode>(buf, w, ~(0xff << remainder));
+    draw_pixel_span<draw_mode>(buf, w, ~(0xff << remainder));
   }
 }
 
@@ -191,7 +224,7 @@ void Graphics::drawHLine(coord_t x, coord_t y, coord_t w) {
   CLIPY(y, h);
   uint8_t *start = get_frame_ptr(x, y);
 
-  draw_pixel_row<DRAW_NORMAL>(start, w, 0x1 << (y & 0x7));
+  draw_pixel_span<DRAW_NORMAL>(start, w, 0x1 << (y & 0x7));
 }
 
 void Graphics::drawHLineDots(coord_t x, coord_t y, coord_t w) {
@@ -389,10 +422,60 @@ static inline weegfx::font_glyph get_char_glyph(char c) {
   return ssd1306xled_font6x8 + Graphics::kFixedFontW * (c - 32);
 }
 
-// OPTIMIZE When printing strings, all chars will have the same y/remainder
-// This will probably only save a few cycles, if any. Also the clipping can
-// be made optional (template?)
+// Fast path for glyphs that don't need clipping.
+// The glyph is either byte-aligned in a single page row, or split across two
+// page rows with shift = y & 0x7.
+static inline bool glyph_visible(char c, weegfx::coord_t x, weegfx::coord_t y) __attribute__((always_inline));
+static inline bool glyph_visible(char c, weegfx::coord_t x, weegfx::coord_t y) {
+  // draw_char clips using c + w, so those chars take the slow path too
+  return c > 32 && c <= Graphics::kWidth - Graphics::kFixedFontW &&
+      x >= 0 && x <= Graphics::kWidth - Graphics::kFixedFontW &&
+      y >= 0 && y <= Graphics::kHeight - Graphics::kFixedFontH;
+}
+
+static inline void blit_glyph(uint8_t *dst, weegfx::font_glyph glyph, weegfx::coord_t shift) __attribute__((always_inline));
+static inline void blit_glyph(uint8_t *dst, weegfx::font_glyph glyph, weegfx::coord_t shift) {
+  if (!shift) {
+    for (weegfx::coord_t i = 0; i < Graphics::kFixedFontW; ++i)
+      dst[i] |= glyph[i];
+  } else {
+    uint8_t *next_row = dst + Graphics::kWidth;
+    for (weegfx::coord_t i = 0; i < Graphics::kFixedFontW; ++i) {
+      dst[i] |= glyph[i] << shift;
+      next_row[i] |= glyph[i] >> (8 - shift);
+    }
+  }
+}
+
+weegfx::coord_t Graphics::draw_string(const char *s, coord_t x, coord_t y) {
+  if (y < 0 || y > kHeight - kFixedFontH) {
+    while (*s) {
+      draw_char(*s++, x, y);
+      x += kFixedFontW;
+    }
+  } else {
+    // All chars are in the same page row(s), so only x needs checking
+    uint8_t *row = frame_ + ((y >> 3) << 7);
+    const coord_t shift = y & 0x7;
+    while (*s) {
+      char c = *s++;
+      if (glyph_visible(c, x, y))
+        blit_glyph(row + x, get_char_glyph(c), shift);
+      else
+        draw_char(c, x, y);
+      x += kFixedFontW;
+    }
+  }
+  return x;
+}
+
+// The clipping here can be made optional (template?)
 void Graphics::draw_char(char c, coord_t x, coord_t y) {
+  if (glyph_visible(c, x, y)) {
+    blit_glyph(get_frame_ptr(x, y), get_char_glyph(c), y & 0x7);
+    return;
+  }
+
   if (!c) c = '0';
   if (c <= 32 || c > 127)
     return;
@@ -489,11 +572,11 @@ void Graphics::print(uint16_t value, unsigned width) {
   print(str);
 }
 
-void Graphics::print(uint32_t value, size_t width) {
+void Graphics::print(uint32_t value, unsigned width) {
   char buf[24];
   char *str = itos<uint32_t, false>(value, buf, sizeof(buf));
   while (str > buf &&
-         (size_t)(str - buf) >= sizeof(buf) - width)
+         (unsigned)(str - buf) >= sizeof(buf) - width)
     *--str = ' ';
   print(str);
 }
@@ -534,16 +617,7 @@ void Graphics::pretty_print_right(int value) {
 }
 
 void Graphics::print(const char *s) {
-  coord_t x = text_x_;
-  coord_t y = text_y_;
-
-  // TODO Track position, only clip when necessary or early-out?
-  while (*s) {
-    draw_char(*s++, x, y);
-    x += kFixedFontW;
-  }
-
-  text_x_ = x;
+  text_x_ = draw_string(s, text_x_, text_y_);
 }
 
 void Graphics::print_right(const char *s) {
@@ -568,8 +642,5 @@ void Graphics::printf(const char *fmt, ...) {
 }
 
 void Graphics::drawStr(coord_t x, coord_t y, const char *s) {
-  while (*s) {
-    draw_char(*s++, x, y);
-    x += kFixedFontW;
-  }
+  draw_string(s, x, y);
 }
@@ -111,6 +111,8 @@ private:
 
   inline uint8_t *get_frame_ptr(const coord_t x, const coord_t y) __attribute__((always_inline));
   void draw_char(char c, coord_t x, coord_t y);
+  // @return x after last char
+  coord_t draw_string(const char *s, coord_t x, coord_t y);
 };
 
 inline void Graphics::setPixel(coord_t x, coord_t y) {
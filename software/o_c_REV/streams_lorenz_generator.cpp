@@ -35,37 +35,18 @@
 
 #include "streams_lorenz_generator.h"
 
+#include <algorithm>
+
 #include "streams_resources.h"
 
 namespace streams {
 
 // using namespace stmlib;
 
-const int64_t sigma = 10.0 * (1 << 24);
-//const int64_t rho = 28.0 * (1 << 24);
-const int64_t beta = 8.0 / 3.0 * (1 << 24);
-
-// Rossler constants
-const int64_t a = 0.1 * (1 << 24);
-const int64_t b = 0.1 * (1 << 24);
-// const int64_t c = 13.0 * (1 << 24);
-
 void LorenzGenerator::Init(uint8_t index) {
-  if (index) {
-    Lx2_ = 0.1 * (1 << 24);
-    Ly2_ = 0;
-    Lz2_ = 0;
-    Rx2_ = 0.1 * (1 << 24);
-    Ry2_ = 0;
-    Rz2_ = 0;
-  } else {
-    Lx1_ = 0.1 * (1 << 24);
-    Ly1_ = 0;
-    Lz1_ = 0;
-    Rx1_ = 0.1 * (1 << 24);
-    Ry1_ = 0;
-    Rz1_ = 0;
-  }
+  index = index ? 1 : 0;
+  lorenz_.Reset(index);
+  rossler_.Reset(index);
 }
 
 void LorenzGenerator::Process(
@@ -75,62 +56,91 @@ void LorenzGenerator::Process(
     bool reset2,
     uint8_t freq_range1,
     uint8_t freq_range2) {
-  int32_t rate1 =  (freq1 >> 8);
-  if (rate1 < 0) rate1 = 0;
-  if (rate1 > 255) rate1 = 255;
-  int32_t rate2 = (freq2 >> 8);
-  if (rate2 < 0) rate2 = 0;
-  if (rate2 > 255) rate2 = 255;
-
   if (reset1) Init(0) ;
   if (reset2) Init(1) ; 
 
-  // yes, yes, these should be functions...
-  // Lorenz 1
-  int64_t Ldt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> (5 - freq_range1)); // was 5
-  int32_t Lx1 = Lx1_ + (Ldt1 * ((sigma * (Ly1_ - Lx1_)) >> 24) >> 24);
-  int32_t Ly1 = Ly1_ + (Ldt1 * ((Lx1_ * (rho1_ - Lz1_) >> 24) - Ly1_) >> 24);
-  int32_t Lz1 = Lz1_ + (Ldt1 * ((Lx1_ * int64_t(Ly1_) >> 24) - (beta * Lz1_ >> 24)) >> 24); 
-  Lx1_ = Lx1;
-  Ly1_ = Ly1;
-  Lz1_ = Lz1; 
-  int32_t Lz1_scaled = ((Lz1 * 3) >> 16);
-  int32_t Lx1_scaled = ((Lx1 * 3) >> 16) + 32769;
-  int32_t Ly1_scaled = ((Ly1 * 3) >> 16) + 32769;
-  // Rossler 1
-  int64_t Rdt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> 0);
-  int32_t Rx1 = Rx1_ + ((Rdt1 * (-Ry1_ - Rz1_ )) >> 24);
-  int32_t Ry1 = Ry1_ + ((Rdt1 * (Rx1_ + ((a * Ry1_) >> 24))) >> 24);
-  int32_t Rz1 = Rz1_ + ((Rdt1 * (b + ((Rz1_ * (Rx1_ - c1_)) >> 24)))  >> 24);
-  Rx1_ = Rx1;
-  Ry1_ = Ry1;
-  Rz1_ = Rz1; 
-  int32_t Rz1_scaled = (Rz1 >> 14);
-  int32_t Rx1_scaled = (Rx1 >> 14) + 32769;
-  int32_t Ry1_scaled = (Ry1 >> 14) + 32769;
-
-  // Lorenz 2
-  int64_t Ldt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> (5 - freq_range2)); // was 5
-  int32_t Lx2 = Lx2_ + (Ldt2 * ((sigma * (Ly2_ - Lx2_)) >> 24) >> 24);
-  int32_t Ly2 = Ly2_ + (Ldt2 * ((Lx2_ * (rho2_ - Lz2_) >> 24) - Ly2_) >> 24);
-  int32_t Lz2 = Lz2_ + (Ldt2 * ((Lx2_ * int64_t(Ly2_) >> 24) - (beta * Lz2_ >> 24)) >> 24); 
-  Lx2_ = Lx2;
-  Ly2_ = Ly2;
-  Lz2_ = Lz2; 
-  int32_t Lz2_scaled = ((Lz2 * 3) >> 16);
-  int32_t Lx2_scaled = ((Lx2 * 3) >> 16) + 32769;
-  int32_t Ly2_scaled = ((Ly2 * 3) >> 16) + 32769;
-  // Rossler 2
-  int64_t Rdt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> 0);
-  int32_t Rx2 = Rx2_ + ((Rdt2 * (-Ry2_ - Rz2_ )) >> 24);
-  int32_t Ry2 = Ry2_ + ((Rdt2 * (Rx2_ + ((a * Ry2_) >> 24))) >> 24);
-  int32_t Rz2 = Rz2_ + ((Rdt2 * (b + ((Rz2_ * (Rx2_ - c2_)) >> 24)))  >> 24);
-  Rx2_ = Rx2;
-  Ry2_ = Ry2;
-  Rz2_ = Rz2; 
-  int32_t Rz2_scaled = (Rz2 >> 14);
-  int32_t Rx2_scaled = (Rx2 >> 14) + 32769;
-  int32_t Ry2_scaled = (Ry2 >> 14) + 32769;
+  // A reset starts a new control period straight away, gliding from the
+  // current output
+  if (reset1 || reset2)
+    control_phase_ = 0;
+
+  const uint8_t shift = control_rate_;
+  if (!control_phase_) {
+    int32_t rate1 =  (freq1 >> 8);
+    if (rate1 < 0) rate1 = 0;
+    if (rate1 > 255) rate1 = 255;
+    int32_t rate2 = (freq2 >> 8);
+    if (rate2 < 0) rate2 = 0;
+    if (rate2 > 255) rate2 = 255;
+
+    // Steps per tick, scaled up to the control period
+    int64_t Ldt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> (5 - freq_range1)); // was 5
+    int64_t Rdt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> 0);
+    int64_t Ldt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> (5 - freq_range2)); // was 5
+    int64_t Rdt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> 0);
+    lorenz_.set_dt(0, Ldt1 << shift);
+    rossler_.set_dt(0, Rdt1 << shift);
+    lorenz_.set_dt(1, Ldt2 << shift);
+    rossler_.set_dt(1, Rdt2 << shift);
+    if (!shift) {
+      lorenz_.Step(integrator_);
+      rossler_.Step(integrator_);
+      GetState(state_);
+      Render(state_, dac_code_);
+      return;
+    }
+
+    // Glide from the current state to the one integrated during the last
+    // period, and start integrating the next step
+    GetState(state_target_);
+    for (uint8_t i = 0; i < STATE_LAST; ++i)
+      state_increment_[i] = (static_cast<int64_t>(state_target_[i]) - state_[i]) >> shift;
+    lorenz_.BeginStep();
+    rossler_.BeginStep();
+    const size_t parts = lorenz_.parts() + rossler_.parts();
+    control_parts_ = (parts + (1 << shift) - 1) >> shift;
+  }
+
+  for (uint8_t part = control_parts_; part; --part) {
+    if (!lorenz_.StepPart(integrator_) && !rossler_.StepPart(integrator_))
+      break;
+  }
+
+  ++control_phase_;
+  if (control_phase_ >> shift) {
+    control_phase_ = 0;
+    std::copy(state_target_, state_target_ + STATE_LAST, state_);
+  } else {
+    for (uint8_t i = 0; i < STATE_LAST; ++i)
+      state_[i] += state_increment_[i];
+  }
+  Render(state_, dac_code_);
+}
+
+void LorenzGenerator::GetState(int32_t *state) const {
+  for (uint8_t i = 0; i < 2; ++i) {
+    state[STATE_LX1 + 3 * i] = lorenz_.x(i);
+    state[STATE_LY1 + 3 * i] = lorenz_.y(i);
+    state[STATE_LZ1 + 3 * i] = lorenz_.z(i);
+    state[STATE_RX1 + 3 * i] = rossler_.x(i);
+    state[STATE_RY1 + 3 * i] = rossler_.y(i);
+    state[STATE_RZ1 + 3 * i] = rossler_.z(i);
+  }
+}
+
+void LorenzGenerator::Render(const int32_t *state, uint16_t *codes) const {
+  int32_t Lz1_scaled = ((state[STATE_LZ1] * 3) >> 16);
+  int32_t Lx1_scaled = ((state[STATE_LX1] * 3) >> 16) + 32769;
+  int32_t Ly1_scaled = ((state[STATE_LY1] * 3) >> 16) + 32769;
+  int32_t Rz1_scaled = (state[STATE_RZ1] >> 14);
+  int32_t Rx1_scaled = (state[STATE_RX1] >> 14) + 32769;
+  int32_t Ry1_scaled = (state[STATE_RY1] >> 14) + 32769;
+  int32_t Lz2_scaled = ((state[STATE_LZ2] * 3) >> 16);
+  int32_t Lx2_scaled = ((state[STATE_LX2] * 3) >> 16) + 32769;
+  int32_t Ly2_scaled = ((state[STATE_LY2] * 3) >> 16) + 32769;
+  int32_t Rz2_scaled = (state[STATE_RZ2] >> 14);
+  int32_t Rx2_scaled = (state[STATE_RX2] >> 14) + 32769;
+  int32_t Ry2_scaled = (state[STATE_RY2] >> 14) + 32769;
 
   uint8_t out_channel ;
   
@@ -156,70 +166,70 @@ void LorenzGenerator::Process(
  
     switch (out_channel) {
       case LORENZ_OUTPUT_X1:
-        dac_code_[i] = Lx1_scaled;
+        codes[i] = Lx1_scaled;
         break;
       case LORENZ_OUTPUT_Y1:
-        dac_code_[i] = Ly1_scaled;
+        codes[i] = Ly1_scaled;
         break;
       case LORENZ_OUTPUT_Z1:
-        dac_code_[i] = Lz1_scaled;
+        codes[i] = Lz1_scaled;
         break;
       case LORENZ_OUTPUT_X2:
-        dac_code_[i] = Lx2_scaled;
+        codes[i] = Lx2_scaled;
         break;
       case LORENZ_OUTPUT_Y2:
-        dac_code_[i] = Ly2_scaled;
+        codes[i] = Ly2_scaled;
         break;
       case LORENZ_OUTPUT_Z2:
-        dac_code_[i] = Lz2_scaled;
+        codes[i] = Lz2_scaled;
         break;
       case ROSSLER_OUTPUT_X1:
-        dac_code_[i] = Rx1_scaled;
+        codes[i] = Rx1_scaled;
         break;
       case ROSSLER_OUTPUT_Y1:
-        dac_code_[i] = Ry1_scaled;
+        codes[i] = Ry1_scaled;
         break;
       case ROSSLER_OUTPUT_Z1:
-        dac_code_[i] = Rz1_scaled;
+        codes[i] = Rz1_scaled;
         break;
       case ROSSLER_OUTPUT_X2:
-        dac_code_[i] = Rx2_scaled;
+        codes[i] = Rx2_scaled;
         break;
       case ROSSLER_OUTPUT_Y2:
-        dac_code_[i] = Ry2_scaled;
+        codes[i] = Ry2_scaled;
         break;
       case ROSSLER_OUTPUT_Z2:
-        dac_code_[i] = Rz2_scaled;
+        codes[i] = Rz2_scaled;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_RX1:
-        dac_code_[i] = (Lx1_scaled + Rx1_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Rx1_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_RZ1:
-        dac_code_[i] = (Lx1_scaled + Rz1_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Rz1_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_LY2:
-        dac_code_[i] = (Lx1_scaled + Ly2_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Ly2_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_LZ2:
-        dac_code_[i] = (Lx1_scaled + Lz2_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Lz2_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_RX2:
-        dac_code_[i] = (Lx1_scaled + Rx2_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Rx2_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_PLUS_RZ2:
-        dac_code_[i] = (Lx1_scaled + Rz2_scaled) >> 1;
+        codes[i] = (Lx1_scaled + Rz2_scaled) >> 1;
         break;
       case LORENZ_OUTPUT_LX1_XOR_LY1:
-        dac_code_[i] = Lx1_scaled ^ Ly1_scaled ;
+        codes[i] = Lx1_scaled ^ Ly1_scaled ;
         break;
       case LORENZ_OUTPUT_LX1_XOR_LX2:
-        dac_code_[i] = Lx1_scaled ^ Lx2_scaled ;
+        codes[i] = Lx1_scaled ^ Lx2_scaled ;
         break;
       case LORENZ_OUTPUT_LX1_XOR_RX1:
-        dac_code_[i] = Lx1_scaled ^ Rx1_scaled ;
+        codes[i] = Lx1_scaled ^ Rx1_scaled ;
         break;
       case LORENZ_OUTPUT_LX1_XOR_RX2:
-        dac_code_[i] = Lx1_scaled ^ Rx2_scaled ;
+        codes[i] = Lx1_scaled ^ Rx2_scaled ;
         break;
        default:
         break;
@@ -36,6 +36,7 @@
 #define STREAMS_LORENZ_GENERATOR_H_
 
 #include "util/util_macros.h"
+#include "util/util_chaotic_oscillators.h"
 // #include "stmlib/stmlib.h"
 // #include "streams/meta_parameters.h"
 
@@ -69,6 +70,22 @@ enum ELorenzOutputMap {
   LORENZ_OUTPUT_LAST,
 };
 
+enum ELorenzIntegrator {
+  LORENZ_INTEGRATOR_EULER = util::CHAOTIC_INTEGRATOR_EULER,
+  LORENZ_INTEGRATOR_HEUN = util::CHAOTIC_INTEGRATOR_HEUN,
+  LORENZ_INTEGRATOR_LAST,
+};
+
+// Per-tick updates are the default. With a control rate shift > 0, the
+// attractors advance in steps of (1 << shift) ticks, and their state is
+// linearly interpolated and rendered on each tick in between. Each step is
+// integrated during the preceding control period, split into several parts
+// that are spread evenly over its ticks; this keeps the integration stable
+// at high rates and the time per tick even, but delays the outputs by one
+// control period. The time per tick is only even if Process is called once
+// per tick.
+const uint8_t kMaxControlRateShift = 6;
+
 class LorenzGenerator {
  public:
   LorenzGenerator() { }
@@ -84,17 +101,22 @@ class LorenzGenerator {
 
  
   inline void set_rho1(int16_t rho) {
-    // rho1_ = ((double)(rho) * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    // c1_ = (double)(rho + (6 << 3)) * (1 << 13) ; // was 13
-    rho1_ = (rho * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    c1_ = (rho + (6 << 3)) * (1 << 13) ; // was 13
+    lorenz_.set_parameter(0, (rho * (1 << 13)) + 24.0 * (1 << 24)) ; // was 12
+    rossler_.set_parameter(0, (rho + (6 << 3)) * (1 << 13)) ; // was 13
   }
 
   inline void set_rho2(int16_t rho) {
-    // rho2_ = ((double)(rho) * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    // c2_ = (double)(rho + (6 << 3)) * (1 << 13) ; // was 13
-    rho2_ = (rho * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    c2_ = (rho + (6 << 3)) * (1 << 13) ; // was 13
+    lorenz_.set_parameter(1, (rho * (1 << 13)) + 24.0 * (1 << 24)) ; // was 12
+    rossler_.set_parameter(1, (rho + (6 << 3)) * (1 << 13)) ; // was 13
+  }
+
+  inline void set_control_rate(uint8_t shift) {
+    control_rate_ = shift > kMaxControlRateShift ? kMaxControlRateShift : shift;
+    control_phase_ = 0;
+  }
+
+  inline void set_integrator(uint8_t integrator) {
+    integrator_ = integrator;
   }
 
   inline void set_out_a(uint8_t out_a) {
@@ -118,17 +140,34 @@ class LorenzGenerator {
   }
 
  private:
-  int32_t Lx1_, Ly1_, Lz1_;
-  int32_t Rx1_, Ry1_, Rz1_;
-  int32_t Lx2_, Ly2_, Lz2_;
-  int32_t Rx2_, Ry2_, Rz2_;
+  // Rendered attractor state: x, y, z of both Lorenz, then both Rossler systems
+  enum {
+    STATE_LX1, STATE_LY1, STATE_LZ1,
+    STATE_LX2, STATE_LY2, STATE_LZ2,
+    STATE_RX1, STATE_RY1, STATE_RZ1,
+    STATE_RX2, STATE_RY2, STATE_RZ2,
+    STATE_LAST
+  };
 
-  uint8_t out_a_, out_b_, out_c_, out_d_ ;
+  void GetState(int32_t *state) const;
+  void Render(const int32_t *state, uint16_t *codes) const;
+
+  util::ChaoticOscillators<util::LorenzSystem, 2> lorenz_;
+  util::ChaoticOscillators<util::RosslerSystem, 2> rossler_;
 
-  int64_t sigma_, rho1_, rho2_, beta_, c1_,  c2_ ;
+  uint8_t out_a_, out_b_, out_c_, out_d_ ;
   
   // O+C
   uint16_t dac_code_[kNumChannels];
+
+  // Control rate
+  uint8_t control_rate_;
+  uint8_t control_phase_;
+  uint8_t integrator_;
+  uint8_t control_parts_;
+  int32_t state_[STATE_LAST];
+  int32_t state_increment_[STATE_LAST];
+  int32_t state_target_[STATE_LAST];
  
   uint8_t index_;
   
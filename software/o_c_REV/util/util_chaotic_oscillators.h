@@ -0,0 +1,199 @@
+#ifndef UTIL_CHAOTIC_OSCILLATORS_H_
+#define UTIL_CHAOTIC_OSCILLATORS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace util {
+
+// Multiple instances of a chaotic system, stored as struct-of-arrays so they
+// are all stepped in one loop. The system is a policy class; x, y, z and the
+// step sizes are Q24, as is the system parameter.
+//
+// The continuous systems (Lorenz, Rossler) integrate with Euler or Heun's
+// method; steps larger than System::kMaxDt are split. Discrete maps ignore
+// the step size and advance once per Step.
+//
+// A (large) step of continuous systems can also be spread over several calls
+// with BeginStep and StepPart, e.g. to keep the time per call even.
+
+enum ChaoticIntegrator {
+  CHAOTIC_INTEGRATOR_EULER,
+  CHAOTIC_INTEGRATOR_HEUN,
+  CHAOTIC_INTEGRATOR_LAST,
+};
+
+// Derivatives and integration for continuous systems
+template <typename System>
+struct ContinuousSystem {
+  static inline void Step(int32_t &x, int32_t &y, int32_t &z, int64_t p, int64_t dt, uint8_t integrator) {
+    while (dt > System::kMaxDt) {
+      Integrate(x, y, z, p, System::kMaxDt, integrator);
+      dt -= System::kMaxDt;
+    }
+    Integrate(x, y, z, p, dt, integrator);
+  }
+
+  // Number of integrations per Step; steps are assumed to fit 32 bits, which
+  // avoids a 64-bit division
+  static inline size_t Parts(int64_t dt) {
+    return dt > System::kMaxDt
+        ? static_cast<uint32_t>(dt + System::kMaxDt - 1) / static_cast<uint32_t>(System::kMaxDt)
+        : 1;
+  }
+
+  static inline void Integrate(int32_t &x, int32_t &y, int32_t &z, int64_t p, int64_t dt, uint8_t integrator) {
+    int64_t d[3];
+    System::Derivatives(x, y, z, p, d);
+    if (CHAOTIC_INTEGRATOR_HEUN == integrator) {
+      // Average of the slopes at the start and at the Euler estimate
+      int64_t d2[3];
+      System::Derivatives(x + (dt * d[0] >> 24), y + (dt * d[1] >> 24), z + (dt * d[2] >> 24), p, d2);
+      x += dt * (d[0] + d2[0]) >> 25;
+      y += dt * (d[1] + d2[1]) >> 25;
+      z += dt * (d[2] + d2[2]) >> 25;
+    } else {
+      x += dt * d[0] >> 24;
+      y += dt * d[1] >> 24;
+      z += dt * d[2] >> 24;
+    }
+  }
+};
+
+// Parameter is rho
+struct LorenzSystem : public ContinuousSystem<LorenzSystem> {
+  static constexpr int64_t kSigma = 10.0 * (1 << 24);
+  static constexpr int64_t kBeta = 8.0 / 3.0 * (1 << 24);
+  static constexpr int64_t kDefaultParameter = 28.0 * (1 << 24);
+  static constexpr int32_t kInitX = 0.1 * (1 << 24);
+  static constexpr int64_t kMaxDt = 0.02 * (1 << 24);
+
+  static inline void Derivatives(int32_t x, int32_t y, int32_t z, int64_t rho, int64_t *d) {
+    d[0] = (kSigma * (y - x)) >> 24;
+    d[1] = (x * (rho - z) >> 24) - y;
+    d[2] = (x * int64_t(y) >> 24) - (kBeta * z >> 24);
+  }
+};
+
+// Parameter is c
+struct RosslerSystem : public ContinuousSystem<RosslerSystem> {
+  static constexpr int64_t kA = 0.1 * (1 << 24);
+  static constexpr int64_t kB = 0.1 * (1 << 24);
+  static constexpr int64_t kDefaultParameter = 13.0 * (1 << 24);
+  static constexpr int32_t kInitX = 0.1 * (1 << 24);
+  static constexpr int64_t kMaxDt = 0.08 * (1 << 24);
+
+  static inline void Derivatives(int32_t x, int32_t y, int32_t z, int64_t c, int64_t *d) {
+    d[0] = -y - z;
+    d[1] = x + ((kA * y) >> 24);
+    d[2] = kB + ((z * (x - c)) >> 24);
+  }
+};
+
+// Parameter is r; same as util::LogisticMap, only x is used
+struct LogisticSystem {
+  static constexpr int64_t kONE = 1 << 24;
+  static constexpr int64_t kDefaultParameter = 3.6 * kONE;
+  static constexpr int32_t kInitX = 1 << 16;
+
+  static inline void Step(int32_t &x, int32_t &, int32_t &, int64_t r, int64_t, uint8_t) {
+    x = (r * ((x * (kONE - x)) >> 24)) >> 24;
+  }
+};
+
+template <typename System, size_t N>
+class ChaoticOscillators {
+public:
+  static constexpr size_t kNumInstances = N;
+
+  ChaoticOscillators() { }
+
+  void Init() {
+    for (size_t i = 0; i < N; ++i) {
+      Reset(i);
+      p_[i] = System::kDefaultParameter;
+      dt_[i] = 0;
+    }
+    part_ = N;
+  }
+
+  inline void Reset(size_t i) {
+    x_[i] = System::kInitX;
+    y_[i] = z_[i] = 0;
+  }
+
+  inline void set_x(size_t i, int32_t x) {
+    x_[i] = x;
+  }
+
+  inline void set_parameter(size_t i, int64_t p) {
+    p_[i] = p;
+  }
+
+  inline void set_dt(size_t i, int64_t dt) {
+    dt_[i] = dt;
+  }
+
+  // Advance all instances
+  inline void Step(uint8_t integrator) {
+    for (size_t i = 0; i < N; ++i)
+      System::Step(x_[i], y_[i], z_[i], p_[i], dt_[i], integrator);
+  }
+
+  // Start a step of all instances that is completed by calling StepPart;
+  // steps that weren't completed are abandoned.
+  inline void BeginStep() {
+    for (size_t i = 0; i < N; ++i)
+      remaining_dt_[i] = dt_[i];
+    part_ = 0;
+  }
+
+  // Number of StepPart calls to complete a step
+  inline size_t parts() const {
+    size_t parts = 0;
+    for (size_t i = 0; i < N; ++i)
+      parts += System::Parts(dt_[i]);
+    return parts;
+  }
+
+  // Single integration of at most System::kMaxDt, in the same order as Step
+  // so the result is identical.
+  // @return false if the step was already complete
+  inline bool StepPart(uint8_t integrator) {
+    if (part_ >= N)
+      return false;
+    int64_t dt = remaining_dt_[part_];
+    if (dt > System::kMaxDt)
+      dt = System::kMaxDt;
+    System::Integrate(x_[part_], y_[part_], z_[part_], p_[part_], dt, integrator);
+    remaining_dt_[part_] -= dt;
+    if (remaining_dt_[part_] <= 0)
+      ++part_;
+    return true;
+  }
+
+  inline int32_t x(size_t i) const {
+    return x_[i];
+  }
+
+  inline int32_t y(size_t i) const {
+    return y_[i];
+  }
+
+  inline int32_t z(size_t i) const {
+    return z_[i];
+  }
+
+private:
+  int32_t x_[N];
+  int32_t y_[N];
+  int32_t z_[N];
+  int64_t p_[N];
+  int64_t dt_[N];
+  int64_t remaining_dt_[N];
+  size_t part_;
+};
+
+}; // namespace util
+
+#endif // UTIL_CHAOTIC_OSCILLATORS_H_
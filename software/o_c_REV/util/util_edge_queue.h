@@ -0,0 +1,74 @@
+#ifndef UTIL_EDGE_QUEUE_H_
+#define UTIL_EDGE_QUEUE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "util_macros.h"
+
+namespace util {
+
+// Queue of edge timestamps between a pin ISR (producer) and the core ISR
+// (consumer). Same wrapping read/write heads as util::RingBuffer, but it's
+// safe for the producer to be interrupted by the consumer (and vice versa)
+// without locking: each side only writes its own head, and the write head is
+// only advanced once the timestamp is stored.
+//
+// If the queue is full, new edges are dropped and counted as overflows; the
+// older ones are more useful for period measurement anyway.
+//
+template <size_t size>
+class EdgeQueue {
+public:
+  static_assert(size && !(size & (size - 1)), "EdgeQueue size must be pow2");
+  static constexpr size_t kSize = size;
+
+  EdgeQueue() { }
+
+  void Init() {
+    write_ptr_ = read_ptr_ = 0;
+    overflows_ = 0;
+  }
+
+  inline size_t readable() const {
+    return write_ptr_ - read_ptr_;
+  }
+
+  // Producer side
+  inline bool Push(uint32_t timestamp) {
+    size_t write_ptr = write_ptr_;
+    if (write_ptr - read_ptr_ >= size) {
+      ++overflows_;
+      return false;
+    }
+    timestamps_[write_ptr & (size - 1)] = timestamp;
+    write_ptr_ = write_ptr + 1;
+    return true;
+  }
+
+  // Consumer side
+  inline bool Pop(uint32_t &timestamp) {
+    size_t read_ptr = read_ptr_;
+    if (read_ptr == write_ptr_)
+      return false;
+    timestamp = timestamps_[read_ptr & (size - 1)];
+    read_ptr_ = read_ptr + 1;
+    return true;
+  }
+
+  inline uint32_t overflows() const {
+    return overflows_;
+  }
+
+private:
+
+  volatile uint32_t timestamps_[size];
+  volatile size_t write_ptr_;
+  volatile size_t read_ptr_;
+  volatile uint32_t overflows_;
+
+  DISALLOW_COPY_AND_ASSIGN(EdgeQueue);
+};
+
+};
+
+#endif // UTIL_EDGE_QUEUE_H_
@@ -23,6 +23,8 @@
 #ifndef PAGESTORAGE_H_
 #define PAGESTORAGE_H_
 
+#include <stddef.h>
+#include <string.h>
 #include "util_misc.h"
 
 //#define DEBUG_STORAGE
@@ -56,13 +58,42 @@ enum EStorageMode {
  * an UPDATE method that furthere minimizes actual writes, but may be slower.
  *
  * The optional FASTSCAN parameter to can be used for force a scan of all pages
- * during ::load. If it is true, the scan stops at the first non-good page,
- * which is faster but might miss pages if a write is corrupted.
+ * during ::load. If it is true, the scan stops at the first page with a
+ * non-good header after a good one, which is faster but might miss pages if a
+ * write is corrupted. Only the headers are read while scanning, so ::load
+ * reads a single full page unless the newest one fails its checksum.
+ *
+ * Saving can also be spread out over several calls (::BeginSave, ::SaveStep)
+ * so the caller doesn't stall for the entire write. The data is copied when
+ * the save begins, so it may be modified while the save is in progress. Since
+ * each save goes to the next page, and the header is written last, an
+ * interrupted save leaves the previous page loadable -- as long as there are
+ * at least two pages.
+ *
+ * If JOURNAL_LENGTH is non-zero, that many bytes at the end of the storage
+ * are used as a journal: instead of writing a full page, a save appends a
+ * record with only the changed byte ranges. ::load replays the records for
+ * the newest page. Each record has the generation of the page it applies to,
+ * a sequence number, the page checksum after applying it and its own
+ * checksum, and is written data first, header last; so an interrupted record
+ * is ignored and the data loads as it was before that record.
+ *
+ * With several pages, a record holds all changes of a save. Once the journal
+ * is full, the data is written to the next page and the journal starts over
+ * ("compaction").
+ *
+ * With a single page there is no other copy to fall back on, so the changes
+ * are always journalled first, in as many records as needed. When the
+ * journal is full, the page is rewritten in place with the journalled data
+ * only; an interrupted rewrite still has the old generation and is repaired
+ * by replaying the journal. The generation is written last, after which the
+ * journal starts over. A save that is interrupted can therefore load with
+ * only some of its changes, but never with corrupt data.
  */
-template <typename STORAGE, size_t BASE_ADDR, size_t END_ADDR, typename DATA_TYPE, EStorageMode MODE = STORAGE_UPDATE, bool FASTSCAN=true>
+template <typename STORAGE, size_t BASE_ADDR, size_t END_ADDR, typename DATA_TYPE, EStorageMode MODE = STORAGE_UPDATE, bool FASTSCAN=true, size_t JOURNAL_LENGTH = 0>
 class PageStorage {
 protected:
- 
+
   struct page_header {
     uint32_t fourcc;
     uint32_t generation;
@@ -79,16 +110,41 @@ protected:
 
   } __attribute__((aligned(2)));
 
+  /**
+   * Journal record header; the checksum covers the other fields and the
+   * payload, which is a sequence of journal_range + changed bytes.
+   */
+  struct journal_header {
+    uint32_t generation;
+    uint16_t sequence;
+    uint16_t length;
+    uint16_t data_checksum;
+    uint16_t checksum;
+  } __attribute__((packed));
+
+  struct journal_range {
+    uint16_t offset;
+    uint16_t length;
+  } __attribute__((packed));
+
+  struct journal_record {
+    journal_header header;
+    uint8_t payload[JOURNAL_LENGTH > sizeof(journal_header) ? JOURNAL_LENGTH - sizeof(journal_header) : 1];
+  } __attribute__((packed));
+
 public:
 
   static const size_t LENGTH = END_ADDR - BASE_ADDR;
   static const size_t PAGESIZE = sizeof(page_data);
-  static const size_t PAGES = LENGTH / PAGESIZE;
+  static const size_t PAGES = (LENGTH - JOURNAL_LENGTH) / PAGESIZE;
+  static const size_t JOURNAL_ADDR = END_ADDR - JOURNAL_LENGTH;
 
   // throw compiler error if no pages
-  typedef bool CHECK_PAGES[PAGES > 0 ? 1 : -1 ];
+  typedef bool CHECK_PAGES[JOURNAL_LENGTH < LENGTH && PAGES > 0 ? 1 : -1 ];
   // throw compiler error if OOB
   typedef bool CHECK_BASEADDR[BASE_ADDR + LENGTH > STORAGE::LENGTH ? -1 : 1];
+  // throw compiler error if journal can't hold a record, or offsets don't fit
+  typedef bool CHECK_JOURNAL[!JOURNAL_LENGTH || (JOURNAL_LENGTH > sizeof(journal_header) + sizeof(journal_range) && sizeof(DATA_TYPE) <= 0xffff) ? 1 : -1];
 
   /**
    * @return index of page in storage; only valid after ::load
@@ -104,10 +160,25 @@ public:
     page_index_ = -1;
     page_.header.fourcc = DATA_TYPE::FOURCC;
     page_.header.size = sizeof(DATA_TYPE);
+    write_pos_ = save_length_ = 0;
+    saving_record_ = false;
+    save_pending_ = false;
+    journal_pos_ = 0;
+    journal_sequence_ = 0;
+  }
+
+  /**
+   * @return bytes used in journal
+   */
+  size_t journal_used() const {
+    return journal_pos_;
   }
 
   /**
    * Scan all pages to find the newest to load.
+   * Only the page headers are read during the scan; the newest candidate is
+   * then read in full, the journal replayed and its checksum verified. If
+   * that fails, the next newest candidate is tried.
    * If no data found, initialize internal page to empty.
    * @param data [out] loaded data if load successful, else unmodified
    * @return true if data loaded
@@ -115,37 +186,36 @@ public:
   bool Load(DATA_TYPE &data) {
 
     page_index_ = -1;
-    memset(&page_, 0, sizeof(page_));
-    page_.header.generation = -1;
-    page_data next_page;
-    for (size_t i = 0; i < PAGES; ++i) {
-      STORAGE::read(BASE_ADDR + i * PAGESIZE, &next_page, sizeof(next_page));
+    write_pos_ = save_length_ = 0;
+    saving_record_ = false;
+    save_pending_ = false;
 
-      STORAGE_PRINTF("[%u]\n", BASE_ADDR + i * PAGESIZE);
-      STORAGE_PRINTF("FOURCC:%x (%x)\n", next_page.header.fourcc, DATA_TYPE::FOURCC);
-      STORAGE_PRINTF("size  :%u (%u)\n", next_page.header.size, sizeof(DATA_TYPE));
-      STORAGE_PRINTF("gen   :%u (%u)\n", next_page.header.generation, page_.header.generation);
-
-      if ((DATA_TYPE::FOURCC != next_page.header.fourcc) ||
-          (sizeof(DATA_TYPE) != next_page.header.size) ||
-          (next_page.header.checksum != checksum(next_page)) ||
-          (next_page.header.generation < page_.header.generation && (int32_t)page_.header.generation != -1)) {
-        if (FASTSCAN) {
-          STORAGE_PRINTF("Aborting scan at page %d\n", i);
-          break;
-        } else {
-          STORAGE_PRINTF("Ignoring page %d\n", i);
-          continue;
-        }
+    uint32_t limit_generation = 0xffffffff;
+    size_t limit_index = PAGES;
+    int candidate;
+    while (-1 != (candidate = FindPage(limit_generation, limit_index))) {
+      STORAGE::read(BASE_ADDR + candidate * PAGESIZE, &page_, sizeof(page_));
+      journal_pos_ = 0;
+      journal_sequence_ = 0;
+      uint16_t expected_checksum = page_.header.checksum;
+      if (JOURNAL_LENGTH)
+        ReplayJournal(expected_checksum);
+      if (expected_checksum == checksum(page_)) {
+        page_index_ = candidate;
+        break;
       }
-
-      page_index_ = i;
-      memcpy(&page_, &next_page, sizeof(page_));
+      STORAGE_PRINTF("Checksum failed for page %d\n", candidate);
+      limit_generation = page_.header.generation;
+      limit_index = candidate;
     }
-    
+
     if (-1 == page_index_) {
+      memset(&page_, 0, sizeof(page_));
+      page_.header.generation = -1;
       page_.header.fourcc = DATA_TYPE::FOURCC;
       page_.header.size = sizeof(DATA_TYPE);
+      journal_pos_ = 0;
+      journal_sequence_ = 0;
       return false;
     } else {
       memcpy(&data, &page_.data, sizeof(DATA_TYPE));
@@ -159,51 +229,365 @@ public:
    * @return true if data was written to storage
    */
   bool Save(const DATA_TYPE &data) {
+    if (!BeginSave(data))
+      return false;
+    while (!SaveStep(PAGESIZE + JOURNAL_LENGTH)) { }
+    return true;
+  }
 
-    bool dirty = false;
-    const uint8_t *src = (const uint8_t*)&data;
-    uint8_t *dst = (uint8_t*)&page_.data;
-    size_t length = sizeof(DATA_TYPE);
-    while (length--) {
-      if (*dst != *src) {
-        dirty = true;
-        *dst = *src;
-      }
-      ++dst;
-      ++src;
+  /**
+   * Begin saving data to storage, the actual writes happen in ::SaveStep.
+   * Without a journal, a save in progress is restarted with the new data.
+   * With a journal, the write in progress is completed first, and the
+   * following ones save the new data.
+   * Assumes ::load has been called!
+   * @param data data to be stored, copied
+   * @return true if data has changed and needs to be written
+   */
+  bool BeginSave(const DATA_TYPE &data) {
+
+    if (JOURNAL_LENGTH) {
+      memcpy(&save_data_, &data, sizeof(DATA_TYPE));
+      if (saving())
+        return true;
+      if (!memcmp(&page_.data, &save_data_, sizeof(DATA_TYPE)))
+        return false;
+      save_pending_ = true;
+      NextWrite();
+      return true;
     }
 
-    if (dirty) {
-      ++page_.header.generation;
-      page_.header.checksum = checksum(page_);
-      page_index_ = (page_index_ + 1) % PAGES;
+    if (!memcmp(&page_.data, &data, sizeof(DATA_TYPE)))
+      return false;
+
+    memcpy(&page_.data, &data, sizeof(DATA_TYPE));
+    BeginPage();
+    return true;
+  }
+
+  /**
+   * Write up to max_bytes of the save in progress
+   * @return true if the save is complete
+   */
+  bool SaveStep(size_t max_bytes) {
+    while (max_bytes && (write_pos_ < save_length_ || NextWrite())) {
+      size_t addr;
+      const uint8_t *src;
+      if (saving_record_) {
+        addr = JOURNAL_ADDR + journal_pos_;
+        src = (const uint8_t *)&journal_record_;
+      } else {
+        addr = BASE_ADDR + ((page_index_ + 1) % PAGES) * PAGESIZE;
+        src = (const uint8_t *)&page_;
+      }
+
+      while (write_pos_ < save_length_ && max_bytes) {
+        size_t offset;
+        size_t length = NextRun(offset);
+        if (length > max_bytes)
+          length = max_bytes;
+
+        if (STORAGE_UPDATE == MODE)
+          STORAGE::update(addr + offset, src + offset, length);
+        else
+          STORAGE::write(addr + offset, src + offset, length);
+
+        write_pos_ += length;
+        max_bytes -= length;
+      }
+
+      if (write_pos_ < save_length_)
+        break;
 
-      if (STORAGE_UPDATE == MODE)
-        STORAGE::update(BASE_ADDR + page_index_ * PAGESIZE, &page_, sizeof(page_));
-      else
-        STORAGE::write(BASE_ADDR + page_index_ * PAGESIZE, &page_, sizeof(page_));
+      if (saving_record_) {
+        journal_pos_ += save_length_;
+        ++journal_sequence_;
+      } else {
+        page_index_ = (page_index_ + 1) % PAGES;
+        journal_pos_ = 0;
+        journal_sequence_ = 0;
+      }
     }
 
-    return dirty;
+    return !saving();
+  }
+
+  /**
+   * @return true if a save is in progress
+   */
+  bool saving() const {
+    return write_pos_ < save_length_ || save_pending_;
   }
 
 protected:
 
   int page_index_;
-  page_data page_;
+  page_data page_; // data as stored, i.e. including completed records
+  size_t write_pos_;
+  size_t save_length_;
+  bool saving_record_;
+
+  // With a journal, a save can take several writes to reach save_data_
+  bool save_pending_;
+  DATA_TYPE save_data_;
+
+  size_t journal_pos_;
+  uint16_t journal_sequence_;
+  journal_record journal_record_;
+
+  /**
+   * Set up the next write of a journalled save, unless the stored data is
+   * already up-to-date.
+   * @return true if there is something to write
+   */
+  bool NextWrite() {
+    if (!save_pending_)
+      return false;
+    if (!memcmp(&page_.data, &save_data_, sizeof(DATA_TYPE))) {
+      save_pending_ = false;
+      return false;
+    }
+
+    if (-1 != page_index_) {
+      size_t length = BuildRecord((const uint8_t *)&save_data_, 1 == PAGES);
+      if (length) {
+        journal_record_.header.generation = page_.header.generation;
+        journal_record_.header.sequence = journal_sequence_;
+        journal_record_.header.length = length - sizeof(journal_header);
+        ApplyRecord(true);
+        journal_record_.header.data_checksum = checksum(page_);
+        journal_record_.header.checksum = journal_checksum(journal_record_);
+        saving_record_ = true;
+        save_length_ = length;
+        write_pos_ = 0;
+        return true;
+      }
+    }
+
+    // A single page is rewritten with the journalled changes only, unless
+    // there's nothing to lose
+    if (PAGES > 1 || -1 == page_index_)
+      memcpy(&page_.data, &save_data_, sizeof(DATA_TYPE));
+    BeginPage();
+    return true;
+  }
+
+  void BeginPage() {
+    ++page_.header.generation;
+    page_.header.checksum = checksum(page_);
+    saving_record_ = false;
+    save_length_ = PAGESIZE;
+    write_pos_ = 0;
+  }
+
+  /**
+   * The data goes first and the header (with checksum) last, so an
+   * interrupted write doesn't leave a valid header with stale data. When a
+   * single page is rewritten in place, its generation goes last of all,
+   * since the journal only applies to it until the generation changes.
+   * @param offset [out] offset of the next bytes to write
+   * @return number of contiguous bytes at offset
+   */
+  size_t NextRun(size_t &offset) const {
+    const size_t header_length = saving_record_ ? sizeof(journal_header) : sizeof(page_header);
+    const size_t data_length = save_length_ - header_length;
+    size_t pos = write_pos_;
+    if (pos < data_length) {
+      offset = header_length + pos;
+      return data_length - pos;
+    }
+    pos -= data_length;
+    if (saving_record_ || PAGES > 1) {
+      offset = pos;
+      return header_length - pos;
+    }
+
+    const size_t generation_begin = offsetof(page_header, generation);
+    const size_t generation_end = generation_begin + sizeof(uint32_t);
+    if (pos < generation_begin) {
+      offset = pos;
+      return generation_begin - pos;
+    }
+    pos -= generation_begin;
+    if (pos < header_length - generation_end) {
+      offset = generation_end + pos;
+      return header_length - generation_end - pos;
+    }
+    pos -= header_length - generation_end;
+    offset = generation_begin + pos;
+    return generation_end - offset;
+  }
+
+  /**
+   * Apply valid records for the current page from the journal; stops at the
+   * first record that is invalid, for a different page or out of sequence.
+   * @param data_checksum [out] expected page checksum after the last record
+   */
+  void ReplayJournal(uint16_t &data_checksum) {
+    while (journal_pos_ + sizeof(journal_header) < JOURNAL_LENGTH) {
+      journal_header &header = journal_record_.header;
+      STORAGE::read(JOURNAL_ADDR + journal_pos_, &header, sizeof(header));
+      if (header.generation != page_.header.generation ||
+          header.sequence != journal_sequence_ ||
+          !header.length ||
+          header.length > JOURNAL_LENGTH - journal_pos_ - sizeof(journal_header))
+        break;
+
+      STORAGE::read(JOURNAL_ADDR + journal_pos_ + sizeof(header), journal_record_.payload, header.length);
+      if (header.checksum != journal_checksum(journal_record_) ||
+          !ApplyRecord(false) || !ApplyRecord(true)) {
+        STORAGE_PRINTF("Journal record %u invalid\n", journal_sequence_);
+        break;
+      }
+
+      STORAGE_PRINTF("Journal record %u: %u bytes\n", journal_sequence_, header.length);
+      data_checksum = header.data_checksum;
+      journal_pos_ += sizeof(journal_header) + header.length;
+      ++journal_sequence_;
+    }
+  }
+
+  /**
+   * Check the ranges in the current record, and optionally apply them
+   * @return false if the ranges are invalid
+   */
+  bool ApplyRecord(bool apply) {
+    const uint8_t *payload = journal_record_.payload;
+    const uint8_t *end = payload + journal_record_.header.length;
+    while (payload < end) {
+      journal_range range;
+      if (end - payload < (ptrdiff_t)sizeof(range))
+        return false;
+      memcpy(&range, payload, sizeof(range));
+      payload += sizeof(range);
+      if (!range.length || range.offset + range.length > sizeof(DATA_TYPE) || end - payload < range.length)
+        return false;
+      if (apply)
+        memcpy((uint8_t *)&page_.data + range.offset, payload, range.length);
+      payload += range.length;
+    }
+    return true;
+  }
+
+  /**
+   * Collect the ranges that differ between data and page_ in the record
+   * payload. Unchanged runs shorter than a range header are included in the
+   * surrounding range.
+   * @param partial if true, collect as many changes as fit
+   * @return record length, or 0 if the record doesn't fit into the journal
+   */
+  size_t BuildRecord(const uint8_t *data, bool partial) {
+    if (!JOURNAL_LENGTH)
+      return 0;
+
+    const uint8_t *current = (const uint8_t *)&page_.data;
+    const size_t available = JOURNAL_LENGTH - journal_pos_;
+    if (available <= sizeof(journal_header))
+      return 0;
+
+    uint8_t *payload = journal_record_.payload;
+    const size_t max_length = available - sizeof(journal_header);
+    size_t length = 0;
+    size_t i = 0;
+    while (i < sizeof(DATA_TYPE)) {
+      if (data[i] == current[i]) {
+        ++i;
+        continue;
+      }
+
+      size_t end = i + 1;
+      for (size_t j = end; j < sizeof(DATA_TYPE) && j - end < sizeof(journal_range); ++j)
+        if (data[j] != current[j])
+          end = j + 1;
+
+      journal_range range = { (uint16_t)i, (uint16_t)(end - i) };
+      if (length + sizeof(range) + range.length > max_length) {
+        if (!partial)
+          return 0;
+        if (length + sizeof(range) >= max_length)
+          break;
+        range.length = max_length - length - sizeof(range);
+      }
+      memcpy(payload + length, &range, sizeof(range));
+      memcpy(payload + length + sizeof(range), data + i, range.length);
+      length += sizeof(range) + range.length;
+      i += range.length;
+    }
+
+    return length ? sizeof(journal_header) + length : 0;
+  }
+
+  /**
+   * Find the newest page with a valid header that is older than the limit,
+   * i.e. hasn't been rejected already. Pages with the same generation are
+   * ordered by index.
+   * @return page index or -1 if none found
+   */
+  static int FindPage(uint32_t limit_generation, size_t limit_index) {
+    int index = -1;
+    uint32_t generation = 0;
+    page_header header;
+    for (size_t i = 0; i < PAGES; ++i) {
+      STORAGE::read(BASE_ADDR + i * PAGESIZE, &header, sizeof(header));
+
+      STORAGE_PRINTF("[%u]\n", BASE_ADDR + i * PAGESIZE);
+      STORAGE_PRINTF("FOURCC:%x (%x)\n", header.fourcc, DATA_TYPE::FOURCC);
+      STORAGE_PRINTF("size  :%u (%u)\n", header.size, sizeof(DATA_TYPE));
+      STORAGE_PRINTF("gen   :%u (%u)\n", header.generation, generation);
+
+      if ((DATA_TYPE::FOURCC != header.fourcc) ||
+          (sizeof(DATA_TYPE) != header.size) ||
+          (-1 != index && header.generation < generation)) {
+        // Keep going if the first page is bad, it might be an interrupted
+        // write after wrapping around
+        if (FASTSCAN && -1 != index) {
+          STORAGE_PRINTF("Aborting scan at page %d\n", i);
+          break;
+        } else {
+          STORAGE_PRINTF("Ignoring page %d\n", i);
+          continue;
+        }
+      }
+
+      if (header.generation > limit_generation ||
+          (header.generation == limit_generation && i >= limit_index))
+        continue;
+
+      index = i;
+      generation = header.generation;
+    }
+    return index;
+  }
 
   static uint16_t checksum(const page_data &page) {
     uint16_t c = 0;
-    // header not included in crc
+    // header not included in crc; neither is any padding around the data
     const uint8_t *p = (const uint8_t *)&page.data;
-    size_t length = sizeof(page_data) - sizeof(page_header);
+    size_t length = sizeof(DATA_TYPE);
     while (length--) {
       c += *p++;
     }
 
     return c ^ 0xffff;
   }
+
+  // Fletcher-16 since, unlike for pages, the position of bytes matters
+  static uint16_t journal_checksum(const journal_record &record) {
+    uint16_t sum1 = 0, sum2 = 0;
+    const uint8_t *p = (const uint8_t *)&record.header;
+    size_t length = offsetof(journal_header, checksum);
+    while (length--) {
+      sum1 = (sum1 + *p++) % 255;
+      sum2 = (sum2 + sum1) % 255;
+    }
+    p = record.payload;
+    length = record.header.length;
+    while (length--) {
+      sum1 = (sum1 + *p++) % 255;
+      sum2 = (sum2 + sum1) % 255;
+    }
+    return ((sum2 << 8) | sum1) ^ 0xffff;
+  }
 };
 
 #endif // PAGESTORAGE_H_
-
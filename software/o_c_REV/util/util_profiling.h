@@ -23,6 +23,7 @@
 #ifndef OC_PROFILING_H_
 #define OC_PROFILING_H_
 
+#include <string.h>
 #include "util_macros.h"
 #include "../extern/dspinst.h"
 
@@ -85,18 +86,99 @@ struct AveragedCycles {
   }
 };
 
+// Histogram with log2 buckets, i.e. bucket n counts values in [2^(n-1), 2^n)
+// and the last bucket everything above. Unlike the average it isn't reset
+// periodically, so rare spikes remain visible. The high-water mark records an
+// arbitrary tag (e.g. app id) and timestamp (e.g. ticks) of the max. value.
+struct CycleHistogram {
+  static constexpr size_t kNumBuckets = 16;
+
+  CycleHistogram() {
+    Reset();
+  }
+
+  uint32_t buckets_[kNumBuckets];
+  uint32_t count_;
+  uint32_t max_;
+  uint32_t max_tag_;
+  uint32_t max_timestamp_;
+
+  static size_t bucket_index(uint32_t value) {
+    size_t index = value ? 32 - __builtin_clz(value) : 0;
+    return index < kNumBuckets ? index : kNumBuckets - 1;
+  }
+
+  // @return lower bound of values in bucket
+  static uint32_t bucket_value(size_t index) {
+    return index ? 1UL << (index - 1) : 0;
+  }
+
+  uint32_t bucket(size_t index) const {
+    return buckets_[index];
+  }
+
+  uint32_t count() const {
+    return count_;
+  }
+
+  uint32_t max_value() const {
+    return max_;
+  }
+
+  uint32_t max_tag() const {
+    return max_tag_;
+  }
+
+  uint32_t max_timestamp() const {
+    return max_timestamp_;
+  }
+
+  void Reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    max_ = 0;
+    max_tag_ = max_timestamp_ = 0;
+  }
+
+  void push(uint32_t value, uint32_t tag, uint32_t timestamp) {
+    ++buckets_[bucket_index(value)];
+    ++count_;
+    if (value > max_) {
+      max_ = value;
+      max_tag_ = tag;
+      max_timestamp_ = timestamp;
+    }
+  }
+};
+
 class ScopedCycleMeasurement {
 public:
   ScopedCycleMeasurement(AveragedCycles &dest)
   : dest_(dest)
+  , histogram_(nullptr)
+  , tag_(0)
+  , timestamp_(0)
+  , cycles_() { }
+
+  ScopedCycleMeasurement(AveragedCycles &dest, CycleHistogram &histogram, uint32_t tag, uint32_t timestamp)
+  : dest_(dest)
+  , histogram_(&histogram)
+  , tag_(tag)
+  , timestamp_(timestamp)
   , cycles_() { }
 
   ~ScopedCycleMeasurement() {
-    dest_.push(cycles_.read());
+    uint32_t cycles = cycles_.read();
+    dest_.push(cycles);
+    if (histogram_)
+      histogram_->push(cycles, tag_, timestamp_);
   }
 
 private:
   AveragedCycles &dest_;
+  CycleHistogram *histogram_;
+  uint32_t tag_;
+  uint32_t timestamp_;
   CycleMeasurement cycles_;
 };
 
@@ -24,6 +24,8 @@
 #define SETTINGS_H_
 
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 
 namespace settings {
 
@@ -53,6 +55,137 @@ struct value_attr {
   }
 };
 
+// Storage layout, calculated at compile time from the value_attr table.
+// Settings are stored in order; two consecutive U4 settings share a byte (the
+// first one in the msbits), otherwise a U4 takes up a whole byte.
+namespace layout {
+
+constexpr size_t storage_type_size(StorageType type) {
+  return STORAGE_TYPE_U4 == type ? 0 :
+    (STORAGE_TYPE_I8 == type || STORAGE_TYPE_U8 == type) ? 1 :
+    (STORAGE_TYPE_I16 == type || STORAGE_TYPE_U16 == type) ? 2 : 4;
+}
+
+constexpr int64_t storage_type_min(StorageType type) {
+  return STORAGE_TYPE_I8 == type ? INT8_MIN :
+    STORAGE_TYPE_I16 == type ? INT16_MIN :
+    STORAGE_TYPE_I32 == type ? INT32_MIN : 0;
+}
+
+constexpr int64_t storage_type_max(StorageType type) {
+  return STORAGE_TYPE_U4 == type ? 0xf :
+    STORAGE_TYPE_I8 == type ? INT8_MAX : STORAGE_TYPE_U8 == type ? UINT8_MAX :
+    STORAGE_TYPE_I16 == type ? INT16_MAX : STORAGE_TYPE_U16 == type ? UINT16_MAX :
+    STORAGE_TYPE_I32 == type ? INT32_MAX : UINT32_MAX;
+}
+
+// Packing state is (bytes << 1) | (nibble pending in current byte)
+constexpr size_t next_state(size_t state, StorageType type) {
+  return STORAGE_TYPE_U4 == type
+    ? ((state & 1) ? ((state >> 1) + 1) << 1 : state | 1)
+    : ((state >> 1) + (state & 1) + storage_type_size(type)) << 1;
+}
+
+// @return packing state before setting index
+constexpr size_t state(const value_attr *attr, size_t index) {
+  return index ? next_state(state(attr, index - 1), attr[index - 1].storage_type) : 0;
+}
+
+constexpr size_t offset(const value_attr *attr, size_t index) {
+  return STORAGE_TYPE_U4 == attr[index].storage_type
+    ? state(attr, index) >> 1
+    : (state(attr, index) >> 1) + (state(attr, index) & 1);
+}
+
+constexpr bool high_nibble(const value_attr *attr, size_t index) {
+  return !(state(attr, index) & 1);
+}
+
+constexpr size_t storage_size(const value_attr *attr, size_t num_settings) {
+  return (state(attr, num_settings) >> 1) + (state(attr, num_settings) & 1);
+}
+
+// @return true if all values in [min, max] can be stored without loss
+constexpr bool values_fit(const value_attr *attr, size_t num_settings) {
+  return !num_settings ||
+    (attr->min_ >= storage_type_min(attr->storage_type) &&
+     attr->max_ <= storage_type_max(attr->storage_type) &&
+     values_fit(attr + 1, num_settings - 1));
+}
+
+template <StorageType type> struct storage_field { };
+template <> struct storage_field<STORAGE_TYPE_I8> { typedef int8_t value_type; };
+template <> struct storage_field<STORAGE_TYPE_U8> { typedef uint8_t value_type; };
+template <> struct storage_field<STORAGE_TYPE_I16> { typedef int16_t value_type; };
+template <> struct storage_field<STORAGE_TYPE_U16> { typedef uint16_t value_type; };
+template <> struct storage_field<STORAGE_TYPE_I32> { typedef int32_t value_type; };
+template <> struct storage_field<STORAGE_TYPE_U32> { typedef uint32_t value_type; };
+
+template <StorageType type, bool high_nibble>
+struct field {
+  typedef typename storage_field<type>::value_type value_type;
+
+  static inline void Write(uint8_t *dest, int value) {
+    const value_type v = value;
+    memcpy(dest, &v, sizeof(v));
+  }
+
+  static inline int Read(const uint8_t *src) {
+    value_type v;
+    memcpy(&v, src, sizeof(v));
+    return v;
+  }
+};
+
+template <>
+struct field<STORAGE_TYPE_U4, true> {
+  static inline void Write(uint8_t *dest, int value) {
+    *dest = (value & 0x0f) << 4;
+  }
+
+  static inline int Read(const uint8_t *src) {
+    return *src >> 4;
+  }
+};
+
+template <>
+struct field<STORAGE_TYPE_U4, false> {
+  static inline void Write(uint8_t *dest, int value) {
+    *dest |= value & 0x0f;
+  }
+
+  static inline int Read(const uint8_t *src) {
+    return *src & 0x0f;
+  }
+};
+
+// Generates the code to save/restore settings [index, num_settings), i.e.
+// one read or write per setting, with the offsets known at compile time.
+template <typename settings_type, size_t index, size_t num_settings>
+struct serializer {
+  static constexpr StorageType kType = settings_type::value_attr(index).storage_type;
+  static constexpr size_t kOffset = offset(&settings_type::value_attr(0), index);
+  static constexpr bool kHighNibble = high_nibble(&settings_type::value_attr(0), index);
+
+  static inline void Save(const settings_type &settings, uint8_t *storage) {
+    field<kType, kHighNibble>::Write(storage + kOffset, settings.get_value(index));
+    serializer<settings_type, index + 1, num_settings>::Save(settings, storage);
+  }
+
+  static inline void Restore(settings_type &settings, const uint8_t *storage) {
+    settings.apply_value(index, field<kType, kHighNibble>::Read(storage + kOffset));
+    serializer<settings_type, index + 1, num_settings>::Restore(settings, storage);
+  }
+};
+
+template <typename settings_type, size_t num_settings>
+struct serializer<settings_type, num_settings, num_settings> {
+  static inline void Save(const settings_type &, uint8_t *) { }
+  static inline void Restore(settings_type &, const uint8_t *) { }
+};
+
+}; // namespace layout
+
 // Provide a very simple "settings" base.
 // Settings values are an array of ints that are accessed by index, usually the
 // owning class will use an enum for clarity, and provide specific getter
@@ -68,7 +201,11 @@ struct value_attr {
 // type as specified in the attributes. For even more compact representations,
 // the owning class can pack things differently if required.
 //
-// TODO: Save/Restore is still kind of sucky
+// The value_attr array is constexpr (\sa SETTINGS_DECLARE) so the storage
+// layout and size are known at compile time, and Save/Restore compile to a
+// fixed sequence of copies. Using Save/Restore also checks that the array has
+// num_settings entries, and that each setting's range fits its storage type.
+//
 // TODO: If absolutely necessary, add STORAGE_TYPE_BIT and pack nibbles & bits
 //
 template <typename clazz, size_t num_settings>
@@ -98,7 +235,7 @@ public:
     return apply_value(index, values_[index] + delta);
   }
 
-  static const settings::value_attr &value_attr(size_t i) {
+  static constexpr const settings::value_attr &value_attr(size_t i) {
     return value_attr_[i];
   }
 
@@ -108,133 +245,42 @@ public:
   }
 
   size_t Save(void *storage) const {
-    nibbles_ = 0;
-    uint8_t *write_ptr = static_cast<uint8_t *>(storage);
-    for (size_t s = 0; s < num_settings; ++s) {
-      switch(value_attr_[s].storage_type) {
-        case STORAGE_TYPE_U4: write_ptr = write_nibble(write_ptr, s); break;
-        case STORAGE_TYPE_I8: write_ptr = write_setting<int8_t>(write_ptr, s); break;
-        case STORAGE_TYPE_U8: write_ptr = write_setting<uint8_t>(write_ptr, s); break;
-        case STORAGE_TYPE_I16: write_ptr = write_setting<int16_t>(write_ptr, s); break;
-        case STORAGE_TYPE_U16: write_ptr = write_setting<uint16_t>(write_ptr, s); break;
-        case STORAGE_TYPE_I32: write_ptr = write_setting<int32_t>(write_ptr, s); break;
-        case STORAGE_TYPE_U32: write_ptr = write_setting<uint32_t>(write_ptr, s); break;
-      }
-    }
-    if (nibbles_)
-      write_ptr = flush_nibbles(write_ptr);
-
-    return (size_t)(write_ptr - static_cast<uint8_t *>(storage));
+    CheckLayout();
+    layout::serializer<SettingsBase, 0, num_settings>::Save(*this, static_cast<uint8_t *>(storage));
+    return storageSize();
   }
 
   size_t Restore(const void *storage) {
-    nibbles_ = 0;
-    const uint8_t *read_ptr = static_cast<const uint8_t *>(storage);
-    for (size_t s = 0; s < num_settings; ++s) {
-      switch(value_attr_[s].storage_type) {
-        case STORAGE_TYPE_U4: read_ptr = read_nibble(read_ptr, s); break;
-        case STORAGE_TYPE_I8: read_ptr = read_setting<int8_t>(read_ptr, s); break;
-        case STORAGE_TYPE_U8: read_ptr = read_setting<uint8_t>(read_ptr, s); break;
-        case STORAGE_TYPE_I16: read_ptr = read_setting<int16_t>(read_ptr, s); break;
-        case STORAGE_TYPE_U16: read_ptr = read_setting<uint16_t>(read_ptr, s); break;
-        case STORAGE_TYPE_I32: read_ptr = read_setting<int32_t>(read_ptr, s); break;
-        case STORAGE_TYPE_U32: read_ptr = read_setting<uint32_t>(read_ptr, s); break;
-      }
-    }
-    return (size_t)(read_ptr - static_cast<const uint8_t *>(storage));
+    CheckLayout();
+    layout::serializer<SettingsBase, 0, num_settings>::Restore(*this, static_cast<const uint8_t *>(storage));
+    return storageSize();
   }
 
-  static size_t storageSize() {
-    return storage_size_;
+  static constexpr size_t storageSize() {
+    return layout::storage_size(value_attr_, num_settings);
   }
 
 protected:
 
-  static constexpr uint16_t kNibbleValid = 0xf000;
-
   int values_[num_settings];
   static const settings::value_attr value_attr_[];
-  static const size_t storage_size_;
 
-  mutable uint16_t nibbles_;
+private:
 
-  uint8_t *flush_nibbles(uint8_t *dest) const {
-    *dest++ = (nibbles_ & 0xff);
-    nibbles_ = 0;
-    return dest;
-  }
-
-  uint8_t *write_nibble(uint8_t *dest, size_t index) const {
-    if (nibbles_) {
-      nibbles_ |= (values_[index] & 0x0f);
-      dest = flush_nibbles(dest);
-    } else {
-      // Ensure correct packing for reads even if there's an odd number of nibbles;
-      // the first nibble is assumed to be in the msbits.
-      nibbles_ = kNibbleValid | ((values_[index] & 0x0f) << 4);
-    }
-    return dest;
-  }
-
-  template <typename storage_type>
-  uint8_t *write_setting(uint8_t *dest, size_t index) const {
-    if (nibbles_)
-      dest = flush_nibbles(dest);
-    storage_type *storage = reinterpret_cast<storage_type *>(dest);
-    *storage++ = values_[index];
-    return reinterpret_cast<uint8_t *>(storage);
-  }
-
-  const uint8_t *read_nibble(const uint8_t *src, size_t index) {
-    uint8_t value;
-    if (nibbles_) {
-      value = nibbles_ & 0x0f;
-      nibbles_ = 0;
-    } else {
-      value = *src++;
-      nibbles_ = kNibbleValid | value;
-      value >>= 4;
-    }
-    apply_value(index, value);
-    return src;
-  }
-
-  template <typename storage_type>
-  const uint8_t *read_setting(const uint8_t *src, size_t index) {
-    nibbles_ = 0;
-    const storage_type *storage = reinterpret_cast<const storage_type*>(src);
-    apply_value(index, *storage++);
-    return reinterpret_cast<const uint8_t *>(storage);
-  }
-
-  static size_t calc_storage_size() {
-    size_t s = 0;
-    unsigned nibbles = 0;
-    for (auto attr : value_attr_) {
-      if (STORAGE_TYPE_U4 == attr.storage_type) {
-        ++nibbles;
-      } else {
-        if (nibbles & 1) ++nibbles;
-        switch(attr.storage_type) {
-          case STORAGE_TYPE_I8: s += sizeof(int8_t); break;
-          case STORAGE_TYPE_U8: s += sizeof(uint8_t); break;
-          case STORAGE_TYPE_I16: s += sizeof(int16_t); break;
-          case STORAGE_TYPE_U16: s += sizeof(uint16_t); break;
-          case STORAGE_TYPE_I32: s += sizeof(int32_t); break;
-          case STORAGE_TYPE_U32: s += sizeof(uint32_t); break;
-          default: break;
-        }
-      }
-    }
-    if (nibbles & 1) ++nibbles;
-    s += nibbles >> 1;
-    return s;
+  // Only evaluated when Save/Restore are instantiated, i.e. after the
+  // value_attr array is defined.
+  static inline void CheckLayout() {
+    static_assert(sizeof(value_attr_) / sizeof(value_attr_[0]) == num_settings,
+                  "Number of value_attr entries doesn't match num_settings");
+    static_assert(layout::values_fit(value_attr_, num_settings),
+                  "Setting range doesn't fit its storage type");
   }
 };
 
+// The value_attr array is constexpr, so SETTINGS_DECLARE has to come before
+// using the storage size in a constant expression.
 #define SETTINGS_DECLARE(clazz, last) \
-template <> const size_t settings::SettingsBase<clazz, last>::storage_size_ = settings::SettingsBase<clazz, last>::calc_storage_size(); \
-template <> const settings::value_attr settings::SettingsBase<clazz, last>::value_attr_[] =
+template <> constexpr settings::value_attr settings::SettingsBase<clazz, last>::value_attr_[] =
 
 }; // namespace settings
 
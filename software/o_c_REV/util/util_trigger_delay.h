@@ -24,12 +24,21 @@
 #ifndef UTIL_TRIGGER_DELAY_H_
 #define UTIL_TRIGGER_DELAY_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
 namespace util {
 
-// Helper class to manage delayed triggers. The active triggers are maintained
-// in a register of bits that is shifted on each Update. Uses an array of
-// uint32_t to support "long" delays (in OC: 67 * 60us, i.e. 3xuint32_t)
-// Could be special-cased for max_delay < 32 without array overhead.
+// Helper class to manage delayed triggers. Pending triggers are kept in a
+// timing wheel, i.e. a circular bitfield with one bit per tick: Push sets the
+// bit delay ticks ahead of the current position, and Update just advances the
+// position (and clears the bit it leaves). So the per-tick cost is constant
+// regardless of max_delay, and close to zero if nothing is pending.
+
+static constexpr size_t TriggerDelayWheelSize(size_t max_delay, size_t size = 32) {
+  return size > max_delay ? size : TriggerDelayWheelSize(max_delay, size << 1);
+}
 
 template <size_t max_delay>
 class TriggerDelay {
@@ -40,31 +49,55 @@ public:
   static constexpr size_t kMaxDelay = max_delay;
 
   void Init() {
-    memset(delays_, 0, sizeof(uint32_t) * kEntries);
+    memset(wheel_, 0, sizeof(uint32_t) * kEntries);
+    position_ = 0;
+    pending_ = 0;
   }
 
   inline void Update() {
-    for (size_t i = 0; i < kEntries - 1; ++i) {
-      delays_[i] = (delays_[i] >> 1) | (delays_[i + 1] << 31);
+    if (pending_) {
+      uint32_t &entry = wheel_[position_ / 32];
+      const uint32_t mask = 0x1 << (position_ % 32);
+      if (entry & mask) {
+        entry &= ~mask;
+        --pending_;
+      }
     }
-    delays_[kEntries - 1] = delays_[kEntries - 1] >> 1;
+    position_ = (position_ + 1) & (kWheelSize - 1);
   }
 
+  // Delays > kMaxDelay are clamped
   inline void Push(size_t delay) {
-    const size_t i = delay / 32;
-    const size_t b = delay - i * 32;
-    delays_[i] |= (0x1 << b);
+    if (delay > kMaxDelay)
+      delay = kMaxDelay;
+    const size_t slot = (position_ + delay) & (kWheelSize - 1);
+    uint32_t &entry = wheel_[slot / 32];
+    const uint32_t mask = 0x1 << (slot % 32);
+    if (!(entry & mask)) {
+      entry |= mask;
+      ++pending_;
+    }
   }
 
   inline bool triggered() const {
-    return delays_[0] & 0x1;
+    return pending_ && (wheel_[position_ / 32] & (0x1 << (position_ % 32)));
+  }
+
+  // @return number of ticks with pending triggers
+  inline size_t pending() const {
+    return pending_;
   }
 
 private:
 
-  static constexpr size_t kEntries = (max_delay + 31) / 32;
+  // The wheel has to be larger than the max. delay so a new trigger can't
+  // alias the current position
+  static constexpr size_t kWheelSize = TriggerDelayWheelSize(max_delay);
+  static constexpr size_t kEntries = kWheelSize / 32;
 
-  uint32_t delays_[kEntries];
+  uint32_t wheel_[kEntries];
+  size_t position_;
+  size_t pending_;
 };
 
 }; // namespace util
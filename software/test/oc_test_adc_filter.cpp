@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+#include "OC_ADC_filter.h"
+#include <math.h>
+#include <vector>
+
+using OC::ADCFilter;
+
+static const uint16_t kHigh = 0xfff0; // 4095 after scaling
+static const uint32_t kHighValue = 4095U << ADCFilter::kFractionalBits;
+
+// Output for each scan, input is `high` for the scans in [start, end) and 0
+// otherwise. If `sample` is in range, only that sample of the scan is high.
+static std::vector<uint32_t> Filter(ADCFilter &filter, size_t scans, size_t start, size_t end, size_t sample = ADCFilter::kSamplesPerScan) {
+  std::vector<uint32_t> output;
+  for (size_t scan = 0; scan < scans; ++scan) {
+    uint16_t samples[ADCFilter::kSamplesPerScan] = { 0 };
+    if (scan >= start && scan < end) {
+      for (size_t i = 0; i < ADCFilter::kSamplesPerScan; ++i)
+        if (sample >= ADCFilter::kSamplesPerScan || sample == i)
+          samples[i] = kHigh;
+    }
+    output.push_back(filter.Process(samples));
+  }
+  return output;
+}
+
+class ADCFilterTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    filter_.Init();
+  }
+
+protected:
+  ADCFilter filter_;
+};
+
+TEST_F(ADCFilterTest, Init) {
+  EXPECT_EQ(OC::ADC_FILTER_ONE_POLE, filter_.type());
+  EXPECT_EQ(static_cast<uint8_t>(ADCFilter::kDefaultShift), filter_.shift());
+  EXPECT_EQ(0U, filter_.value());
+}
+
+TEST_F(ADCFilterTest, BypassStep) {
+  filter_.Configure(OC::ADC_FILTER_BYPASS, 0);
+  auto output = Filter(filter_, 4, 1, 4);
+  EXPECT_EQ(0U, output[0]);
+  EXPECT_EQ(kHighValue, output[1]);
+  EXPECT_EQ(kHighValue, output[3]);
+
+  // Only the most recent sample counts
+  filter_.Reset(0);
+  output = Filter(filter_, 2, 0, 2, 0);
+  EXPECT_EQ(0U, output[1]);
+  output = Filter(filter_, 1, 0, 1, ADCFilter::kSamplesPerScan - 1);
+  EXPECT_EQ(kHighValue, output[0]);
+}
+
+TEST_F(ADCFilterTest, BoxImpulse) {
+  filter_.Configure(OC::ADC_FILTER_BOX, 0);
+  // A single high sample contributes 1/4 and doesn't last beyond the scan
+  auto output = Filter(filter_, 3, 1, 2, 2);
+  EXPECT_EQ(0U, output[0]);
+  EXPECT_EQ((4095U / 4) << ADCFilter::kFractionalBits, output[1]);
+  EXPECT_EQ(0U, output[2]);
+
+  output = Filter(filter_, 2, 0, 2);
+  EXPECT_EQ(kHighValue, output[0]);
+  EXPECT_EQ(kHighValue, output[1]);
+}
+
+TEST_F(ADCFilterTest, OnePoleStep) {
+  for (uint8_t shift = 1; shift <= ADCFilter::kMaxShift; ++shift) {
+    SCOPED_TRACE(shift);
+    filter_.Reset(0);
+    filter_.Configure(OC::ADC_FILTER_ONE_POLE, shift);
+    auto output = Filter(filter_, 64 << shift, 0, 64 << shift);
+
+    // Monotonic, first step is 1/2^shift and settles within a LSB
+    EXPECT_EQ(kHighValue >> shift, output[0]);
+    for (size_t i = 1; i < output.size(); ++i)
+      ASSERT_LE(output[i - 1], output[i]);
+    EXPECT_GE(output.back(), kHighValue - (1U << ADCFilter::kFractionalBits));
+
+    // After 2^shift scans it should have reached 1 - (1 - 1/2^shift)^2^shift,
+    // i.e. roughly 1 - 1/e for larger shifts
+    uint32_t tau = output[(1 << shift) - 1];
+    double expected = 1.0 - pow(1.0 - 1.0 / (1 << shift), 1 << shift);
+    EXPECT_NEAR(expected, static_cast<double>(tau) / kHighValue, 0.01);
+  }
+}
+
+TEST_F(ADCFilterTest, OnePoleDefault) {
+  // Same as the original fixed one-pole
+  uint32_t expected = 0;
+  uint32_t random = 0x1234;
+  for (int i = 0; i < 1000; ++i) {
+    uint16_t samples[ADCFilter::kSamplesPerScan];
+    uint32_t sum = 0;
+    for (auto &s : samples) {
+      random = random * 1664525 + 1013904223;
+      s = random >> 16;
+      sum += s;
+    }
+    uint32_t value = ((sum >> 2) >> 4) << 8;
+    expected = (expected * 3 + value) / 4;
+    ASSERT_EQ(expected, filter_.Process(samples));
+  }
+}
+
+TEST_F(ADCFilterTest, MedianImpulse) {
+  filter_.Configure(OC::ADC_FILTER_MEDIAN, 0);
+  // Single-scan spike is rejected entirely
+  auto output = Filter(filter_, 4, 1, 2);
+  for (auto value : output)
+    EXPECT_EQ(0U, value);
+
+  // Step passes through with one scan of latency
+  output = Filter(filter_, 4, 1, 4);
+  EXPECT_EQ(0U, output[0]);
+  EXPECT_EQ(0U, output[1]);
+  EXPECT_EQ(kHighValue, output[2]);
+  EXPECT_EQ(kHighValue, output[3]);
+}
+
+TEST_F(ADCFilterTest, SwitchType) {
+  filter_.Configure(OC::ADC_FILTER_BOX, 0);
+  Filter(filter_, 1, 0, 1);
+  ASSERT_EQ(kHighValue, filter_.value());
+
+  // Continues from the last value instead of jumping to 0
+  filter_.Configure(OC::ADC_FILTER_ONE_POLE, 2);
+  auto output = Filter(filter_, 1, 1, 1);
+  EXPECT_EQ((kHighValue * 3) / 4, output[0]);
+
+  filter_.Configure(OC::ADC_FILTER_MEDIAN, 0);
+  output = Filter(filter_, 1, 1, 1);
+  EXPECT_EQ(filter_.value(), output[0]);
+  EXPECT_EQ((kHighValue * 3) / 4, output[0]);
+}
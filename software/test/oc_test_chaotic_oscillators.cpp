@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include "util/util_chaotic_oscillators.h"
+#include "util/util_logistic_map.h"
+
+static const size_t kInstances = 4;
+
+TEST(ChaoticOscillatorsTest, LogisticSameAsLogisticMap) {
+  util::ChaoticOscillators<util::LogisticSystem, kInstances> oscillators;
+  util::LogisticMap maps[kInstances];
+  oscillators.Init();
+  for (size_t i = 0; i < kInstances; ++i) {
+    maps[i].Init();
+    uint8_t r = 40 + 60 * i;
+    uint8_t seed = 17 + 50 * i;
+    maps[i].set_r(r);
+    maps[i].set_seed(seed);
+    oscillators.set_parameter(i, ((3 << 8) + r) << 16);
+    oscillators.set_x(i, seed << 16);
+  }
+
+  for (int step = 0; step < 1000; ++step) {
+    oscillators.Step(util::CHAOTIC_INTEGRATOR_EULER);
+    for (size_t i = 0; i < kInstances; ++i)
+      ASSERT_EQ(static_cast<int32_t>(maps[i].Clock()), oscillators.x(i)) << "step=" << step << " i=" << i;
+  }
+}
+
+// Stepping instances together is the same as stepping them separately
+template <typename System>
+void TestIndependent(uint8_t integrator) {
+  util::ChaoticOscillators<System, kInstances> oscillators;
+  util::ChaoticOscillators<System, 1> single[kInstances];
+  oscillators.Init();
+  for (size_t i = 0; i < kInstances; ++i) {
+    const int64_t parameter = System::kDefaultParameter + (i << 22);
+    const int64_t dt = (i + 1) * 20000;
+    oscillators.set_parameter(i, parameter);
+    oscillators.set_dt(i, dt);
+    single[i].Init();
+    single[i].set_parameter(0, parameter);
+    single[i].set_dt(0, dt);
+  }
+
+  for (int step = 0; step < 10000; ++step) {
+    oscillators.Step(integrator);
+    for (size_t i = 0; i < kInstances; ++i) {
+      single[i].Step(integrator);
+      ASSERT_EQ(single[i].x(0), oscillators.x(i));
+      ASSERT_EQ(single[i].y(0), oscillators.y(i));
+      ASSERT_EQ(single[i].z(0), oscillators.z(i));
+    }
+  }
+}
+
+TEST(ChaoticOscillatorsTest, Independent) {
+  TestIndependent<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_EULER);
+  TestIndependent<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+  TestIndependent<util::RosslerSystem>(util::CHAOTIC_INTEGRATOR_EULER);
+  TestIndependent<util::RosslerSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+}
+
+// Large steps are split into kMaxDt steps plus the remainder
+template <typename System>
+void TestSplitSteps(uint8_t integrator) {
+  const int64_t max_dt = System::kMaxDt;
+  util::ChaoticOscillators<System, 1> large, small;
+  large.Init();
+  small.Init();
+  large.set_dt(0, 3 * max_dt + 1000);
+  for (int step = 0; step < 1000; ++step) {
+    large.Step(integrator);
+    small.set_dt(0, max_dt);
+    for (int i = 0; i < 3; ++i)
+      small.Step(integrator);
+    small.set_dt(0, 1000);
+    small.Step(integrator);
+    ASSERT_EQ(small.x(0), large.x(0));
+    ASSERT_EQ(small.y(0), large.y(0));
+    ASSERT_EQ(small.z(0), large.z(0));
+  }
+}
+
+TEST(ChaoticOscillatorsTest, SplitSteps) {
+  TestSplitSteps<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_EULER);
+  TestSplitSteps<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+  TestSplitSteps<util::RosslerSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+}
+
+// A step spread over StepPart calls is the same as a single step
+template <typename System>
+void TestStepParts(uint8_t integrator) {
+  util::ChaoticOscillators<System, kInstances> parts, steps;
+  parts.Init();
+  steps.Init();
+  for (size_t i = 0; i < kInstances; ++i) {
+    const int64_t dt = i * System::kMaxDt + (i & 1) * 1000;
+    parts.set_dt(i, dt);
+    steps.set_dt(i, dt);
+  }
+  // Instances with step 0 still take a part
+  ASSERT_EQ(1U + 2 + 2 + 4, parts.parts());
+
+  for (int step = 0; step < 1000; ++step) {
+    parts.BeginStep();
+    size_t count = 0;
+    while (parts.StepPart(integrator))
+      ++count;
+    ASSERT_EQ(parts.parts(), count);
+    steps.Step(integrator);
+    for (size_t i = 0; i < kInstances; ++i) {
+      ASSERT_EQ(steps.x(i), parts.x(i));
+      ASSERT_EQ(steps.y(i), parts.y(i));
+      ASSERT_EQ(steps.z(i), parts.z(i));
+    }
+  }
+}
+
+TEST(ChaoticOscillatorsTest, StepParts) {
+  TestStepParts<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_EULER);
+  TestStepParts<util::LorenzSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+  TestStepParts<util::RosslerSystem>(util::CHAOTIC_INTEGRATOR_HEUN);
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "util/util_edge_queue.h"
+
+class EdgeQueueTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    queue_.Init();
+  }
+
+protected:
+  util::EdgeQueue<4> queue_;
+};
+
+TEST_F(EdgeQueueTest, Empty) {
+  uint32_t timestamp = 0xdead;
+  EXPECT_EQ(0U, queue_.readable());
+  EXPECT_FALSE(queue_.Pop(timestamp));
+  EXPECT_EQ(0xdeadU, timestamp);
+}
+
+TEST_F(EdgeQueueTest, Order) {
+  EXPECT_TRUE(queue_.Push(10));
+  EXPECT_TRUE(queue_.Push(20));
+  EXPECT_EQ(2U, queue_.readable());
+
+  uint32_t timestamp;
+  ASSERT_TRUE(queue_.Pop(timestamp));
+  EXPECT_EQ(10U, timestamp);
+  ASSERT_TRUE(queue_.Pop(timestamp));
+  EXPECT_EQ(20U, timestamp);
+  EXPECT_FALSE(queue_.Pop(timestamp));
+}
+
+TEST_F(EdgeQueueTest, Overflow) {
+  for (uint32_t i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue_.Push(i));
+  // Newest edges are dropped
+  EXPECT_FALSE(queue_.Push(4));
+  EXPECT_FALSE(queue_.Push(5));
+  EXPECT_EQ(2U, queue_.overflows());
+  EXPECT_EQ(4U, queue_.readable());
+
+  uint32_t timestamp;
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue_.Pop(timestamp));
+    EXPECT_EQ(i, timestamp);
+  }
+  EXPECT_TRUE(queue_.Push(6));
+  ASSERT_TRUE(queue_.Pop(timestamp));
+  EXPECT_EQ(6U, timestamp);
+}
+
+TEST_F(EdgeQueueTest, Wrap) {
+  // Heads keep running past the size (and eventually wrap around)
+  uint32_t expected = 0;
+  uint32_t pushed = 0;
+  uint32_t timestamp;
+  for (int i = 0; i < 1000; ++i) {
+    for (int j = 0; j < (i % 5); ++j)
+      if (queue_.Push(pushed)) ++pushed;
+    while (queue_.Pop(timestamp))
+      ASSERT_EQ(expected++, timestamp);
+  }
+  EXPECT_EQ(pushed, expected);
+  EXPECT_EQ(0U, queue_.overflows());
+}
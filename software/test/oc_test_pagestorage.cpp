@@ -0,0 +1,459 @@
+#include "gtest/gtest.h"
+#include "util/util_pagestorage.h"
+#include <vector>
+
+// Storage that "loses power" after a number of bytes have been written, i.e.
+// all further writes are dropped.
+struct TestStorage {
+  static const size_t LENGTH = 512;
+  static uint8_t bytes[LENGTH];
+  static size_t write_budget;
+  static size_t bytes_written;
+  static size_t bytes_read;
+
+  static void Reset() {
+    memset(bytes, 0, sizeof(bytes));
+    write_budget = LENGTH * 1000;
+    bytes_written = 0;
+    bytes_read = 0;
+  }
+
+  static void update(size_t addr, const void *data, size_t length) {
+    write(addr, data, length);
+  }
+
+  static void write(size_t addr, const void *data, size_t length) {
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    while (length--) {
+      if (write_budget) {
+        --write_budget;
+        ++bytes_written;
+        bytes[addr] = *src;
+      }
+      ++addr;
+      ++src;
+    }
+  }
+
+  static void read(size_t addr, void *data, size_t length) {
+    memcpy(data, bytes + addr, length);
+    bytes_read += length;
+  }
+};
+
+uint8_t TestStorage::bytes[TestStorage::LENGTH];
+size_t TestStorage::write_budget;
+size_t TestStorage::bytes_written;
+size_t TestStorage::bytes_read;
+
+struct TestData {
+  static constexpr uint32_t FOURCC = FOURCC<'T','E','S','T'>::value;
+  uint8_t values[100];
+
+  void Fill(uint8_t seed) {
+    for (size_t i = 0; i < sizeof(values); ++i)
+      values[i] = seed + i * 7;
+  }
+
+  bool operator ==(const TestData &other) const {
+    return !memcmp(values, other.values, sizeof(values));
+  }
+};
+
+// 3 pages
+typedef PageStorage<TestStorage, 16, 16 + 3 * 112 + 8, TestData> TestPageStorage;
+
+class PageStorageTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    TestStorage::Reset();
+  }
+};
+
+TEST_F(PageStorageTest, Pages) {
+  EXPECT_EQ(3U, static_cast<size_t>(TestPageStorage::PAGES));
+}
+
+TEST_F(PageStorageTest, Incremental) {
+  TestPageStorage storage;
+  TestData data;
+  EXPECT_FALSE(storage.Load(data));
+
+  data.Fill(1);
+  EXPECT_TRUE(storage.BeginSave(data));
+  // Modifying the data doesn't affect the save in progress
+  TestData saved = data;
+  data.Fill(2);
+
+  size_t steps = 0;
+  while (!storage.SaveStep(5)) {
+    EXPECT_TRUE(storage.saving());
+    EXPECT_EQ(5 * (steps + 1), TestStorage::bytes_written);
+    ++steps;
+  }
+  EXPECT_FALSE(storage.saving());
+  EXPECT_EQ(static_cast<size_t>(TestPageStorage::PAGESIZE), TestStorage::bytes_written);
+  EXPECT_EQ(0, storage.page_index());
+
+  TestPageStorage loaded;
+  TestData data2;
+  ASSERT_TRUE(loaded.Load(data2));
+  EXPECT_TRUE(saved == data2);
+
+  // Unchanged data isn't written
+  EXPECT_FALSE(storage.BeginSave(saved));
+  EXPECT_TRUE(storage.SaveStep(1));
+}
+
+TEST_F(PageStorageTest, Restart) {
+  TestPageStorage storage;
+  TestData data;
+  storage.Load(data);
+
+  data.Fill(1);
+  ASSERT_TRUE(storage.BeginSave(data));
+  storage.SaveStep(50);
+  data.Fill(2);
+  ASSERT_TRUE(storage.BeginSave(data));
+  while (!storage.SaveStep(7)) { }
+  EXPECT_EQ(0, storage.page_index());
+
+  TestData loaded;
+  ASSERT_TRUE(TestPageStorage().Load(loaded));
+  EXPECT_TRUE(data == loaded);
+}
+
+TEST_F(PageStorageTest, LoadNewest) {
+  const size_t kHeaderSize = TestPageStorage::PAGESIZE - sizeof(TestData);
+  TestPageStorage storage;
+  TestData data;
+  storage.Load(data);
+  for (int save = 0; save < 4; ++save) {
+    data.Fill(save);
+    storage.Save(data);
+  }
+  ASSERT_EQ(0, storage.page_index());
+
+  // Headers up to the first older page (FASTSCAN) + one full page
+  TestStorage::bytes_read = 0;
+  TestData loaded;
+  TestPageStorage reloaded;
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_EQ(0, reloaded.page_index());
+  EXPECT_TRUE(data == loaded);
+  EXPECT_EQ(2 * kHeaderSize + TestPageStorage::PAGESIZE, TestStorage::bytes_read);
+
+  // Newest page fails checksum, falls back to next-newest
+  TestStorage::bytes[16 + kHeaderSize] ^= 0xff;
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_EQ(2, reloaded.page_index());
+  data.Fill(2);
+  EXPECT_TRUE(data == loaded);
+
+  // All corrupt
+  TestStorage::bytes[16 + TestPageStorage::PAGESIZE + kHeaderSize] ^= 0xff;
+  TestStorage::bytes[16 + 2 * TestPageStorage::PAGESIZE + kHeaderSize] ^= 0xff;
+  loaded.Fill(0xaa);
+  EXPECT_FALSE(reloaded.Load(loaded));
+  EXPECT_EQ(-1, reloaded.page_index());
+  data.Fill(0xaa);
+  EXPECT_TRUE(data == loaded);
+}
+
+// Interrupt each save (including ones that wrap around to the first page) at
+// every byte; the result must load, and be either the previous or the new
+// data.
+TEST_F(PageStorageTest, CrashAtAnyByte) {
+  std::vector<uint8_t> eeprom;
+  TestData previous;
+  previous.Fill(0);
+  {
+    TestPageStorage storage;
+    TestData data;
+    storage.Load(data);
+    storage.Save(previous);
+  }
+
+  for (size_t save = 1; save < 2 * TestPageStorage::PAGES + 1; ++save) {
+    SCOPED_TRACE(save);
+    eeprom.assign(TestStorage::bytes, TestStorage::bytes + TestStorage::LENGTH);
+    TestData next;
+    next.Fill(save * 13);
+
+    for (size_t crash = 0; crash <= TestPageStorage::PAGESIZE; ++crash) {
+      memcpy(TestStorage::bytes, &eeprom.front(), TestStorage::LENGTH);
+      TestPageStorage storage;
+      TestData data;
+      ASSERT_TRUE(storage.Load(data));
+      ASSERT_TRUE(previous == data);
+
+      TestStorage::write_budget = crash;
+      ASSERT_TRUE(storage.BeginSave(next));
+      while (!storage.SaveStep(3)) { }
+      TestStorage::write_budget = TestStorage::LENGTH * 1000;
+
+      TestPageStorage reloaded;
+      ASSERT_TRUE(reloaded.Load(data)) << "crash=" << crash;
+      if (crash < TestPageStorage::PAGESIZE)
+        ASSERT_TRUE(previous == data) << "crash=" << crash;
+      else
+        ASSERT_TRUE(next == data) << "crash=" << crash;
+    }
+    previous = next;
+  }
+}
+
+// 2 pages + journal
+static const size_t kJournalLength = 64;
+typedef PageStorage<TestStorage, 16, 16 + 2 * 112 + kJournalLength, TestData, STORAGE_UPDATE, true, kJournalLength> JournalPageStorage;
+
+TEST_F(PageStorageTest, Journal) {
+  EXPECT_EQ(2U, static_cast<size_t>(JournalPageStorage::PAGES));
+
+  JournalPageStorage storage;
+  TestData data;
+  EXPECT_FALSE(storage.Load(data));
+  data.Fill(1);
+  ASSERT_TRUE(storage.Save(data));
+  EXPECT_EQ(0, storage.page_index());
+  EXPECT_EQ(0U, storage.journal_used());
+
+  // Single byte change: 12 byte header + 4 byte range + 1 byte
+  int records = 0;
+  for (;;) {
+    TestStorage::bytes_written = 0;
+    data.values[records * 3] ^= 0x55;
+    ASSERT_TRUE(storage.Save(data));
+    if (!storage.journal_used())
+      break;
+    ++records;
+    EXPECT_EQ(17U, TestStorage::bytes_written);
+    EXPECT_EQ(17U * records, storage.journal_used());
+    EXPECT_EQ(0, storage.page_index());
+
+    TestData loaded;
+    JournalPageStorage reloaded;
+    ASSERT_TRUE(reloaded.Load(loaded));
+    EXPECT_TRUE(data == loaded);
+    EXPECT_EQ(storage.journal_used(), reloaded.journal_used());
+  }
+  // Journal full, so compacted into the next page
+  EXPECT_EQ(static_cast<int>(kJournalLength / 17), records);
+  EXPECT_EQ(static_cast<size_t>(JournalPageStorage::PAGESIZE), TestStorage::bytes_written);
+  EXPECT_EQ(1, storage.page_index());
+
+  TestData loaded;
+  JournalPageStorage reloaded;
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_TRUE(data == loaded);
+  EXPECT_EQ(0U, reloaded.journal_used());
+
+  // Nearby changes are merged into one range
+  data.values[10] ^= 1;
+  data.values[13] ^= 1;
+  data.values[20] ^= 1;
+  TestStorage::bytes_written = 0;
+  ASSERT_TRUE(storage.Save(data));
+  EXPECT_EQ(12U + 4 + 4 + 4 + 1, TestStorage::bytes_written);
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_TRUE(data == loaded);
+}
+
+// Sequence of random changes; each save is interrupted at every byte, and
+// must load as either the previous or (if complete) the new data.
+TEST_F(PageStorageTest, JournalCrashAtAnyByte) {
+  std::vector<uint8_t> eeprom;
+  TestData previous;
+  previous.Fill(0);
+  {
+    JournalPageStorage storage;
+    TestData data;
+    storage.Load(data);
+    storage.Save(previous);
+  }
+
+  uint32_t random = 0xfeed;
+  int records = 0, pages = 0;
+  for (int save = 0; save < 40; ++save) {
+    SCOPED_TRACE(save);
+    TestData next = previous;
+    random = random * 1664525 + 1013904223;
+    size_t changes = (random >> 28) < 12 ? 1 + (random >> 24) % 3 : 20;
+    for (size_t i = 0; i < changes; ++i) {
+      random = random * 1664525 + 1013904223;
+      next.values[(random >> 16) % sizeof(next.values)] += 1 + (random & 0x7f);
+    }
+
+    eeprom.assign(TestStorage::bytes, TestStorage::bytes + TestStorage::LENGTH);
+    size_t save_length = 0;
+    {
+      JournalPageStorage storage;
+      TestData data;
+      ASSERT_TRUE(storage.Load(data));
+      ASSERT_TRUE(previous == data);
+      TestStorage::bytes_written = 0;
+      ASSERT_TRUE(storage.BeginSave(next));
+      while (!storage.SaveStep(3)) { }
+      save_length = TestStorage::bytes_written;
+      if (storage.journal_used()) ++records; else ++pages;
+    }
+
+    for (size_t crash = 0; crash < save_length; ++crash) {
+      memcpy(TestStorage::bytes, &eeprom.front(), TestStorage::LENGTH);
+      JournalPageStorage storage;
+      TestData data;
+      ASSERT_TRUE(storage.Load(data));
+
+      TestStorage::write_budget = crash;
+      ASSERT_TRUE(storage.BeginSave(next));
+      while (!storage.SaveStep(3)) { }
+      TestStorage::write_budget = TestStorage::LENGTH * 1000;
+
+      JournalPageStorage reloaded;
+      ASSERT_TRUE(reloaded.Load(data)) << "crash=" << crash;
+      // If only the last header byte is missing, the new page might still
+      // pass its checksum
+      ASSERT_TRUE(previous == data || (crash + 1 == save_length && next == data)) << "crash=" << crash;
+    }
+
+    // Complete save
+    memcpy(TestStorage::bytes, &eeprom.front(), TestStorage::LENGTH);
+    JournalPageStorage storage;
+    TestData data;
+    ASSERT_TRUE(storage.Load(data));
+    ASSERT_TRUE(storage.Save(next));
+    JournalPageStorage reloaded;
+    ASSERT_TRUE(reloaded.Load(data));
+    ASSERT_TRUE(next == data);
+    previous = next;
+  }
+  // Both paths were exercised
+  EXPECT_GT(records, 10);
+  EXPECT_GT(pages, 3);
+}
+
+// Single page + journal, i.e. no other copy to fall back on
+static const size_t kSinglePageJournalLength = 40;
+typedef PageStorage<TestStorage, 16, 16 + 112 + kSinglePageJournalLength, TestData, STORAGE_UPDATE, true, kSinglePageJournalLength> SinglePageStorage;
+
+TEST_F(PageStorageTest, SinglePageJournal) {
+  EXPECT_EQ(1U, static_cast<size_t>(SinglePageStorage::PAGES));
+
+  SinglePageStorage storage;
+  TestData data;
+  EXPECT_FALSE(storage.Load(data));
+  data.Fill(1);
+  ASSERT_TRUE(storage.Save(data));
+  EXPECT_EQ(0, storage.page_index());
+  EXPECT_EQ(0U, storage.journal_used());
+
+  // More changes than fit into the journal are split into several records,
+  // with the page rewritten in between
+  data.Fill(2);
+  TestStorage::bytes_written = 0;
+  ASSERT_TRUE(storage.BeginSave(data));
+  EXPECT_EQ(0U, TestStorage::bytes_written);
+  size_t steps = 0;
+  while (!storage.SaveStep(8)) {
+    EXPECT_TRUE(storage.saving());
+    EXPECT_GE(8 * (steps + 1), TestStorage::bytes_written);
+    ++steps;
+  }
+  EXPECT_FALSE(storage.saving());
+  EXPECT_EQ(0, storage.page_index());
+
+  TestData loaded;
+  SinglePageStorage reloaded;
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_TRUE(data == loaded);
+  EXPECT_EQ(storage.journal_used(), reloaded.journal_used());
+
+  // New data during a save is saved once the current write completes
+  data.Fill(3);
+  ASSERT_TRUE(storage.BeginSave(data));
+  storage.SaveStep(5);
+  TestData saved = data;
+  data.Fill(4);
+  ASSERT_TRUE(storage.BeginSave(data));
+  data.Fill(5);
+  while (!storage.SaveStep(5)) { }
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_FALSE(saved == loaded);
+  saved.Fill(4);
+  EXPECT_TRUE(saved == loaded);
+
+  // A corrupted journal record is detected
+  TestStorage::bytes[SinglePageStorage::JOURNAL_ADDR + 12] ^= 0xff;
+  ASSERT_TRUE(reloaded.Load(loaded));
+  EXPECT_FALSE(saved == loaded);
+}
+
+// Saves with few and many changes, interrupted at every byte; the data must
+// always load, with each byte either the previous or the new value.
+TEST_F(PageStorageTest, SinglePageCrashAtAnyByte) {
+  std::vector<uint8_t> eeprom;
+  TestData previous;
+  previous.Fill(0);
+  {
+    SinglePageStorage storage;
+    TestData data;
+    storage.Load(data);
+    storage.Save(previous);
+  }
+
+  uint32_t random = 0xbeef;
+  for (int save = 0; save < 24; ++save) {
+    SCOPED_TRACE(save);
+    TestData next = previous;
+    random = random * 1664525 + 1013904223;
+    size_t changes = (random >> 28) < 8 ? 1 + (random >> 24) % 3 : 40;
+    for (size_t i = 0; i < changes; ++i) {
+      random = random * 1664525 + 1013904223;
+      next.values[(random >> 16) % sizeof(next.values)] += 1 + (random & 0x7f);
+    }
+
+    eeprom.assign(TestStorage::bytes, TestStorage::bytes + TestStorage::LENGTH);
+    size_t save_length = 0;
+    {
+      SinglePageStorage storage;
+      TestData data;
+      ASSERT_TRUE(storage.Load(data));
+      TestStorage::bytes_written = 0;
+      ASSERT_TRUE(storage.Save(next));
+      save_length = TestStorage::bytes_written;
+    }
+
+    for (size_t crash = 0; crash <= save_length; ++crash) {
+      memcpy(TestStorage::bytes, &eeprom.front(), TestStorage::LENGTH);
+      SinglePageStorage storage;
+      TestData data;
+      ASSERT_TRUE(storage.Load(data));
+      ASSERT_TRUE(previous == data);
+
+      TestStorage::write_budget = crash;
+      ASSERT_TRUE(storage.BeginSave(next));
+      while (!storage.SaveStep(3)) { }
+      TestStorage::write_budget = TestStorage::LENGTH * 1000;
+
+      SinglePageStorage reloaded;
+      ASSERT_TRUE(reloaded.Load(data)) << "crash=" << crash;
+      for (size_t i = 0; i < sizeof(data.values); ++i)
+        ASSERT_TRUE(previous.values[i] == data.values[i] || next.values[i] == data.values[i]) << "crash=" << crash << " i=" << i;
+      if (crash == save_length) {
+        ASSERT_TRUE(next == data);
+      }
+
+      // Saving again after the crash completes the save
+      ASSERT_TRUE(reloaded.Save(next) || next == data);
+      ASSERT_TRUE(SinglePageStorage().Load(data));
+      ASSERT_TRUE(next == data) << "crash=" << crash;
+    }
+
+    memcpy(TestStorage::bytes, &eeprom.front(), TestStorage::LENGTH);
+    SinglePageStorage storage;
+    TestData data;
+    ASSERT_TRUE(storage.Load(data));
+    ASSERT_TRUE(storage.Save(next));
+    previous = next;
+  }
+}
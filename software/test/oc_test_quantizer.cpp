@@ -39,3 +39,196 @@ TEST_F(QuantizerTest, SingleNote) {
   EXPECT_EQ(0, quantizer_.Process(-128));
   EXPECT_EQ(0, quantizer_.Process(-kOctave/2));
 }
+
+// Run the same pitches through Process and ProcessBatch, with the state
+// carried over between batches.
+class QuantizerBatchTest : public QuantizerTest {
+public:
+  virtual void SetUp() {
+    QuantizerTest::SetUp();
+    batch_quantizer_.Init();
+    random_ = 0x12345678;
+  }
+
+  void Configure(const braids::Scale &scale, uint16_t mask) {
+    quantizer_.Configure(scale, mask);
+    batch_quantizer_.Configure(scale, mask);
+  }
+
+  int32_t Random(int32_t min, int32_t max) {
+    random_ = random_ * 1664525 + 1013904223;
+    return min + static_cast<int32_t>((random_ >> 8) % (max - min + 1));
+  }
+
+  void ExpectSameResults(const int32_t *pitches, size_t num, int32_t root, const int32_t *transposes) {
+    int32_t results[8];
+    batch_quantizer_.ProcessBatch(pitches, results, num, root, transposes);
+    for (size_t i = 0; i < num; ++i)
+      EXPECT_EQ(quantizer_.Process(pitches[i], root, transposes[i]), results[i]) << "pitch=" << pitches[i];
+  }
+
+protected:
+  braids::Quantizer batch_quantizer_;
+  uint32_t random_;
+};
+
+TEST_F(QuantizerBatchTest, SameAsProcess) {
+  for (const auto &scale : braids::scales) {
+    for (uint16_t mask : { 0xffff, 0x1, 0x5, 0xaaa }) {
+      Configure(scale, mask);
+      ASSERT_EQ(quantizer_.enabled(), batch_quantizer_.enabled());
+      for (int i = 0; i < 64; ++i) {
+        int32_t pitches[4], transposes[4];
+        const int32_t root = Random(0, 11) << 7;
+        for (int lane = 0; lane < 4; ++lane) {
+          // Small steps so some pitches stay in the same cell
+          pitches[lane] = lane && Random(0, 1) ? pitches[lane - 1] + Random(-64, 64) : Random(-5 * kOctave, 5 * kOctave);
+          transposes[lane] = Random(0, 3) ? 0 : Random(-15, 15);
+        }
+        ExpectSameResults(pitches, 4, root, transposes);
+      }
+    }
+  }
+}
+
+TEST_F(QuantizerBatchTest, Chords) {
+  Configure(braids::scales[1], 0xffff);
+  const int32_t transposes[4] = { 0, 4, 7, 11 };
+  for (int32_t pitch = -3 * kOctave; pitch < 3 * kOctave; pitch += 37) {
+    const int32_t pitches[4] = { pitch, pitch, pitch, pitch };
+    ExpectSameResults(pitches, 4, 0, transposes);
+  }
+}
+
+TEST_F(QuantizerBatchTest, InPlace) {
+  Configure(braids::scales[2], 0xffff);
+  int32_t pitches[6] = { 0, 100, -kOctave + 3, kOctave * 2 + 60, 100, -7 };
+  int32_t expected[6];
+  for (int i = 0; i < 6; ++i)
+    expected[i] = quantizer_.Process(pitches[i], 3 << 7, 2);
+  batch_quantizer_.ProcessBatch(pitches, pitches, 6, 3 << 7, 2);
+  for (int i = 0; i < 6; ++i)
+    EXPECT_EQ(expected[i], pitches[i]);
+}
+
+TEST_F(QuantizerBatchTest, Disabled) {
+  Configure(braids::scales[1], 0);
+  ASSERT_FALSE(batch_quantizer_.enabled());
+  const int32_t pitches[3] = { -1000, 7, 12345 };
+  int32_t results[3];
+  batch_quantizer_.ProcessBatch(pitches, results, 3, 0, 0);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(pitches[i], results[i]);
+}
+
+// Every call uses a different transpose, so each one searches the codebook.
+static void ExpectSameSearches(braids::Quantizer &quantizer, braids::Quantizer &indexed, int32_t step = 1) {
+  for (int32_t pitch = -34000; pitch <= 34000; pitch += step) {
+    const int32_t transpose = pitch & 1;
+    ASSERT_EQ(quantizer.Process(pitch, 0, transpose), indexed.Process(pitch, 0, transpose)) << "pitch=" << pitch;
+  }
+}
+
+class QuantizerDirectIndexTest : public QuantizerTest {
+public:
+  virtual void SetUp() {
+    QuantizerTest::SetUp();
+    indexed_quantizer_.Init();
+    indexed_quantizer_.EnableDirectIndex(&direct_index_);
+  }
+
+protected:
+  braids::Quantizer indexed_quantizer_;
+  braids::Quantizer::DirectIndex direct_index_;
+};
+
+TEST_F(QuantizerDirectIndexTest, SameAsSearch) {
+  ExpectSameSearches(quantizer_, indexed_quantizer_);
+
+  for (size_t scale = 0; scale < sizeof(braids::scales) / sizeof(braids::scales[0]); ++scale) {
+    for (uint16_t mask : { 0xffff, 0x1, 0x91, 0xaaa }) {
+      SCOPED_TRACE(scale);
+      SCOPED_TRACE(mask);
+      quantizer_.Configure(braids::scales[scale], mask);
+      indexed_quantizer_.Configure(braids::scales[scale], mask);
+      if (quantizer_.enabled())
+        ExpectSameSearches(quantizer_, indexed_quantizer_, 11);
+    }
+  }
+}
+
+TEST_F(QuantizerDirectIndexTest, Hysteresis) {
+  quantizer_.Configure(braids::scales[1]);
+  indexed_quantizer_.Configure(braids::scales[1]);
+  // Wobble around cell boundaries
+  for (int32_t pitch = -2 * kOctave; pitch < 2 * kOctave; pitch += 5) {
+    for (int32_t wobble : { 0, 40, -40, 70, -70 }) {
+      EXPECT_EQ(quantizer_.Process(pitch + wobble, 2 << 7, 0),
+                indexed_quantizer_.Process(pitch + wobble, 2 << 7, 0));
+    }
+  }
+}
+
+TEST_F(QuantizerDirectIndexTest, UnsortedScale) {
+  // The binary search on an unsorted codebook is just as undefined, but the
+  // results should still be the same.
+  const braids::Scale unsorted = { 12 << 7, 4, { 0, 700, 200, 1200 } };
+  quantizer_.Configure(unsorted);
+  indexed_quantizer_.Configure(unsorted);
+  ExpectSameSearches(quantizer_, indexed_quantizer_);
+}
+
+TEST(CodebookCache, SameAsRebuild) {
+  braids::CodebookCache::Clear();
+  braids::Quantizer cached, reference;
+  cached.Init();
+  reference.Init();
+
+  // The first configuration is built, the second time it comes from the cache
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint16_t mask : { 0xfff, 0x91, 0xaaa }) {
+      cached.Configure(braids::scales[1], mask);
+      braids::CodebookCache::Clear();
+      reference.Configure(braids::scales[1], mask);
+      for (int32_t index = 0; index < 128; ++index)
+        EXPECT_EQ(reference.Lookup(index), cached.Lookup(index));
+    }
+  }
+}
+
+TEST(CodebookCache, HitsAndMisses) {
+  braids::CodebookCache::Clear();
+  braids::Quantizer quantizer;
+  quantizer.Init();
+
+  quantizer.Configure(braids::scales[1], 0xfff);
+  quantizer.Configure(braids::scales[2], 0xff);
+  EXPECT_EQ(0U, braids::CodebookCache::hits());
+  EXPECT_EQ(2U, braids::CodebookCache::misses());
+
+  quantizer.Configure(braids::scales[1], 0xfff);
+  quantizer.Configure(braids::scales[2], 0xff);
+  EXPECT_EQ(2U, braids::CodebookCache::hits());
+
+  // Key is the resulting notes, so a different scale with the same notes hits
+  braids::Scale chromatic = braids::scales[1];
+  quantizer.Configure(chromatic, 0xfff);
+  EXPECT_EQ(3U, braids::CodebookCache::hits());
+  chromatic.notes[3] += 1;
+  quantizer.Configure(chromatic, 0xfff);
+  EXPECT_EQ(3U, braids::CodebookCache::hits());
+  EXPECT_EQ(3U, braids::CodebookCache::misses());
+
+  // Least recently used entry is replaced
+  braids::CodebookCache::Clear();
+  quantizer.Configure(braids::scales[1], 0xfff);
+  quantizer.Configure(braids::scales[2], 0xff);
+  quantizer.Configure(braids::scales[1], 0xfff);
+  for (size_t i = 0; i < braids::CodebookCache::kNumEntries - 1; ++i)
+    quantizer.Configure(braids::scales[1], 0xfff ^ (2 << i));
+  EXPECT_EQ(1U, braids::CodebookCache::hits());
+  quantizer.Configure(braids::scales[1], 0xfff);
+  EXPECT_EQ(2U, braids::CodebookCache::hits());
+  quantizer.Configure(braids::scales[2], 0xff);
+  EXPECT_EQ(2U, braids::CodebookCache::hits());
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "util/util_settings.h"
+#include <vector>
 
 class TestU8Settings : public settings::SettingsBase<TestU8Settings, 1> { };
 SETTINGS_DECLARE(TestU8Settings, 1) {
@@ -107,3 +108,42 @@ TEST(TestSettings,TestPackU4OddEnd)
   EXPECT_EQ(-1, settings.get_value(0));
   EXPECT_EQ(0x09, settings.get_value(1));
 }
+
+class TestLayoutSettings : public settings::SettingsBase<TestLayoutSettings, 6> { };
+SETTINGS_DECLARE(TestLayoutSettings, 6) {
+  { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+  { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+  { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+  { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+  { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+  { 0, -1000, 1000, "I16", nullptr, settings::STORAGE_TYPE_I16 },
+};
+
+static_assert(TestLayoutSettings::storageSize() == 6, "storageSize isn't constant");
+
+TEST(TestSettings,TestLayout)
+{
+  TestLayoutSettings settings;
+  settings.InitDefaults();
+  settings.apply_value(0, 0x1);
+  settings.apply_value(1, 0xab);
+  settings.apply_value(2, 0x2);
+  settings.apply_value(3, 0x3);
+  settings.apply_value(4, 0x4);
+  settings.apply_value(5, -1000);
+
+  std::vector<uint8_t> data(TestLayoutSettings::storageSize(), 0xff);
+  EXPECT_EQ(data.size(), settings.Save(&data.front()));
+  const int16_t i16 = -1000;
+  const std::vector<uint8_t> expected = {
+    0x10, 0xab, 0x23, 0x40,
+    static_cast<uint8_t>(i16 & 0xff), static_cast<uint8_t>((i16 >> 8) & 0xff)
+  };
+  EXPECT_EQ(expected, data);
+
+  TestLayoutSettings restored;
+  restored.InitDefaults();
+  EXPECT_EQ(data.size(), restored.Restore(&data.front()));
+  for (size_t i = 0; i < 6; ++i)
+    EXPECT_EQ(settings.get_value(i), restored.get_value(i));
+}
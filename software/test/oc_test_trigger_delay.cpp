@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "util/util_trigger_delay.h"
+#include "util_trigger_delay_reference.h"
+
+static const size_t kMaxDelay = 96; // OC::kMaxTriggerDelayTicks
+
+TEST(TriggerDelayTest, Immediate) {
+  util::TriggerDelay<kMaxDelay> delay;
+  delay.Init();
+  delay.Update();
+  EXPECT_FALSE(delay.triggered());
+  delay.Push(0);
+  EXPECT_TRUE(delay.triggered());
+  delay.Update();
+  EXPECT_FALSE(delay.triggered());
+  EXPECT_EQ(0U, delay.pending());
+}
+
+TEST(TriggerDelayTest, Delays) {
+  util::TriggerDelay<kMaxDelay> delay;
+  delay.Init();
+  for (size_t d = 1; d < kMaxDelay; ++d) {
+    delay.Update();
+    delay.Push(d);
+    for (size_t t = 1; t <= d; ++t) {
+      ASSERT_FALSE(delay.triggered());
+      delay.Update();
+    }
+    ASSERT_TRUE(delay.triggered()) << d;
+  }
+}
+
+// Same sequence of Push/Update on both implementations, random delays and
+// densities
+template <size_t max_delay>
+static void CheckEquivalence(uint32_t seed) {
+  util::TriggerDelay<max_delay> wheel;
+  reference::TriggerDelay<max_delay> shift;
+  wheel.Init();
+  shift.Init();
+
+  uint32_t random = seed;
+  for (int tick = 0; tick < 100000; ++tick) {
+    wheel.Update();
+    shift.Update();
+    random = random * 1664525 + 1013904223;
+    // Bursts of triggers, then nothing for a while
+    if ((random >> 28) < ((tick >> 10) & 0xf)) {
+      size_t delay = (random >> 8) % max_delay;
+      wheel.Push(delay);
+      shift.Push(delay);
+    }
+    ASSERT_EQ(shift.triggered(), wheel.triggered()) << "tick=" << tick;
+  }
+}
+
+TEST(TriggerDelayTest, SameAsShift) {
+  CheckEquivalence<kMaxDelay>(0x1234);
+  CheckEquivalence<32>(0x5678);
+  CheckEquivalence<1000>(0x9abc);
+}
+
+TEST(TriggerDelayTest, Clamp) {
+  util::TriggerDelay<kMaxDelay> delay;
+  delay.Init();
+  delay.Push(kMaxDelay + 100);
+  for (size_t t = 0; t < kMaxDelay; ++t) {
+    ASSERT_FALSE(delay.triggered());
+    delay.Update();
+  }
+  EXPECT_TRUE(delay.triggered());
+}
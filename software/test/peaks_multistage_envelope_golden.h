@@ -0,0 +1,735 @@
+#ifndef PEAKS_MULTISTAGE_ENVELOPE_GOLDEN_H_
+#define PEAKS_MULTISTAGE_ENVELOPE_GOLDEN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "peaks_multistage_envelope.h"
+
+// Output of peaks::MultistageEnvelope::ProcessSingleSample for the scenarios
+// in sim/oc_test_envelope.cpp, recorded before the per-segment values were
+// cached (i.e. with everything looked up on every sample). Each hash covers
+// the output and state mask of every sample; the samples are taken at fixed
+// intervals to show roughly where the output differs.
+
+namespace golden {
+
+static const uint8_t kEnvelopeTypes = 10;
+static const size_t kRandomSweeps = 10;
+static const size_t kRandomTicks = 2000;
+static const size_t kRandomSampleInterval = 500;
+static const size_t kRandomSamples = kRandomSweeps * kRandomTicks / kRandomSampleInterval;
+static const size_t kParameterChangesTicks = 4000;
+static const size_t kParameterChangesSampleInterval = 100;
+static const size_t kParameterChangesSamples = kParameterChangesTicks / kParameterChangesSampleInterval;
+
+const uint32_t random_hashes[peaks::ENV_SHAPE_LAST][kEnvelopeTypes] = {
+  { 0xcf232893, 0x34ad6781, 0x5051ec7a, 0xcf656688, 0xe7845f14, 0x5fa94b49, 0xab671cda, 0xf8fa198f, 0xd29058d9, 0x04c86c27 },
+  { 0xb9e69c60, 0x1ef2bf4f, 0x36a79035, 0x7ba83794, 0x5190bc1d, 0x60aa3e7d, 0xe2aad6a6, 0x9711d2d5, 0x27a1310c, 0x4c706e10 },
+  { 0xe8c4681c, 0xc467076c, 0x86060349, 0x0fa67661, 0xb500df50, 0x893fdc1e, 0xab5c70e7, 0x15ae7b60, 0x047b3958, 0xc1d86b1d },
+  { 0x20039d0b, 0xb39bfc26, 0x0fe4825b, 0xfa1f8143, 0xe68bd9b3, 0x778b2acb, 0x02c5c40c, 0x57c8ff1d, 0x65fc499f, 0xbec51f18 },
+  { 0x12cbe7a6, 0xb69a5f00, 0x0828de67, 0x108d057d, 0xb2d5fba4, 0x71cbda37, 0xd6061e0a, 0x0c2d8612, 0x69149fbe, 0xc7441722 },
+  { 0x0a3d5e57, 0xfbd20488, 0x2a5e73e3, 0xe8e67eeb, 0xe8dd3d4c, 0xeca1cd1a, 0x336c56d0, 0x762980ad, 0x56eddd79, 0x808931b8 },
+  { 0x9188fec8, 0xa3c98323, 0x1cc22da7, 0x1a3cfce0, 0x0fab1436, 0x179d9d8e, 0x130abb3a, 0x92db6d32, 0x3b11b0b5, 0x795a797e },
+  { 0x923d0b40, 0x84aafcbc, 0x2f8317b7, 0x2bf962d9, 0xb2b9caa8, 0x53450792, 0xb8c15b09, 0x0dd7321f, 0xbeee0df0, 0xec8b34c0 },
+  { 0xfb8cef3c, 0x236289e5, 0x45421ad5, 0x6c0ffeee, 0xbed5aa4e, 0xe69194ed, 0xce10ee5f, 0xcc66f204, 0xf0053127, 0xe82fdbba },
+  { 0x9b977edb, 0xa1aff22e, 0x80bdb19b, 0x03895b78, 0xbbb6a5a8, 0x0c228d1c, 0xfbb6a94d, 0xce2988a6, 0xd7f7ca6d, 0x9e167405 },
+  { 0x471ff433, 0x8a6ffaa6, 0x73f8dc9c, 0xc374f234, 0x2874f604, 0x539c1344, 0x46f5f663, 0xf0ee1ca1, 0x9f697c98, 0x39e2dd44 },
+};
+
+const uint16_t random_samples[peaks::ENV_SHAPE_LAST][kEnvelopeTypes][kRandomSamples] = {
+  {
+    {
+          0,     0,  5099,     0,     0,     0,   589,  5330, 22243, 28751,
+        716,  1830, 10561,     0,     0, 12278, 14744,  1212,     0,     0,
+          0,     0,     0,  8774,   842,  2871, 19866, 14333, 19709,  1207,
+       1232,     0,  3896, 24055,     0,     0,     0,     0,  4399,     0,
+    },
+    {
+          0,   779,   347, 25248,   588,  9854,  3438, 12935, 12316, 10869,
+      22219,   335,     0,  4184,  1809,  9084,     6,   310,   448,   448,
+       2649,    87,  6289,    21,     0,   582,  2680,  1511,  5870,    22,
+       5266,  7960,    42,  2617,  1144,  7074,  7051, 12131,  3256,   370,
+    },
+    {
+        705, 10838,     0,     0,     0,     0, 12196,  1613,     0,     0,
+          0,  2585,  2137,     0,  4303, 10276,  1083,     0, 20029,  7620,
+          0,  1956,  2123,     0,     0,    60,  8768, 12797, 16821, 12750,
+       3668, 17950,     0,     0, 17106,  8207,     0,     0,  3517, 20403,
+    },
+    {
+       2645, 15290, 11916,  6774,  6774,  9758,  8173,   524,  8084, 31020,
+       6692, 23995, 16433, 10343,   254, 10623,  5691, 10017, 17894,  8489,
+      20954, 12047, 11515, 14769,     0,     0,  1300, 26263, 25216, 19656,
+      10384,   282,     0,  8329,  7273,  4925,  6044, 32429, 25280,  7863,
+    },
+    {
+      11988, 18807,  2560, 18451, 17200, 27173, 17263, 18758, 24102,     0,
+       7798, 21467, 14799,  6669, 16509,  9257, 13640,  1260,  8742,  3622,
+       3431, 17309,  8075,  2059, 18561,   518, 19004,   287,  1882,   952,
+      16116,     0,   898,     0,  2698,    90,  1411,  2054, 14917, 22411,
+    },
+    {
+      19257, 17246,  8101, 14570, 12801,  3585,  4728,  5269,  3820,  7350,
+       9541,  4149,     0,  6541, 17705,     0, 10444,     0,  4462, 24390,
+          0,     0,     0,     0, 22147, 17976,     0,     0,     0,     0,
+      15935,     0,     0, 12162, 10270, 17351, 23652,     0,     0,     0,
+    },
+    {
+       5852,  2332,     0, 10120,     0,   827,  8094,  8883, 18617, 17753,
+       3950,   141, 17285,     0,  5028,     0, 10172,     0, 31686,  1417,
+       1825,  5086, 11405,     0,     5,  5470, 14917,  1527, 10451,     0,
+       7750,  6908,     0,   224,  3263,   622, 15729, 14658,     0,  1120,
+    },
+    {
+       3850, 20802,  6691,  2378,     0, 15401, 15427,  9785,  6092,    16,
+       6001,  6079,  6947, 28169,   351,  3434,     0,  9028, 24446,  8494,
+      12390,    36,   871, 21617,  1358,  2109, 30122,  4089,  1058,    32,
+        721, 13484,  4849,  9110,     0,  7167,  3421, 11593, 27269,  2913,
+    },
+    {
+       4878,     2,  6919,  8639, 31401, 13367,  6443,  5850,  3305, 20987,
+       9576,   885, 13494,  7852,  2577,  3357,  2653,  1044, 18226,   334,
+      10841, 22649,  1477, 14411,  1219, 11949,     0,   525, 11058, 26596,
+          0, 22496,  3372, 16893, 11992, 10224, 18777, 17346, 14398,  1059,
+    },
+    {
+       3680, 25790,  5322,  4097,  1368,  5878,  8021, 19584, 18905,  6710,
+       8842,  1396,     0,  2185,  3734,     0, 22334,  3664,  7588, 24075,
+      17339, 18923, 13505, 10069, 23274,  9741, 22166,  2932, 10680, 29348,
+      16572,  4558,  9188, 17214,  8417, 20383,     0,  2017,  9337, 16778,
+    },
+  },
+  {
+    {
+      27596,     0,     0,     0,  2045,     0,  2043,     0,     0,     0,
+          0, 11511,     0,     0,     0, 20936,     0,     0,     0,  5341,
+       3759,     0,     0,  3850,  3570,     0,  7599,     0,     0, 18605,
+          0,  7904,    30,     0,  9859,     0,     9, 10195,     0,     0,
+    },
+    {
+          0, 13907, 10446,  8737, 10420, 28255,   179, 10368, 14724, 12382,
+      12678,   223,     0, 26334,  4519,  2060,  2060,  2205,  4563,     0,
+       2083,     0,  9398, 25468, 21948,  2685,  2697,  4486,  6240,  2218,
+       7698,  5887, 10128,   689,  8447,  7893,  1849,  9409,    42,   830,
+    },
+    {
+       4311,    53,  5059,  4415,  1566,  4341,     0, 27831,  1085, 13330,
+       4482,  5803, 20561, 13151,     0,     0,  1069,     6,     0, 18830,
+      14198,  3283,  5457, 20212,  2857,  8008,     0,  1021, 13416,  3432,
+      11231,     0,   196,     0,     0,  9590,     8,     0,     0,     0,
+    },
+    {
+       7485,  2833,  1523, 20941, 32115,  1653, 15555, 13347, 22490,  2444,
+       9010, 21584,  5753,  2439,  6562, 14288, 32313, 13541,  4594,  7948,
+      22814,     2, 22814, 13755, 25316, 14191,  6514, 11256, 10141, 14173,
+      26068, 26068, 22351, 26535, 29863, 26558, 32054, 11723, 32054, 23153,
+    },
+    {
+      10538,  7541,  8294,   545,  2026, 30087,     0, 28307,   581,  1291,
+      11732, 14834,  7316, 10373, 16364,     0,  4199,  2504,  3431,  4220,
+       4592,  4560,  9590, 15864,  4694, 29754,  6273,  1476,  5436,  3293,
+       1688, 16198,  9044,  7354, 20547,  6459,  1689, 16969, 26542, 11592,
+    },
+    {
+       3851, 11458,  8212,     0,     0,  1583,     0,  9495,     0,  9898,
+      14316,  9956,  9054, 25134,     0, 10642, 28828,     0,  8014,  3337,
+        579,  8712, 13426, 16652,     0,  1303, 16575,     0,     0, 12819,
+      11943, 16303,  2540, 27352,  6614, 18387,  5642,     0, 10141, 26651,
+    },
+    {
+      23807,     0, 11121,     1, 26344,  3943,  7276,     0,   325,  1731,
+          0,  6186, 10359, 22873, 11777, 11239,  1419,    81, 18822,     4,
+        239, 16183,     0,     3,  8117,  9661,     0, 24099, 19860, 32308,
+       4891, 26813,     0, 14369,  9370,  2088,    26, 17013,    67,     4,
+    },
+    {
+       6936,  1728, 11485, 22486, 21995,  2271,   169,  5155,  5817,  5430,
+      27875,  3680,  2084,  2038, 24744, 24221, 15994,     0, 13451, 28201,
+       9864, 16756, 11854,     0,     0, 25378,  8018, 17001, 14125, 12244,
+      20658, 24957, 29735,  3026, 13447, 16724,  2717,   577, 26715,     0,
+    },
+    {
+      28197,     0,  8292, 28071,   690,  1346,  3883,   249,  6308, 17468,
+       1881,  1357,  1054,  3278,   155, 12652, 32005, 19764, 26183, 23578,
+       9204,  7543,  9079,  7809,  7612,  4633,   749,  5586,   767, 18963,
+      10743,   841,  1946,  3807, 10398,  6462, 11836, 29669, 11830,  3878,
+    },
+    {
+      12642, 23730, 22793,  7978,  7978,  2614,  6631, 26158, 30283,   851,
+      17581, 19278, 29343,  4283,  3767, 27040,  8075, 24337,  9864,  1855,
+      16424,  2520, 16055,  6470,  7817,  6337,  7704,  9322, 15030,  2481,
+      30646, 12750,     3, 15438, 16715, 31360,  8962,  9229,  6648,     0,
+    },
+  },
+  {
+    {
+          0,     0,     0,  6097,   153,     0, 17731,  7822,     0,     0,
+          0,     0,  5666,     0,  1269,     0,  1846, 29021,    78,     0,
+       1192,    12,     0,     0,     0, 26484,  1527,     0,  9485,     0,
+          0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+    },
+    {
+          0,     0,  2000,  1603,  1872,  1648, 23060, 26314,  6119,     6,
+       1633,  5133,     0,  1335,  8993,  9017,  6709,  5677, 12824, 15154,
+       9280,  5442,     0,    95,     0,  5128,  2134,  8558,  2038,  8812,
+        457, 22759, 20094, 21657, 19364, 31771,   963, 20946, 28126,   192,
+    },
+    {
+      11010,  1070,  8157,    45,     0,     0,    29,   194,   226, 27666,
+      11095,     0,   317,    71,     0,     0,  2025,     0, 13817,     0,
+          0,   985,  8588,     0,     0,    50,     7,     0,     0,     0,
+        828, 27111,     0,     0,     0, 28350,     0, 25602,     0,    19,
+    },
+    {
+          0,   685,  5466,     1, 29227,  1791, 29847, 20062, 11015,  5527,
+       2654, 12528,  1572,  2573, 18916, 18912, 13767,  5417,     0, 27250,
+        960,  7380,  3640, 17162,  9683,   140, 16039, 18528,     0,     0,
+          0,   200, 32341, 22382, 21509,   310, 22878,   290,  8152, 27122,
+    },
+    {
+         25,    86,     0, 12727,     0, 12454, 20899,     0,  1008, 19793,
+        273,     0, 11517,  9684,  3517, 13962,    21,  1260,   260,  8093,
+      20715, 19511, 11661,  3850,  5303,     0,  4843,  6487,   297,    71,
+       9493, 14925, 20930, 11648,  5751,  8421,   547,     0,   137,   116,
+    },
+    {
+          5,     0, 16809,     0, 14879, 14823,     0,  7858,     0,   817,
+         56,     0, 30515, 24095,   682,    54,   226,   934, 22435, 12410,
+      16563, 23070,     0, 31350,     0,   821,     0,    88,     0, 10806,
+         62, 22512,    81,     0, 23672, 10688,     0,  6739,     0,  7185,
+    },
+    {
+      17338,     0,   120,     2,  5831,  4127,   845,   363,  1255, 11196,
+       7174,  2651,     0,     0,   811,  7020,     0,     6,   199,  3159,
+       3756,  2346,     0,     0, 10409,   165, 32346,  5698,     0,     0,
+      28078, 27916,  2897, 30519, 19359,  2086,     0, 11101,  1279,    50,
+    },
+    {
+       4592,   131,     3, 31090,     6,   378, 17957,  1786, 27395, 13678,
+       1639,  5974, 23214,  8220, 26449,   215,     0, 17419, 19996,  6014,
+      12489,  1551, 10451, 12354, 24913,    39, 14048,   704,   345,  3164,
+       4630,    12,  1316, 20043, 18457,   517,   733,     0,    26,  1404,
+    },
+    {
+      15158, 13508, 21659,   126,  1520,  4325, 25887,  8311,  8935, 24834,
+      13922,     0,  3676,   578,  2427, 21578,  9038, 16791, 30270, 24443,
+      22688, 13241, 16164,  9014, 12886,    74,  7408, 18347, 17190,  3401,
+      23883,  2513,  5618,  2538,  1246,  4305, 22733,     0, 21965,  5102,
+    },
+    {
+          0,  5458, 10150,  5431,     0,     0,     0, 14065, 12177,   120,
+          0,   437,  3990, 13544,  3996,   495,  3301,  5897,  3559, 22587,
+       4914, 12867, 12953,    78,    71, 18636,     0,  7168, 13161,  9526,
+       2840, 29347,  5467,  3554,   873,    10, 17543,     0, 11545,  1848,
+    },
+  },
+  {
+    {
+          0,     0,     0,     0,     0,  1934,     0,     0,     0,   811,
+      24219,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+          0,     0,     0,     0,   884,     0,     0,     0,     0,  3075,
+          0, 19847,     0,     0,     0,  3356,     0,     0,     0,     0,
+    },
+    {
+          0,     0,   103, 19795,  4559,  1714,  5304,     0, 15005,  1956,
+      19029,  8708, 20965,  4032,  1310,    81, 15242, 12104,  3218,   967,
+        286,  2625, 19661,     0,   174,  9391, 10959, 30561,  5335, 10478,
+       1796,   472, 10588,     0,   748,  3809,     0,  3317,    76,    34,
+    },
+    {
+      27119,  1228,  7752, 12475,     0,  8647,     0,  4362,  1472, 19838,
+        853,   403,  1159,  3484,     0,     0,     0, 18893, 15818,     0,
+      17158,     0,   312,     0,     0,  3878,     0, 19277, 24223,     0,
+      18754,     0,    31,     0,  2485,     0,    10,     0,  3037,     0,
+    },
+    {
+          0,  5791,  6151,   325,   106,  6151, 12391, 20990,     0,  4913,
+       3709,     0, 26609,  9662, 19111,  6647, 16277, 17363,   439,   262,
+        223,  4139, 28090,   763,  1011,   727, 22909, 13931, 13704, 31529,
+       4552,  9825, 10261,  4661,  6513,     0,     0, 11376, 30436, 11416,
+    },
+    {
+       9956,   108, 21027,  3280, 17794, 20540,  1778, 27070, 14076,  8377,
+      10904,   108,  6929,   831, 13110,  3697,  6542,    98,     0, 21711,
+        764,   636,     0, 11162,     0,   694,   938, 18227, 19783,   667,
+      11397,  9746,  6650,   727, 25313,  4442,     0, 23701,  9654,     0,
+    },
+    {
+          0,     0,     0,     0,  2813,     0,     0,     0,     0,    47,
+       2234, 23100,     0, 31637,     0,  6513, 15535,   516,  3107, 17239,
+      25802,    13, 24577, 10209,  3582,     0, 18245, 29008,     0,     0,
+      13036,     0,     0,     0,     0,  6049,     0, 14862, 19853,  4883,
+    },
+    {
+      11151,     0,     0,  1401,     0,     0,  3681, 29869,     0,     0,
+         75,  7442,   789,     0,  4622,     0,  1742,     0, 25360,     0,
+          0, 16107,     0,     0,     0,     0,     0, 16224,  7211,   891,
+      21858,  1010,     0,     0,  9371,     0,     0, 16926,     0,     0,
+    },
+    {
+      18230, 10691,     0,   832,     3, 19002,    12,    64,     0, 16919,
+      29217, 24555, 15630, 18108,    68,   157,    38, 26081,   268,   189,
+      22228,    96,  1677,  3325,  6269, 21689,     0,    77,  6777,  3504,
+       6291,  1067, 21264,  3204, 16844, 11573,  1152, 10838,  5292,  2212,
+    },
+    {
+       6182,  5672, 13008,     0,  3689,  3650,  1577,  7032,  1324,  5370,
+        823,  6938, 15101,  1678,  9828, 22704, 12100,  4562, 11589,  2717,
+        183,   675,   857,   806, 25324, 23471, 30573, 26125, 16679,    94,
+       1380,   113,   164,     0, 13462,   872,  9547,  3666,    63, 10355,
+    },
+    {
+        343,  1462,  1512, 15043,  1565,  1136,  1402, 29080, 25765,  7159,
+      12713,  5902,     0,   366, 14779,  2767,  1483,  8136,  5897, 10883,
+       2848, 20115, 20292, 26794, 16792,  5481,  1872, 26948,     0,  6731,
+      16215,   617, 12451,     7,  9220,   759, 14723,    87, 18735, 16871,
+    },
+  },
+  {
+    {
+        841, 11980,     0,   608,     0,    64, 24655,     0,   216,  7774,
+        344, 15807,     0,  7347,     0,  7613,     0,  8190,     0,     0,
+      26148,  6091,     0,     0,  7870,     0, 19160,     0,     0,     0,
+          0,     8,     0,     0,     0,     0,  2632, 24171,  8307,     0,
+    },
+    {
+          0,   372, 29594,  2293,  1400, 12640, 26909, 11053,  1144,    62,
+      26137,  9473,  9452,  3752,  1383,  8964,  3563,    22, 27312, 14608,
+       8077,    51, 16617, 14531, 20697, 18139, 20219,  9108,  2988,  3786,
+      15355, 26311,  2233,  7442,  3402,  6368,   908, 20768, 25467,   588,
+    },
+    {
+       5821,    49,    48,     0,     0,  1397,  3901,  7704,  8088,  8073,
+      12273,     0,   110,     0,  7915,     0,     0, 17695,     2,     0,
+       3390, 14048,     0,     0,     0,     0,     0,     2,     0,  8439,
+          0, 27396,  8222,  9155, 19895, 15421,   377, 10262,     0, 19383,
+    },
+    {
+          0,   221,   221,  6160,     0,   221,    10, 29096, 27298, 10154,
+        163, 16942, 16942,     0, 14305,  4693, 14057, 10538, 10538, 10538,
+       5100, 10766,   542, 10237, 15515, 17195,    61,     0, 13762,  6713,
+          0,  6676, 32137, 29652,   632,   878,     0, 30515, 19734, 10930,
+    },
+    {
+      22844,   475, 31747,  2818,  4227,  1007,  1402,     0, 25035, 15636,
+        292,  1069,  6070,  2679,  2679,     0,     0,  1393, 20483, 13302,
+       7071,     0, 25194,    10, 29091,  3044, 14646,  3435, 29774,  1061,
+      10798,   412,   392,     0,  8673, 18261,  3734,     0,    10, 16593,
+    },
+    {
+       5041,     0,     0,  1111, 25610,     0,  6392,     0, 18647,   860,
+         11,     0, 14790, 22777,   112,     0, 18547, 18305,     0, 23031,
+      13409,     0,   167,     0,     0,  8731,     0,  9786,     1,  1283,
+       8434,     0,     0, 19440, 24511, 13324,     0,  1218,     0, 13624,
+    },
+    {
+       4957,    54, 32531,  1604, 18389,     0,     0,    14,     0,  8963,
+      10047, 24789,  7311,   192,    98,  4575, 13252, 12623,  3897, 22095,
+      28291, 21412, 20397,  4216,  4555,     0,  8369,  6424,     0, 26463,
+      30150,     0,  7781,  1277,     8,    51,     1, 28148, 12031,    26,
+    },
+    {
+      13232, 22263, 14587,  2829, 17073,  7755, 15590, 28429, 28964, 17941,
+       7736, 25709,   856,  8261, 19695,    55, 27286,     0, 23154,  2677,
+          0, 20271,  5105,     0, 10859,   602,  9774,   626,  1731,  2484,
+      12801,  1060,  5130,     0,  2730,    32, 30910,   820,   892, 25179,
+    },
+    {
+       6469, 13629,  2013, 15106, 21656,  4986,    53, 25361, 23804,  9561,
+      11833,  7609, 21963, 12629, 17116,  4680,  8398,  9081, 11333,   249,
+      17094,  4998,  8309,  3246, 26298,  5771, 14654, 25905, 21651, 14010,
+      26313, 17751, 19831, 19653,  2043,  2842, 19717, 12251,  7117, 32043,
+    },
+    {
+      20735,  5915, 11313, 26336,     0, 16465,  5761, 22921, 15813,  2089,
+      24295, 10919, 13626,  4449, 18603,   733,  6683,  5183,     0,  3519,
+      22208, 30237, 10484, 29198, 15717, 10856, 13366,  1682, 13439, 16040,
+      25242,     0,     0,  8011, 12673,  5993, 16169,   502, 27899, 32085,
+    },
+  },
+  {
+    {
+      12673,     0,     0, 25084,     0,  5161,     6,  3534, 19239,  5640,
+          0,  8975, 12861,     0,  8726,     0,     0,     0,  3310, 13776,
+      18338,     0,     0,     0,  4594,     0, 22814,     0,     0,     0,
+          0,     0,     0,     0,     0,     0, 19927,     0,   197,     0,
+    },
+    {
+          0,    11, 14540,  9989, 10932, 15575, 20406,     0,  1509,   135,
+       3871,     0,     0, 17758, 15904,  2317,   891, 15987,   600,   283,
+      10996, 10731,   987, 24151, 11039,     0, 12745,   974, 13690,  1843,
+        742,   171,   171,    89,  5691,  1992, 15738,   535,     0,  3590,
+    },
+    {
+       5182,     0,     0,     0,     0,     0,     0,     0,     0,    29,
+          0,     1,     0,     0,     0, 14567,  5688,     0,  6320,     0,
+          0,     0,     0,    98,  2740,   502,     7,  1775,     0, 11737,
+          0,     2,     0,     0,     0,     0,     0,  7269, 19976, 10063,
+    },
+    {
+          0,  1880,     0,   329,  3610,    38, 13419,   344,  1186, 29277,
+      26566, 22277,     0, 11418, 27094,  6106, 11800,  3452, 31972,  8763,
+       5191,  7159,    80,  9852,  3080, 16396,   131,     7,    13, 17025,
+       6801, 21991,  9109, 20540, 28091,  4307,     0,     0,  5235,  5042,
+    },
+    {
+      18922, 17774, 30070,    33,  5793, 29585, 17347,     0,     0, 15370,
+       4181, 11555, 10326,  6670, 10872,   572,  6679,  5979,  1618,  1383,
+        574, 12500, 12605,     0,  3499,  6928, 17183,  5603,     0,  4129,
+       6667,   474,   822,   122, 21994,  1086, 18308,  1727,  2280, 11860,
+    },
+    {
+      14240, 19742, 22168, 20514, 22636, 25181,     0, 22863,    12,     0,
+          0, 19303, 32177, 25457,     0, 17453, 12354,  4952,   871,  4664,
+          0, 23542,     0,     0, 10150,  8205,     0,     0, 27197,  1268,
+          0, 30953, 15929,  3161,     0, 30478,  3380, 16233,     0,     0,
+    },
+    {
+          0,  6036, 27913, 19417,  1813, 16286,  3188,  8720, 13211,  4449,
+      26626, 26626,  3592, 13564, 16061,     0,  3275, 13589, 25030, 25011,
+       5816,  2304,  9921,  7162,  7654,     0, 12104,  4946, 27479,  2467,
+        375, 12149, 28540,     0, 12134, 14325,  2286, 30200,     0,     0,
+    },
+    {
+          0,  3955, 20273,  4464,   897,  2214, 18392,     0,  2618, 16644,
+        283,   411, 20104, 28654,   130, 10515,     0,  1684,  8900,  2165,
+        445,    60,   284, 11182,  2111, 15632,  1500,     0, 27039,     0,
+        161, 19799,   176,     8, 12206, 14929,  8333,     0,  6450,   218,
+    },
+    {
+      16157,  2492,     3, 12078,   487,     0,  8340, 16240, 12568,  1389,
+         12, 23988,     0,  8311,     0, 15287, 23999,  1340,  5600,  9366,
+      24530,   473,  2032, 11161,  2566,   137, 27632,     0,    65,     0,
+      18460,  6935, 26301, 14888,  3162, 16329,  9936, 19335,  4806,     0,
+    },
+    {
+       3522, 21703,     0,  2257, 16570,  1935,  6369,  5794,     0, 15653,
+      13357, 21867,     0, 11158, 13442,  2415, 32469,     0, 20108, 29801,
+      23217, 16896, 14718, 29037,   271, 13573, 14692,  1091,  1270, 19285,
+      18918,    88,    67, 28924, 14663,  2477,  6276, 14629, 29125,  7074,
+    },
+  },
+  {
+    {
+          0,     0,     0,  3962, 25707, 30330,  3946,     0, 19072, 26434,
+      19600,     0,     0,     0,  3620, 31671,  2088,     0, 10513,     0,
+          0,     0, 24081, 19890,     0, 17272, 29299,     0, 22714,     0,
+      13087,     0, 11889,     0,     0,     0,     0,     0, 14680,     0,
+    },
+    {
+          0,     0,     0,  5908,  4450, 15676, 19547,     0, 28012,  3647,
+      18462, 24965, 24923, 25917, 10055,  9217,   515,  1222,  9189,  2139,
+      26309,  9119,    49,  2805, 24194,  7413, 19356,  7616, 22438,  8671,
+        575, 14400, 10572,  2390, 13251, 11590,     0, 20353,   988, 13352,
+    },
+    {
+       7055,  1305,     0, 20102,  3928,  4248,  3353,   703,     0,  6038,
+       6038, 29864,     0,     0,  5177,  5674,  3860,  6828,     0,     0,
+       5424,     0,     0, 26166,     0,  7830,  5779,   959,     0,     0,
+       8812,     0,     0,     0,     0,  1376, 25506, 25204,     0, 20811,
+    },
+    {
+      17759, 27930, 13536, 22009,     0, 14263, 11020, 22934, 29958, 22816,
+      21795, 26358,  2764,     0,  4472,  4472, 27365, 32525, 18625, 21772,
+      10011,     0, 31235, 27477,     0, 13496,  3759, 22237,  5791,  2933,
+      11087,  6274,     0, 10990, 19354, 23062, 23287, 30738, 17604, 30695,
+    },
+    {
+      12751,  3480,  5212,  5154,  8623, 12512,  4817, 26197,  2003,  3685,
+       2699, 22909, 28212, 27920,  1444,  9605,  9159, 20799, 18499, 13123,
+      25384, 11179, 11562, 24599,     0, 12103, 28497, 10033, 21501, 11683,
+       8101,  8101,   139,  9255, 14189, 31615,  4954, 16522, 14769, 26533,
+    },
+    {
+      15967, 30310, 16736, 31732,     0,     0, 14411,  4454,  9784,     0,
+      20401,     0, 21321, 28293,     0,     0, 15767,     0, 18572,     0,
+          0, 29096, 21779,     0, 28755,     0, 23318,  8405,  8248, 31727,
+      31421,     0,  8202,     0,     0, 12771,     0,  9407, 29477,  8604,
+    },
+    {
+       9807, 27828, 13950,  1271,     0, 22306,   742,     0,  2156,  5415,
+      19399,  4248, 32213, 13053,  1005, 31456, 28684, 28679, 12455,  5998,
+       2682,     0,  1300, 31702,  7288, 21758,  4840, 23697, 26834,  6467,
+          0, 19146, 20420,  5760,  6697, 17256, 17424, 16180,  2163,   138,
+    },
+    {
+      23896, 21408,     0, 12270,  6586, 29216, 24312, 12692, 18529,   297,
+        329,   131,   711,  3495, 14544,     0, 31424, 25480, 26761, 28516,
+      17142, 18420,  6080, 16323, 25347,  2540, 22270, 11685,  1875,  1331,
+       8099,  3803, 10720, 29581, 10173, 26694,  4653,  9969, 24806, 12963,
+    },
+    {
+      22545, 12963,     0, 14358,  7300, 17530,  2828, 22532, 23110, 14996,
+      22217, 12136, 17936, 15032, 26050, 26050, 26050, 26051, 22918, 22915,
+      23078,  7325,     0,  5875,     0, 26419, 26419, 30342, 30423, 24346,
+      17758, 24346, 31493,  9212, 25016, 20000, 25609,     0,  4477,  6803,
+    },
+    {
+      16309, 26377,  9889,  9889, 15509, 14475, 27314,  5052,     0, 24867,
+      13138,  5858,  1398,  7454, 22332, 19228,   750, 28329, 28233, 10698,
+      24577, 14524,  8453,  4093, 12896, 26480, 26499, 21910,  3812,  1547,
+      26879,  6391,  4390,   409,   532,  9676, 18941,  4963,  6799, 15261,
+    },
+  },
+  {
+    {
+      32438,     0,     0,     0,  9193,     0,  1077,     0, 21279,  1059,
+          0,     0,     0,  1240, 25483, 14190,     0,     0,     0,     0,
+       6747,     0,     0,     0,  1417,     0,     0,  5857, 16880,  5306,
+      16275, 15443,     0,     0, 29416, 23841,   305,     0,     0,     0,
+    },
+    {
+      11582, 24357,     0, 16537, 12888,  1258, 18225,  1539,  3440, 21443,
+        517, 14609,  6689, 11882,  6340,  2063,  3365, 15890,  4439,  1501,
+       2224, 19736,  1592, 16165,     0, 13685,    43,  5056,  3618, 14050,
+       1653, 13819, 14968, 11889, 19005,  4573,  1139,  2270, 14987,  3900,
+    },
+    {
+       3900,     0,  8725,    90, 19009,  2022,     0,     0,  2425,   447,
+          0,     0,     0,  4626,  9213,  5239, 16712, 15894,  7840,     0,
+      28615,  2356,  5661, 23022,     0, 30578, 29376,  1041, 22053,  3992,
+      26144,  2960,     0,   262,     0,     0, 11125, 11037, 19181,  6550,
+    },
+    {
+       1129, 21478, 17701, 29963,  2555, 16126,    34,  3894,  3894,  5417,
+      23112,  5323,  5204,  1859,     0,  7569, 27682, 23821,  3714,  4096,
+      30809, 30593, 19463, 14830,  2672,  8993,  1217,     0, 26581, 10246,
+      28469, 28469,  8020,     0, 17939, 15381, 26966, 26932,     0, 12645,
+    },
+    {
+       4120,     9, 22047,  5247,   512, 12566, 16102,     0,  1214,     0,
+          0,     0,     0,  2937,  2986, 15160,  2728,   806,  5356,  2049,
+         85,  1372,  3024, 10405,  5858, 21539,    11, 16218,  6442, 28405,
+      27909,  7273, 18805, 13478, 16934, 31478, 31471, 28251,  2545, 12095,
+    },
+    {
+       6704,  9061,  1629,  7323, 14822,  5647,     0,     0,  9309, 10374,
+          0, 26101,     0,  6975, 11626,  1788,     0,  5760,     5, 19805,
+      11596,     0,  3202,  3769, 15829, 26932,     0,  1541,  1227, 11267,
+       1269,     0,  4711,  9708,     0,     0,     0, 21462, 14596,  3351,
+    },
+    {
+       8674,  5594,    61,   202, 12389,  8558,  8313,     0,  2566, 21376,
+      16776,  6711,     0,     0, 11540,   461,  2320, 15958,  5513, 22256,
+      25117,  6576,  3669,  2050,  1472,     0,  7928,   700,   590,  5985,
+          0,   332,  9581,     0,  2461,   153,  1971,  3526, 30827,  2038,
+    },
+    {
+      16329,  1226, 18330, 10154,  8405,    74,  9325,  8721,  1003,  4670,
+       1211,  4178, 15488,    15,  1145, 19781,  4811,  9041, 19564,    99,
+      10969,  7249,    53,  7923,  3029, 19280,  3456, 11298,  3526,  1030,
+       1230,  5375,  3141,  1695, 23820,   223,  4535,   442,   610,   341,
+    },
+    {
+      12571, 21610, 21787,  7453, 12167,  4535,  3869, 21639, 27049, 18227,
+      17959,  4736, 14761, 16212,     0,   960, 12908,  2599,  6703,  4007,
+       6366,  8362,    59,  5648, 17722,  1014,     0,  1026,    20, 28891,
+      11680, 10027, 21075,  2079,   728, 17528,     0,  2595,  9350,  1316,
+    },
+    {
+      25499,    81,  7619, 29300,     0, 16889,  1935,  7102, 13468,  5628,
+          0, 10127,   144, 13435, 18243, 12986, 25573,  6527,  4587,  5204,
+       7573,     0, 14597, 11111,  9817, 18501, 22180, 14211, 21505, 19495,
+      16743,  6210, 14445, 18862, 18154, 19634,  4403, 26261, 23010,  2993,
+    },
+  },
+  {
+    {
+       6476,     0,  8564,     0,  5732,     0,  7273,  2361,     0,     0,
+       7096,     0,  9239,     0,    19,  1817,     0,  3147, 15039,     0,
+          0,     0,  2256,     0,     0, 14533,     0,     0, 16281,     8,
+       3124,     0,     0,   656,  4896,     0,     0,     0, 23793, 12959,
+    },
+    {
+      22099,     0,     0,     0, 11266, 16593,   792, 21320,  2236, 15879,
+       3527,  2500,  4656, 12209,   152,  4159,     0,   845,  7687,  9526,
+       3162,  2941,  5527,  2682,     0,  7830,  2026,  5204, 29397,  9757,
+      17369, 13310,     2, 30551, 11888,  1451,     0, 11514,   801,  2929,
+    },
+    {
+          0,     0, 14040,   286,   719,     0,     0,  2374,     0, 11234,
+       8492,   365,     0,  2506,     1,     0,     0,     0, 13800, 25664,
+          0,     0,  1102,  1685, 13600,     0,     0,     0,     0,     0,
+          0,   675, 12872,     0,  2779,     0,     0,  2391,     0, 12122,
+    },
+    {
+       3637,     0,  8807, 20908,  9696, 22962, 14744,    23, 19677,     0,
+      29975,  4694, 11422, 30789,  4590, 16894,  4709, 19809,  7879,  5927,
+      21628,  4568, 13741,    10, 14480,     0,     0,    71,     0, 21605,
+      21605,  1844, 31875,     0, 14460, 31094, 29608, 27128, 27128,     0,
+    },
+    {
+       4360, 19006,   292,   240, 21223,   662, 11442, 16542,  7225,   631,
+      31489,  8319,  3997,     0, 23146, 15494, 16371, 13956,  8618,   168,
+          0, 16775,  5670, 15895, 24182, 17688,  2073, 13768, 14049,  1506,
+       6010,  5862,   111, 14349, 15020,  9718,  6811,  3589,  7743, 14378,
+    },
+    {
+      15753,     0,  6267, 19648,  4369,     0,     0,     0,    77, 11034,
+          0, 27862, 14024, 15071,     0,     0,  5424,  8722,     0,  1858,
+      23171, 29793, 11965, 11579, 18802, 13226,     0,  4623,   526,     0,
+       8046,     0,     0, 10755,     0, 11469,  3581,     0,     2, 18817,
+    },
+    {
+          0, 20290, 13234,  9556,  3794,  6198, 26600,  3850,  2564,  3142,
+      23860,  2591,  4656,  1566, 13264, 11475,     0,  3540, 19040,  9946,
+       1007,  7989,  2674,   524, 21563,  5589, 31735,  1722,     0,  3745,
+      10312, 13384, 14167,  4114, 14046, 12650,  5665,     0,  7064, 12897,
+    },
+    {
+      17214,     0, 10104, 11210,   597,  8166,     2,    23,    81,    22,
+        213,     0,  5647,    84,    43,     0,     0,  2864,  7267,  8671,
+       7821, 10068, 11057, 17800, 24465,     0,  5976,  5782, 18013, 12404,
+      19415,  1021,  1610,  6291, 15131,  2760,     0, 12262, 15675,  4724,
+    },
+    {
+       8470,  9550,  1716, 22774, 30521,  4554, 24515, 15379,     5,     0,
+       5558,  9363,  6948,  4193,  6842, 10265,  3256,     0, 10113, 18579,
+      11672,     6, 21086,  4285,  8182,     0, 24835, 13402, 17937, 17288,
+      12992,     0, 12050,  8939,  2066,   146,  1353, 24181,  7909, 26623,
+    },
+    {
+       9367, 17185,    45, 13613,    37,  1474,  5359, 10503, 12474, 25797,
+      14643, 24100, 21720,     0,  9221,  1501,  1514, 12395, 13378, 13263,
+      15845, 16196, 16713,  3764, 23768, 11946,  1627,  6630, 19509, 21234,
+      21057,   789, 18252,  1530, 23155,   532,   172,  9222, 18334,  5273,
+    },
+  },
+  {
+    {
+        335,     0,  8685,  6937, 11805,     0,     0,     0,   700,   178,
+       9725, 12815,  8024,  5769, 18822,  9739,     0,   558,   981,   203,
+        266,   938,     0,   716,     0,  4523,     0,     0,  2842,     0,
+          0, 27928,     0,     0,     0,     0,  2933,  3550,     0,   876,
+    },
+    {
+       1062,  8348, 22702,  4655,     0,    10,   530,   530,  1579, 10691,
+        193,     0,  1406,   819,  2902,  1548, 13469,   441,   612,  1492,
+      14114,    37,    99, 15269,  1509,  1481,   221,  4957,     0,    22,
+        107, 30208, 13413, 14105,  1965,     0, 21888, 11524,  3061, 16392,
+    },
+    {
+       3044,   758,  8471,  6256,     0,  3484,     0,  6988,  7430,     0,
+          0, 20035,     0, 27471, 14748,  7818, 11386,  6458,     0, 23990,
+        127,     0,  1020,     0,     0,   410,     0,  2223,  8555, 13418,
+          0,     0,     0,     0,     0,  3088, 14538,     0,     0,     0,
+    },
+    {
+      30151, 13698,  8712,  2094,  5902,  2329,  5219,   719,  1128,  1030,
+      10572, 25608, 10572, 25853, 29715,  1088, 10550, 28807, 26919,     0,
+      10232, 13763,     0, 28852, 14316,    70, 26507,  6797,    93, 27181,
+       1157,     0, 27181, 22217,   625,  1016, 21381,    91,   351, 16582,
+    },
+    {
+      19526,  8533,  5973,  1219,   680,     0,  8688,  1408, 12026, 13995,
+       8487, 29715,  1990,  6309, 29937, 21730,   285, 15129,  1106, 13765,
+       1525, 16895,     4, 11600,     0, 21118, 17820,  5862,   907, 29577,
+      24539,  4555,     0, 23773, 24000, 16797,     0,  8836, 22909,   426,
+    },
+    {
+      10966,     0,  9118,     0,     0,     0,     0, 11426,  5271, 30279,
+      14977,     0,     0, 20684,   220,  3378, 25135,     0,  6110,     0,
+          0,     0,     1,   696,     0,  4075, 16959, 17370, 21104, 20858,
+          0,   558,  1208,     0,  2079, 20724,     0,     0,     0,    11,
+    },
+    {
+       6119,   434, 13070,   518,   676,  6694,  6666,     0,   298, 14569,
+        800, 20254, 18651,  6070,   303,     0,   889,  2416,    22, 21182,
+      15838,     0, 21797, 19877, 17812,   310, 13483,     0, 12080,  3006,
+        480, 12645,  1389,  1335,   488,  1156,  1128,  1816,   210,    27,
+    },
+    {
+       9880,  8293, 10105, 26561, 26691,  7422,     0,  4445, 15231, 17747,
+       6322, 24920,  4124, 12666,  2654,     0,   927,     0,  8725,  6470,
+      23691,   169,  1655,  7215,  2232, 14860,  3219, 13523, 12358,     0,
+       6654,   565,  3031,  2814,  7549, 32609, 10959, 15069, 27574, 18766,
+    },
+    {
+         79,  5129, 11756,    87, 12696, 20590,  9680,  2273,  4728,  8083,
+      25433,  6443,  7243,     0,  8314,    11,  9532,  5037,   981, 18995,
+      19120,  1457,     0, 15443,     0,  6429,  4707, 17209,  4179,  6109,
+      17889, 18410,  1581,  2811, 11995, 19907,  1749,  2574, 12548, 17490,
+    },
+    {
+       7412,  4848,  8424, 16965, 10825,    77, 19777,   153,  7142,   157,
+        120,  2549, 17177,  7972,     0,     0, 25090,     0, 26162, 27004,
+      20822, 25709,  1250, 22674,     0, 10311, 23463,     0, 23751, 11718,
+      12256,     0,  2125, 13730,  1968,  9105,  4458,  8654, 15812, 17262,
+    },
+  },
+  {
+    {
+        575,     0,  8228, 21563,     0,     0,     0, 23373,     0,   115,
+       9396,     0, 23008,  8987,     0,   150, 13069,     1,  4918, 20448,
+      20782,  9101,     0,     0,     0,     0, 17776,     0,     0,     0,
+      14217, 14884,   975,     0,  7043,     0, 30302,     0,  7436,     0,
+    },
+    {
+       8837,    84, 16850, 19533,  6196, 11398, 12318,  3652, 14892, 14098,
+          0, 17307,     0,     0,   748,  3497, 19888,  5662, 21716, 12864,
+          0,  8230,  2572, 10526,  9095,   254,  3631,     0,   571,  8342,
+      17843, 17843, 17843,  5905,     0, 10384,  1393,    37,  8691, 19648,
+    },
+    {
+      25007,  1508,     0, 19873,     0,   264, 26350,     0,     0,     0,
+          0,  1352,     0,     0,     0,     0, 14791,     0, 17564, 23965,
+          0, 10582,  2055,     0, 11373,     0,     0,     0,     0,     0,
+      23248, 27294,     0,     0,     0,  1202,     0,     0,   537,     0,
+    },
+    {
+          0, 26786,     0, 10847,     0, 14155, 22711, 22711,     0,     0,
+       4402, 18102,     0,  7092,     0,     0, 18091, 15065,     0, 32029,
+      32029,     0,     0, 10884, 19144,     0,     0,     0,     0,  4820,
+       3856,     0,     0,  8065,     0,     0, 25460,     0,     0,  1016,
+    },
+    {
+        793, 15656,     0,  3449,  7352, 20045, 23945,  4652,  9481,  4747,
+      26037, 20455,  2340, 20266, 15835, 15835,     0, 26718, 15294,  2719,
+       4322,  1805,     0,   122,  4575, 22941,     0, 13229, 13110, 20794,
+       2132, 18332, 19630,  3114,  4484,  4484, 16776, 18158, 18712, 12464,
+    },
+    {
+       3289,     0,     0, 21447,     0, 23856,     0,  4845,     0,  1522,
+          0,  7156,     0, 29918, 24286,     0, 11276,  2939,  8934,   872,
+          0,     0, 10667, 14873,  8641,     0,     0,  9939, 26268, 14591,
+          0,  4448, 27588,     0,     0, 10121,     0,  9555, 10339, 22811,
+    },
+    {
+       9339, 12300,  1354,  5443, 31935, 19076, 29274,  1736,  2585,  1318,
+      13721, 22739,  7399,     0, 25191, 22328,  1147,     0, 19257,     0,
+      26023, 12652,    61, 19751,   394,     0, 19701,  3400, 24363,     3,
+      27118,  1493,  2763, 12963,  5108, 23232,   444,     3,     0,   425,
+    },
+    {
+       5150, 32522,   866,     0,     0,   299, 10705,  2074,     0,   149,
+       9932, 10334, 12981,     0, 18815,  8734, 29873,  8835, 32571, 11090,
+      23978,     0,     0, 15225,     0,  1475,     0,  1546, 24287,     0,
+       5309, 23939, 31309,  1599,   387,    64,  2417,  7707, 15983, 28910,
+    },
+    {
+       5230,     0,  6375, 20630,     0, 24011,   187, 11189,     0, 14656,
+       7364, 23330,  8127, 23328,  2549,  9424,  6050, 12749,  9283, 12459,
+      23805,  1810,    10,  5599,   381,   836, 18519, 30614, 14126, 19666,
+        213,     0,  3886, 11382, 19462,  1657,  8023,     0, 32202,     0,
+    },
+    {
+      17877, 26750, 24549,     0,   212,   137,  6364,  4464,  5097, 18719,
+      16295, 23831, 20879, 12102,     0, 17212, 26667,  1816, 23976, 23073,
+      22236,   789, 22123, 19145, 22037,  4209,  1842, 12984,  9598, 21974,
+      13557, 21863, 20722,     0, 28002,    42,  3214, 21308, 10441,   323,
+    },
+  },
+};
+
+const uint32_t parameter_changes_hash = 0x54b2dd00;
+
+const uint16_t parameter_changes_samples[kParameterChangesSamples] = {
+      0,   479,   937,  1371,  1781,  2166,  2527,  2865,  3178,  3467,
+   4937,  5431,  5681,  5806,  6296,  6545,  6670,  7160,  7410,  7535,
+   8025, 21539,  4162,    31, 18609, 10457, 10989,  1006, 20606, 32765,
+  12965, 13453, 13921, 14366, 14791, 15196, 15583, 15954, 16306, 16645,
+};
+
+}; // namespace golden
+
+#endif // PEAKS_MULTISTAGE_ENVELOPE_GOLDEN_H_
@@ -0,0 +1,177 @@
+#ifndef OC_SIM_ARDUINO_H_
+#define OC_SIM_ARDUINO_H_
+
+// Stand-in for the teensy core headers when building on the host. Only the
+// subset that is actually used by the firmware is provided; peripheral
+// registers are plain memory (\sa oc_sim_registers.h) and time is the
+// simulator's virtual clock, not wall time.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "oc_sim_registers.h"
+
+#ifndef F_CPU
+#define F_CPU 120000000
+#endif
+#ifndef F_BUS
+#define F_BUS 60000000
+#endif
+
+#define FASTRUN
+#define DMAMEM
+#define PROGMEM
+
+#define LOW  0
+#define HIGH 1
+
+#define INPUT            0
+#define OUTPUT           1
+#define INPUT_PULLUP     2
+#define INPUT_PULLDOWN   3
+#define OUTPUT_OPENDRAIN 4
+#define INPUT_DISABLE    5
+
+#define RISING  2
+#define FALLING 3
+#define CHANGE  4
+
+#define CORE_NUM_DIGITAL 34
+
+typedef uint8_t byte;
+
+namespace oc_sim {
+
+struct Pin {
+  uint32_t config;
+  uint32_t mode;
+  uint8_t level;
+  void (*isr)();
+  int isr_mode;
+};
+extern Pin pins[CORE_NUM_DIGITAL];
+
+uint32_t millis();
+uint32_t micros();
+void delay_us(uint32_t us);
+uint32_t cycle_count();
+uint32_t random(uint32_t howbig);
+
+}; // namespace oc_sim
+
+#define portConfigRegister(pin) (&oc_sim::pins[(pin)].config)
+#define portModeRegister(pin) (&oc_sim::pins[(pin)].mode)
+#define digitalPinToBitMask(pin) (1)
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < CORE_NUM_DIGITAL) {
+    oc_sim::pins[pin].mode = mode;
+    // Inputs with pull-up idle high, like the trigger and button inputs
+    if (INPUT_PULLUP == mode)
+      oc_sim::pins[pin].level = HIGH;
+  }
+}
+
+inline void digitalWriteFast(uint8_t pin, uint8_t value) {
+  if (pin < CORE_NUM_DIGITAL)
+    oc_sim::pins[pin].level = value ? HIGH : LOW;
+}
+
+inline uint8_t digitalReadFast(uint8_t pin) {
+  return pin < CORE_NUM_DIGITAL ? oc_sim::pins[pin].level : LOW;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  digitalWriteFast(pin, value);
+}
+
+inline uint8_t digitalRead(uint8_t pin) {
+  return digitalReadFast(pin);
+}
+
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  if (pin < CORE_NUM_DIGITAL) {
+    oc_sim::pins[pin].isr = isr;
+    oc_sim::pins[pin].isr_mode = mode;
+  }
+}
+
+inline void detachInterrupt(uint8_t pin) {
+  if (pin < CORE_NUM_DIGITAL)
+    oc_sim::pins[pin].isr = nullptr;
+}
+
+inline uint32_t millis() { return oc_sim::millis(); }
+inline uint32_t micros() { return oc_sim::micros(); }
+inline void delay(uint32_t ms) { oc_sim::delay_us(ms * 1000); }
+inline void delayMicroseconds(uint32_t us) { oc_sim::delay_us(us); }
+
+inline int32_t random(int32_t howbig) {
+  return howbig > 0 ? oc_sim::random(howbig) : 0;
+}
+
+inline int32_t random(int32_t howsmall, int32_t howbig) {
+  return howsmall < howbig ? howsmall + random(howbig - howsmall) : howsmall;
+}
+
+inline void randomSeed(uint32_t) { }
+
+#define __disable_irq() do {} while (0)
+#define __enable_irq() do {} while (0)
+#define noInterrupts() do {} while (0)
+#define interrupts() do {} while (0)
+
+// The simulator is single-threaded, so exclusive access always succeeds
+inline void __DMB() { }
+inline void __CLREX() { }
+inline uint32_t __LDREXW(volatile uint32_t *addr) { return *addr; }
+inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr = value; return 0; }
+
+#define NVIC_SET_PRIORITY(irq, prio) do { (void)(irq); (void)(prio); } while (0)
+#define NVIC_ENABLE_IRQ(irq) do { (void)(irq); } while (0)
+#define NVIC_DISABLE_IRQ(irq) do { (void)(irq); } while (0)
+
+class IntervalTimer {
+public:
+  IntervalTimer() : fn_(nullptr), period_us_(0) { }
+  bool begin(void (*fn)(), uint32_t period_us) {
+    fn_ = fn;
+    period_us_ = period_us;
+    return true;
+  }
+  void priority(uint8_t) { }
+  void end() { fn_ = nullptr; }
+
+  void (*fn_)();
+  uint32_t period_us_;
+};
+
+template <uint32_t (*now)()>
+class elapsedTime {
+public:
+  elapsedTime() : start_(now()) { }
+  elapsedTime(uint32_t value) : start_(now() - value) { }
+  operator uint32_t() const { return now() - start_; }
+  elapsedTime &operator=(uint32_t value) { start_ = now() - value; return *this; }
+private:
+  uint32_t start_;
+};
+
+typedef elapsedTime<oc_sim::millis> elapsedMillis;
+typedef elapsedTime<oc_sim::micros> elapsedMicros;
+
+class SimSerial {
+public:
+  void begin(uint32_t) { }
+  void print(const char *s) { fputs(s, stdout); }
+  void println(const char *s) { puts(s); }
+  operator bool() const { return true; }
+};
+extern SimSerial Serial;
+
+#endif // OC_SIM_ARDUINO_H_
@@ -0,0 +1,85 @@
+#ifndef OC_SIM_DMACHANNEL_H_
+#define OC_SIM_DMACHANNEL_H_
+
+#include <stdint.h>
+
+// Minimal DMAChannel stand-in. Channels register themselves with the
+// simulator, which performs the transfers that the firmware expects the
+// hardware to do (\sa oc_sim::RunAdcConversion).
+
+class DMAChannel {
+public:
+  struct TCD_t {
+    volatile const void *SADDR;
+    int16_t SOFF;
+    uint16_t ATTR;
+    uint32_t NBYTES;
+    int32_t SLAST;
+    volatile void *DADDR;
+    int16_t DOFF;
+    uint16_t CITER;
+    int32_t DLASTSGA;
+    uint16_t CSR;
+    uint16_t BITER;
+  };
+
+  DMAChannel(bool allocate = true);
+  ~DMAChannel();
+
+  void begin(bool force_initialization = false);
+
+  // SPI0 TX transfers complete immediately (\sa oc_sim::Hardware::RunSpiDma)
+  void enable();
+  void disable() { enabled_ = false; }
+  bool enabled() const { return enabled_; }
+
+  void disableOnCompletion() { disable_on_completion_ = true; }
+  void interruptAtCompletion() { interrupt_at_completion_ = true; }
+  void attachInterrupt(void (*isr)()) { isr_ = isr; }
+  void clearInterrupt() { }
+  void clearComplete() { }
+
+  void triggerAtHardwareEvent(uint8_t source) { source_ = source; }
+  void triggerAtTransfersOf(DMAChannel &) { }
+  void triggerAtCompletionOf(DMAChannel &) { }
+
+  void source(volatile const uint8_t &p) { TCD->SADDR = &p; }
+  void sourceBuffer(volatile const uint8_t *p, unsigned int len) {
+    TCD->SADDR = p;
+    TCD->NBYTES = len;
+  }
+  void destination(volatile uint8_t &p) { TCD->DADDR = &p; }
+  void transferSize(unsigned int) { }
+  void transferCount(unsigned int len) { TCD->CITER = TCD->BITER = len; }
+
+  // Complete the current (major loop) transfer
+  void Complete() {
+    if (disable_on_completion_)
+      enabled_ = false;
+    if (interrupt_at_completion_ && isr_)
+      isr_();
+  }
+
+  uint8_t source_id() const { return source_; }
+
+  TCD_t *TCD;
+  uint8_t channel;
+
+  static DMAChannel *find(uint8_t source);
+
+private:
+  TCD_t tcd_;
+  bool enabled_;
+  bool disable_on_completion_;
+  bool interrupt_at_completion_;
+  void (*isr_)();
+  uint8_t source_;
+  DMAChannel *next_;
+
+  static DMAChannel *channels_;
+
+  DMAChannel(const DMAChannel &);
+  void operator=(const DMAChannel &);
+};
+
+#endif // OC_SIM_DMACHANNEL_H_
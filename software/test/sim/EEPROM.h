@@ -0,0 +1,64 @@
+#ifndef OC_SIM_EEPROM_H_
+#define OC_SIM_EEPROM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// EEPROM stand-in backed by a RAM array; oc_sim::eeprom_writes counts the
+// number of bytes that were actually written. Once oc_sim::eeprom_write_budget
+// bytes have been written, further writes are dropped as if the power went
+// out.
+
+namespace oc_sim {
+static const size_t kEEPROMSize = 2048;
+extern uint8_t eeprom[kEEPROMSize];
+extern uint32_t eeprom_writes;
+extern uint32_t eeprom_write_budget;
+};
+
+struct EERef {
+  EERef(int index) : index(index) { }
+
+  operator uint8_t() const { return oc_sim::eeprom[index]; }
+
+  EERef &operator=(uint8_t value) {
+    if (oc_sim::eeprom_write_budget) {
+      --oc_sim::eeprom_write_budget;
+      oc_sim::eeprom[index] = value;
+      ++oc_sim::eeprom_writes;
+    }
+    return *this;
+  }
+
+  EERef &update(uint8_t value) {
+    if (oc_sim::eeprom[index] != value)
+      *this = value;
+    return *this;
+  }
+
+  int index;
+};
+
+struct EEPtr {
+  EEPtr(int index) : index(index) { }
+
+  operator int() const { return index; }
+  EERef operator*() { return EERef(index); }
+  EEPtr &operator++() { ++index; return *this; }
+  EEPtr operator++(int) { return EEPtr(index++); }
+
+  int index;
+};
+
+class EEPROMClass {
+public:
+  uint8_t read(int idx) { return EERef(idx).operator uint8_t(); }
+  void write(int idx, uint8_t val) { EERef ref(idx); ref = val; }
+  void update(int idx, uint8_t val) { EERef(idx).update(val); }
+  EERef operator[](int idx) { return EERef(idx); }
+  uint16_t length() { return oc_sim::kEEPROMSize; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // OC_SIM_EEPROM_H_
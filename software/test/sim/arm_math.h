@@ -0,0 +1,4 @@
+#ifndef OC_SIM_ARM_MATH_H_
+#define OC_SIM_ARM_MATH_H_
+// CMSIS-DSP is included but not used by the firmware
+#endif // OC_SIM_ARM_MATH_H_
@@ -0,0 +1,167 @@
+#include "Arduino.h"
+#include "OC_apps.h"
+#include "OC_calibration.h"
+#include "OC_core.h"
+#include "OC_gpio.h"
+#include "OC_menus.h"
+#include "OC_ui.h"
+#include "src/drivers/display.h"
+#include "src/drivers/SH1106_128x64_driver.h"
+#include "oc_sim.h"
+
+// Defined in the sketch
+void CORE_timer_ISR();
+void UI_timer_ISR();
+void redraw_display();
+extern uint_fast8_t MENU_REDRAW;
+void calibration_load();
+extern OC::App available_apps[];
+
+namespace OC {
+namespace apps {
+void set_current_app(int index);
+};
+};
+
+namespace oc_sim {
+
+extern const size_t kNumAvailableApps;
+
+/*static*/ std::vector<DacFrame> *Simulator::capture_ = nullptr;
+
+/*static*/ void Simulator::Boot() {
+  hardware.Reset();
+
+  OC::CORE::app_isr_enabled = false;
+  OC::CORE::ticks = 0;
+
+  OC::DigitalInputs::Init();
+  OC::ADC::Init(&OC::calibration_data.adc);
+  OC::ADC::Init_DMA();
+  OC::DAC::Init(&OC::calibration_data.dac);
+#ifdef OC_DAC_DMA
+  OC::DAC::Init_DMA(SH1106_128x64_Driver::spi_tx_dma());
+#endif
+  display::Init();
+
+  calibration_load();
+  display::AdjustOffset(OC::calibration_data.display_offset);
+
+  OC::menu::Init();
+  OC::ui.Init();
+  OC::ui.configure_encoders(OC::calibration_data.encoder_config());
+  OC::ui.set_screensaver_timeout(OC::calibration_data.screensaver_timeout);
+  for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+    OC::ADC::set_filter_preset(static_cast<ADC_CHANNEL>(channel), OC::calibration_data.adc_filter_preset(static_cast<ADC_CHANNEL>(channel)));
+
+  // Inputs at 0V
+  for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+    SetCV(static_cast<ADC_CHANNEL>(channel), 0);
+
+  OC::apps::Init(false);
+  OC::CORE::app_isr_enabled = true;
+}
+
+/*static*/ bool Simulator::SelectApp(uint16_t app_id) {
+  int index = OC::apps::index_of(app_id);
+  if (index < 0 || static_cast<size_t>(index) >= kNumAvailableApps)
+    return false;
+
+  OC::CORE::app_isr_enabled = false;
+  OC::apps::current_app->HandleAppEvent(OC::APP_EVENT_SUSPEND);
+  OC::apps::set_current_app(index);
+  OC::DigitalInputs::reInit();
+  OC::apps::current_app->HandleAppEvent(OC::APP_EVENT_RESUME);
+  OC::CORE::app_isr_enabled = true;
+  return true;
+}
+
+/*static*/ size_t Simulator::num_apps() {
+  return kNumAvailableApps;
+}
+
+/*static*/ uint16_t Simulator::app_id(size_t index) {
+  return available_apps[index].id;
+}
+
+/*static*/ const char *Simulator::app_name(size_t index) {
+  return available_apps[index].name;
+}
+
+/*static*/ void Simulator::SetCV(ADC_CHANNEL channel, int32_t value) {
+  // ADC::value = offset - (sample >> 4), where the 16-bit sample is reduced
+  // to kAdcResolution bits
+  int32_t sample = OC::calibration_data.adc.offset[channel] - value;
+  sample <<= (OC::ADC::kAdcScanResolution - OC::ADC::kAdcResolution);
+  SetRawCV(channel, sample < 0 ? 0 : sample > 0xffff ? 0xffff : sample);
+}
+
+/*static*/ void Simulator::SetRawCV(ADC_CHANNEL channel, uint16_t sample) {
+  hardware.adc_samples[channel] = sample;
+}
+
+/*static*/ void Simulator::SetGate(OC::DigitalInput input, bool high) {
+  static const uint8_t input_pins[OC::DIGITAL_INPUT_LAST] = { TR1, TR2, TR3, TR4 };
+
+  Pin &pin = pins[input_pins[input]];
+  uint8_t level = high ? LOW : HIGH;
+  if (level != pin.level) {
+    pin.level = level;
+    if (pin.isr) {
+      if ((FALLING == pin.isr_mode && LOW == level) ||
+          (RISING == pin.isr_mode && HIGH == level) ||
+          CHANGE == pin.isr_mode)
+        pin.isr();
+    }
+  }
+}
+
+/*static*/ void Simulator::Tick(uint32_t ticks) {
+  while (ticks--) {
+    hardware.now_us += OC_CORE_TIMER_RATE;
+
+    if (++hardware.adc_ticks >= kAdcTicksPerScan) {
+      hardware.adc_ticks = 0;
+      hardware.RunAdcConversion();
+    }
+
+    CORE_timer_ISR();
+    if (!(OC::CORE::ticks % kUiTicks))
+      UI_timer_ISR();
+
+    if (capture_)
+      capture_->push_back(dac_frame());
+  }
+}
+
+/*static*/ void Simulator::Loop() {
+  OC::apps::current_app->loop();
+}
+
+/*static*/ void Simulator::Redraw() {
+  MENU_REDRAW = 1;
+  redraw_display();
+}
+
+/*static*/ uint32_t Simulator::ticks() {
+  return OC::CORE::ticks;
+}
+
+/*static*/ DacFrame Simulator::dac_frame() {
+  DacFrame frame;
+  for (size_t channel = 0; channel < DAC_CHANNEL_LAST; ++channel) {
+#ifdef FLIP_180
+    uint16_t word = hardware.dac_words[DAC_CHANNEL_LAST - 1 - channel];
+#else
+    uint16_t word = hardware.dac_words[channel];
+#endif
+#ifdef BUCHLA_cOC
+    frame.values[channel] = word;
+#else
+    frame.values[channel] = OC::DAC::MAX_VALUE - word;
+#endif
+  }
+  return frame;
+}
+
+}; // namespace oc_sim
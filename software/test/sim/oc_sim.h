@@ -0,0 +1,113 @@
+#ifndef OC_SIM_H_
+#define OC_SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "OC_config.h"
+#include "OC_ADC.h"
+#include "OC_DAC.h"
+#include "OC_digital_inputs.h"
+
+// Host-side simulator for the core ISR. It links the real firmware (sketch,
+// apps, drivers) against a stand-in hardware layer, and drives the core timer
+// ISR in virtual time so that runs are deterministic and can be compared.
+//
+// NOTE All firmware state is global, so there is only one simulator.
+
+namespace oc_sim {
+
+struct Hardware {
+  // Virtual time, advanced by OC_CORE_TIMER_RATE per core tick
+  uint32_t now_us;
+  uint32_t random_state;
+
+  uint32_t spi_command;
+  bool spi_command_pending;
+  // Last words sent to each DAC channel (by address, i.e. as on the wire)
+  uint16_t dac_words[4];
+  uint32_t dac_writes;
+
+  // 16-bit samples returned for each ADC input
+  uint16_t adc_samples[4];
+  uint32_t adc_ticks;
+  uint32_t adc_conversions;
+
+  uint8_t display[128 * 64 / 8];
+  uint32_t display_pages;
+
+  void Reset();
+  void RunAdcConversion();
+  // Write an entry to SPI0_PUSHR; 16-bit frames use CTAR1
+  void SpiPush(uint32_t pushr);
+  // Run pending DMA transfers to SPI0_PUSHR
+  void RunSpiDma();
+};
+
+extern Hardware hardware;
+
+// DAC values after one core tick, in OC::DAC units (0 - DAC::MAX_VALUE)
+struct DacFrame {
+  uint16_t values[DAC_CHANNEL_LAST];
+
+  bool operator==(const DacFrame &other) const {
+    for (size_t i = 0; i < DAC_CHANNEL_LAST; ++i)
+      if (values[i] != other.values[i]) return false;
+    return true;
+  }
+};
+
+class Simulator {
+public:
+  // The ADC DMA completes a scan every few core ticks (~5.5kHz)
+  static constexpr uint32_t kAdcTicksPerScan = 3;
+  static constexpr uint32_t kUiTicks = OC_UI_TIMER_RATE / OC_CORE_TIMER_RATE;
+
+  // Reset the hardware (including a blank EEPROM) and run the firmware init
+  // sequence from setup(), minus the splash screen.
+  static void Boot();
+
+  // Switch to app by id, like the app settings menu does
+  static bool SelectApp(uint16_t app_id);
+  static size_t num_apps();
+  static uint16_t app_id(size_t index);
+  static const char *app_name(size_t index);
+
+  // Set ADC input so that OC::ADC::value(channel) settles to value
+  static void SetCV(ADC_CHANNEL channel, int32_t value);
+  // Set raw 16-bit ADC sample for channel
+  static void SetRawCV(ADC_CHANNEL channel, uint16_t sample);
+
+  // Gate input high/low as seen at the jack; the rising edge (i.e. falling
+  // edge on the inverted input pin) clocks the input.
+  static void SetGate(OC::DigitalInput input, bool high);
+  static void Trigger(OC::DigitalInput input) {
+    SetGate(input, true);
+    SetGate(input, false);
+  }
+
+  // Run core ticks. If capture is set, a frame is appended for each tick.
+  static void Tick(uint32_t ticks = 1);
+
+  // Run the app's loop function once, as the main loop would
+  static void Loop();
+
+  // Refresh the display once as the main loop would, i.e. the menu is only
+  // redrawn if it might have changed
+  static void Redraw();
+
+  static void set_capture(std::vector<DacFrame> *capture) {
+    capture_ = capture;
+  }
+
+  static uint32_t ticks();
+  static DacFrame dac_frame();
+
+private:
+  static std::vector<DacFrame> *capture_;
+};
+
+}; // namespace oc_sim
+
+#endif // OC_SIM_H_
@@ -0,0 +1,235 @@
+// Per-app ISR benchmark: runs each app's isr for a number of ticks with
+// scripted inputs and reports the host time per tick (mean, percentiles and
+// worst case). For apps with a block setup (\sa OC::kAppBlockSize), the setup
+// is counted in the tick it runs in. With a baseline file, it fails if an app
+// got slower than the baseline allows.
+//
+// oc_sim_bench [-n ticks] [-r runs] [-a app] [-b baseline] [-w] [-t tolerance%]
+//
+// Host timings are noisy, so each app is run several times and the fastest
+// run is reported; this filters out most interference from other processes.
+//
+// The baseline is a text file with one line per app:
+// <app id> <mean ns> <p99 ns>
+// Host timings are only comparable on the same machine, so the baseline is
+// best written (-w) before making changes and checked after.
+
+#include <getopt.h>
+#include <strings.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
+#include "oc_sim.h"
+#include "OC_apps.h"
+
+using oc_sim::Simulator;
+
+namespace {
+
+struct Stats {
+  double mean;
+  uint32_t p50, p90, p99, p999, max;
+  uint32_t max_tick;
+};
+
+std::vector<uint32_t> samples;
+void (*app_isr)() = nullptr;
+void (*app_begin_block)() = nullptr;
+bool begin_block_pending = false;
+std::chrono::steady_clock::time_point begin_block_start;
+
+void timed_isr() {
+  auto start = begin_block_pending ? begin_block_start : std::chrono::steady_clock::now();
+  app_isr();
+  auto end = std::chrono::steady_clock::now();
+  samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  begin_block_pending = false;
+}
+
+// Runs before the isr in the same tick, which then times both
+void timed_begin_block() {
+  begin_block_start = std::chrono::steady_clock::now();
+  begin_block_pending = true;
+  app_begin_block();
+}
+
+uint32_t percentile(std::vector<uint32_t> &sorted, double p) {
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+// Default scenario: CV inputs sweep slowly, each trigger input is clocked at
+// a different rate.
+void RunScenario(uint32_t ticks) {
+  static const uint32_t kTriggerPeriods[OC::DIGITAL_INPUT_LAST] = { 200, 333, 1000, 4000 };
+
+  for (uint32_t tick = 0; tick < ticks; ++tick) {
+    if (!(tick % 64)) {
+      for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel) {
+        int32_t phase = ((tick >> 6) + channel * 256) & 0x3ff;
+        Simulator::SetCV(static_cast<ADC_CHANNEL>(channel), (phase < 512 ? phase : 1023 - phase) * 4 - 1024);
+      }
+    }
+    for (int input = OC::DIGITAL_INPUT_1; input < OC::DIGITAL_INPUT_LAST; ++input) {
+      uint32_t period = kTriggerPeriods[input];
+      Simulator::SetGate(static_cast<OC::DigitalInput>(input), (tick % period) < period / 2);
+    }
+
+    Simulator::Tick();
+    if (!(tick % Simulator::kUiTicks))
+      Simulator::Loop();
+  }
+}
+
+Stats Benchmark(uint32_t ticks) {
+  samples.clear();
+  samples.reserve(ticks);
+  OC::App *app = OC::apps::current_app;
+  app_isr = app->isr;
+  app_begin_block = app->BeginBlock;
+  app->isr = timed_isr;
+  if (app_begin_block)
+    app->BeginBlock = timed_begin_block;
+  RunScenario(ticks);
+  app->isr = app_isr;
+  app->BeginBlock = app_begin_block;
+
+  Stats stats;
+  stats.max_tick = std::max_element(samples.begin(), samples.end()) - samples.begin();
+  double sum = 0;
+  for (auto s : samples)
+    sum += s;
+  stats.mean = sum / samples.size();
+
+  std::sort(samples.begin(), samples.end());
+  stats.p50 = percentile(samples, 0.5);
+  stats.p90 = percentile(samples, 0.9);
+  stats.p99 = percentile(samples, 0.99);
+  stats.p999 = percentile(samples, 0.999);
+  stats.max = samples.back();
+  return stats;
+}
+
+Stats Benchmark(size_t app, uint32_t ticks, int runs) {
+  Simulator::SelectApp(Simulator::app_id(app));
+
+  // Let the app settle before measuring
+  RunScenario(OC_CORE_ISR_FREQ / 10);
+
+  Stats best = Benchmark(ticks);
+  while (--runs > 0) {
+    Stats stats = Benchmark(ticks);
+    if (stats.mean < best.mean)
+      best = stats;
+  }
+  return best;
+}
+
+struct Baseline {
+  double mean;
+  uint32_t p99;
+};
+
+bool ReadBaseline(const char *filename, std::map<uint16_t, Baseline> &baseline) {
+  FILE *f = fopen(filename, "r");
+  if (!f)
+    return false;
+  unsigned id;
+  double mean;
+  unsigned p99;
+  while (3 == fscanf(f, "%x %lf %u", &id, &mean, &p99))
+    baseline[id] = { mean, p99 };
+  fclose(f);
+  return true;
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n ticks] [-r runs] [-a app] [-b baseline] [-w] [-t tolerance]\n", name);
+  fprintf(stderr, "  -n ticks      ticks per run (default: 1000000)\n");
+  fprintf(stderr, "  -r runs       runs per app, fastest is used (default: 3)\n");
+  fprintf(stderr, "  -a app        only run app (id or name)\n");
+  fprintf(stderr, "  -b baseline   baseline file to check against (or write)\n");
+  fprintf(stderr, "  -w            write baseline instead of checking\n");
+  fprintf(stderr, "  -t tolerance  allowed slowdown in %% (default: 25)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  uint32_t ticks = 1000000;
+  int runs = 3;
+  const char *app_filter = nullptr;
+  const char *baseline_file = nullptr;
+  bool write_baseline = false;
+  double tolerance = 25.0;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:a:b:wt:h")) != -1) {
+    switch (c) {
+      case 'n': ticks = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      case 'a': app_filter = optarg; break;
+      case 'b': baseline_file = optarg; break;
+      case 'w': write_baseline = true; break;
+      case 't': tolerance = atof(optarg); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  std::map<uint16_t, Baseline> baseline;
+  if (baseline_file && !write_baseline && !ReadBaseline(baseline_file, baseline)) {
+    fprintf(stderr, "Failed to read baseline '%s'\n", baseline_file);
+    return 1;
+  }
+
+  FILE *out = nullptr;
+  if (baseline_file && write_baseline) {
+    out = fopen(baseline_file, "w");
+    if (!out) {
+      fprintf(stderr, "Failed to write baseline '%s'\n", baseline_file);
+      return 1;
+    }
+  }
+
+  Simulator::Boot();
+
+  printf("%-20s %4s %8s %6s %6s %6s %6s %7s %9s\n",
+         "app", "id", "mean", "p50", "p90", "p99", "p99.9", "max", "max@tick");
+  int failures = 0;
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    uint16_t id = Simulator::app_id(app);
+    if (app_filter && strcasecmp(app_filter, Simulator::app_name(app)) &&
+        strtoul(app_filter, nullptr, 16) != id)
+      continue;
+
+    Stats stats = Benchmark(app, ticks, runs);
+    printf("%-20s %04x %8.1f %6u %6u %6u %6u %7u %9u",
+           Simulator::app_name(app), id, stats.mean,
+           stats.p50, stats.p90, stats.p99, stats.p999, stats.max, stats.max_tick);
+
+    if (out) {
+      fprintf(out, "%04x %.1f %u\n", id, stats.mean, stats.p99);
+    } else if (!baseline.empty()) {
+      auto b = baseline.find(id);
+      if (b == baseline.end()) {
+        printf("  (no baseline)");
+      } else {
+        double limit = 1.0 + tolerance / 100.0;
+        bool fail = stats.mean > b->second.mean * limit || stats.p99 > b->second.p99 * limit;
+        printf("  %+.0f%% %s", (stats.mean / b->second.mean - 1.0) * 100.0, fail ? "FAIL" : "ok");
+        if (fail)
+          ++failures;
+      }
+    }
+    printf("\n");
+  }
+  if (out)
+    fclose(out);
+
+  if (failures)
+    printf("%d app(s) exceeded baseline by more than %.0f%%\n", failures, tolerance);
+  return failures ? 1 : 0;
+}
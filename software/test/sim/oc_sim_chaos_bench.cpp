@@ -0,0 +1,156 @@
+// Chaotic oscillator benchmark: host time per step of util::ChaoticOscillators
+// for 1-8 instances of each system, with per-tick sized steps, compared with
+// streams::LorenzGenerator::Process (two Lorenz and two Rossler systems, plus
+// output mapping) per tick and at control rate. For the generator, the mean
+// and the worst case per tick are reported; the worst case is the slowest
+// position within the control period, since the work per tick depends on it.
+//
+// oc_sim_chaos_bench [-n steps] [-r runs]
+//
+// As with oc_sim_bench, the fastest of several runs is reported.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "streams_lorenz_generator.h"
+#include "util/util_chaotic_oscillators.h"
+
+namespace {
+
+volatile uint32_t sink;
+
+static streams::LorenzGenerator lorenz_generator;
+
+template <typename F>
+double Fastest(int runs, F f) {
+  double best = f();
+  while (--runs > 0)
+    best = std::min(best, f());
+  return best;
+}
+
+// ns per step
+template <typename System, size_t N>
+double BenchmarkStep(size_t steps, uint8_t integrator) {
+  static util::ChaoticOscillators<System, N> oscillators;
+  oscillators.Init();
+  for (size_t i = 0; i < N; ++i)
+    oscillators.set_dt(i, 20000 + 1000 * i);
+
+  uint32_t values = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t step = 0; step < steps; ++step) {
+    oscillators.Step(integrator);
+    values += oscillators.x(step & (N - 1));
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = values;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / steps;
+}
+
+struct Timing {
+  double mean;
+  double worst;
+};
+
+// Each call is timed separately, less the overhead of the clock
+Timing BenchmarkLorenzGenerator(size_t steps, uint8_t control_rate, uint8_t integrator) {
+  lorenz_generator.Init(0);
+  lorenz_generator.Init(1);
+  lorenz_generator.set_rho1(63 << 8);
+  lorenz_generator.set_rho2(63 << 8);
+  lorenz_generator.set_control_rate(control_rate);
+  lorenz_generator.set_integrator(integrator);
+
+  const size_t period = 1 << control_rate;
+  std::vector<uint64_t> phase_ns(period, 0);
+  uint64_t clock_ns = 0;
+  uint32_t values = 0;
+  for (size_t step = 0; step < steps; ++step) {
+    auto start = std::chrono::steady_clock::now();
+    lorenz_generator.Process(200 << 8, 200 << 8, false, false, 2, 2);
+    auto end = std::chrono::steady_clock::now();
+    values += lorenz_generator.dac_code(step & 3);
+    phase_ns[step & (period - 1)] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    end = std::chrono::steady_clock::now();
+    clock_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  }
+  sink = values;
+
+  const double clock = static_cast<double>(clock_ns) / steps;
+  Timing timing = { 0, 0 };
+  for (size_t phase = 0; phase < period; ++phase) {
+    const double ns = static_cast<double>(phase_ns[phase]) / ((steps + period - 1 - phase) / period) - clock;
+    timing.mean += ns / period;
+    timing.worst = std::max(timing.worst, ns);
+  }
+  return timing;
+}
+
+void ReportLorenzGenerator(const char *name, size_t steps, int runs, uint8_t control_rate, uint8_t integrator) {
+  Timing best = BenchmarkLorenzGenerator(steps, control_rate, integrator);
+  while (--runs > 0) {
+    Timing timing = BenchmarkLorenzGenerator(steps, control_rate, integrator);
+    best.mean = std::min(best.mean, timing.mean);
+    best.worst = std::min(best.worst, timing.worst);
+  }
+  printf("%-10s %3u %10.2f %10.2f\n", name, control_rate, best.mean, best.worst);
+}
+
+template <typename System, size_t N>
+void Report(const char *name, size_t steps, int runs) {
+  double euler = Fastest(runs, [&]{ return BenchmarkStep<System, N>(steps, util::CHAOTIC_INTEGRATOR_EULER); });
+  double heun = Fastest(runs, [&]{ return BenchmarkStep<System, N>(steps, util::CHAOTIC_INTEGRATOR_HEUN); });
+  printf("%-10s %3zu %10.2f %10.2f\n", name, N, euler, heun);
+}
+
+template <typename System>
+void Report(const char *name, size_t steps, int runs) {
+  Report<System, 1>(name, steps, runs);
+  Report<System, 2>(name, steps, runs);
+  Report<System, 4>(name, steps, runs);
+  Report<System, 8>(name, steps, runs);
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n steps] [-r runs]\n", name);
+  fprintf(stderr, "  -n steps      steps per run (default: 1000000)\n");
+  fprintf(stderr, "  -r runs       runs per case, fastest is used (default: 5)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  size_t steps = 1000000;
+  int runs = 5;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:h")) != -1) {
+    switch (c) {
+      case 'n': steps = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  printf("%-10s %3s %10s %10s\n", "system", "N", "euler", "heun");
+  Report<util::LorenzSystem>("Lorenz", steps, runs);
+  Report<util::RosslerSystem>("Rossler", steps, runs);
+  Report<util::LogisticSystem>("Logistic", steps, runs);
+  printf("(ns per step)\n\n");
+
+  printf("%-10s %3s %10s %10s\n", "Process", "cr", "mean", "worst");
+  ReportLorenzGenerator("Euler", steps, runs, 0, streams::LORENZ_INTEGRATOR_EULER);
+  ReportLorenzGenerator("Heun", steps, runs, 0, streams::LORENZ_INTEGRATOR_HEUN);
+  for (uint8_t control_rate = 2; control_rate <= streams::kMaxControlRateShift; control_rate += 2)
+    ReportLorenzGenerator("Heun", steps, runs, control_rate, streams::LORENZ_INTEGRATOR_HEUN);
+  printf("(ns per tick, cr = control rate shift)\n");
+  return 0;
+}
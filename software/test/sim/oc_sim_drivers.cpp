@@ -0,0 +1,59 @@
+// Stand-ins for the drivers that talk to the hardware directly (and in the
+// case of the display, busy-wait on SPI status registers).
+
+#include "Arduino.h"
+#include "DMAChannel.h"
+#include "src/drivers/SH1106_128x64_driver.h"
+#include "src/drivers/FreqMeasure/OC_FreqMeasure.h"
+#include "oc_sim.h"
+
+/*static*/ void SH1106_128x64_Driver::Init() {
+  Clear();
+}
+
+/*static*/ void SH1106_128x64_Driver::Clear() {
+  memset(oc_sim::hardware.display, 0, sizeof(oc_sim::hardware.display));
+}
+
+/*static*/ void SH1106_128x64_Driver::Flush() {
+}
+
+/*static*/ void SH1106_128x64_Driver::SendPage(uint_fast8_t index, const uint8_t *data) {
+  memcpy(oc_sim::hardware.display + index * kPageSize, data, kPageSize);
+  ++oc_sim::hardware.display_pages;
+}
+
+/*static*/ void SH1106_128x64_Driver::SPI_send(void *bufr, size_t n) {
+  (void)bufr;
+  (void)n;
+}
+
+/*static*/ void SH1106_128x64_Driver::AdjustOffset(uint8_t offset) {
+  (void)offset;
+}
+
+static DMAChannel page_dma;
+
+/*static*/ DMAChannel &SH1106_128x64_Driver::spi_tx_dma() {
+  return page_dma;
+}
+
+FreqMeasureClass FreqMeasure;
+
+/*static*/ void FreqMeasureClass::begin() {
+}
+
+/*static*/ uint8_t FreqMeasureClass::available() {
+  return 0;
+}
+
+/*static*/ uint32_t FreqMeasureClass::read() {
+  return 0xffffffff;
+}
+
+/*static*/ float FreqMeasureClass::countToFrequency(uint32_t count) {
+  return (float)F_BUS / (float)count;
+}
+
+/*static*/ void FreqMeasureClass::end() {
+}
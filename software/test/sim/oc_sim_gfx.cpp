@@ -0,0 +1,145 @@
+// Menu drawing benchmark: draws each app's menu and screensaver at several
+// points of a scripted run, and reports the host time per frame.
+//
+// oc_sim_gfx [-n frames] [-o file] [-c file]
+//
+// Frames can be written to a file (-o) and compared against a file (-c). The
+// Makefile uses this to check that the drawing functions produce the same
+// frames as the reference implementation (oc_sim_gfx_ref, linked against
+// sim/weegfx_reference.cpp).
+
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "oc_sim.h"
+#include "OC_apps.h"
+#include "src/drivers/display.h"
+
+using oc_sim::Simulator;
+
+namespace {
+
+static const int kNumSnapshots = 8;
+static const uint32_t kSnapshotTicks = 1000;
+
+uint8_t frame[weegfx::Graphics::kFrameSize] __attribute__ ((aligned (4)));
+
+// @return fastest time for drawing the frame, in ns
+double Draw(void (*draw)(), int frames) {
+  double best = 0;
+  for (int i = 0; i < frames; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    graphics.Begin(frame, true);
+    draw();
+    graphics.End();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    if (!i || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+void RunScenario(uint32_t ticks) {
+  static const uint32_t kTriggerPeriods[OC::DIGITAL_INPUT_LAST] = { 200, 333, 1000, 4000 };
+
+  for (uint32_t tick = 0; tick < ticks; ++tick) {
+    uint32_t t = Simulator::ticks();
+    if (!(t % 64)) {
+      for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+        Simulator::SetCV(static_cast<ADC_CHANNEL>(channel), ((t >> 4) + channel * 512) % 2048 - 1024);
+    }
+    for (int input = OC::DIGITAL_INPUT_1; input < OC::DIGITAL_INPUT_LAST; ++input) {
+      uint32_t period = kTriggerPeriods[input];
+      Simulator::SetGate(static_cast<OC::DigitalInput>(input), (t % period) < period / 2);
+    }
+    Simulator::Tick();
+    if (!(t % Simulator::kUiTicks))
+      Simulator::Loop();
+  }
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n frames] [-o file] [-c file]\n", name);
+  fprintf(stderr, "  -n frames  frames drawn per snapshot, fastest is used (default: 20)\n");
+  fprintf(stderr, "  -o file    write frames to file\n");
+  fprintf(stderr, "  -c file    compare frames with file\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  int frames = 20;
+  const char *out_file = nullptr;
+  const char *compare_file = nullptr;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:o:c:h")) != -1) {
+    switch (c) {
+      case 'n': frames = std::max(1, atoi(optarg)); break;
+      case 'o': out_file = optarg; break;
+      case 'c': compare_file = optarg; break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  FILE *out = out_file ? fopen(out_file, "wb") : nullptr;
+  FILE *compare = compare_file ? fopen(compare_file, "rb") : nullptr;
+  if ((out_file && !out) || (compare_file && !compare)) {
+    fprintf(stderr, "Failed to open '%s'\n", out_file && !out ? out_file : compare_file);
+    return 1;
+  }
+
+  Simulator::Boot();
+
+  printf("%-20s %4s %10s %10s %s\n", "app", "id", "menu", "saver", compare ? "frames" : "");
+  double total = 0;
+  int mismatches = 0;
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    Simulator::SelectApp(Simulator::app_id(app));
+    OC::App *current_app = OC::apps::current_app;
+
+    double menu = 0, screensaver = 0;
+    int app_mismatches = 0;
+    for (int snapshot = 0; snapshot < kNumSnapshots; ++snapshot) {
+      RunScenario(kSnapshotTicks);
+      for (auto draw : { current_app->DrawMenu, current_app->DrawScreensaver }) {
+        double ns = Draw(draw, frames);
+        if (draw == current_app->DrawMenu)
+          menu += ns;
+        else
+          screensaver += ns;
+
+        if (out)
+          fwrite(frame, sizeof(frame), 1, out);
+        if (compare) {
+          uint8_t expected[sizeof(frame)];
+          if (1 != fread(expected, sizeof(expected), 1, compare) || memcmp(expected, frame, sizeof(frame)))
+            ++app_mismatches;
+        }
+      }
+    }
+    menu /= kNumSnapshots;
+    screensaver /= kNumSnapshots;
+    total += menu;
+
+    printf("%-20s %04x %10.0f %10.0f", Simulator::app_name(app), Simulator::app_id(app), menu, screensaver);
+    if (compare)
+      printf(" %s", app_mismatches ? "DIFFERENT" : "ok");
+    printf("\n");
+    mismatches += app_mismatches;
+  }
+  printf("Total menu: %.0f ns\n", total);
+
+  if (out)
+    fclose(out);
+  if (compare)
+    fclose(compare);
+
+  if (mismatches)
+    printf("%d frame(s) differ\n", mismatches);
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// Simulated hardware: registers, pins, SPI bus, EEPROM, DMA and clocks.
+
+#include <chrono>
+#include "Arduino.h"
+#include "DMAChannel.h"
+#include "EEPROM.h"
+#include "oc_sim.h"
+
+namespace oc_sim {
+
+namespace registers {
+#define OC_SIM_DEFINE_REGISTER(name) volatile uint32_t name##_;
+OC_SIM_REGISTER_LIST(OC_SIM_DEFINE_REGISTER)
+#undef OC_SIM_DEFINE_REGISTER
+}; // namespace registers
+
+Pin pins[CORE_NUM_DIGITAL];
+uint8_t eeprom[kEEPROMSize];
+uint32_t eeprom_writes = 0;
+uint32_t eeprom_write_budget = UINT32_MAX;
+
+Hardware hardware;
+
+// Time is virtual, and only advances when the simulator says so.
+uint32_t millis() {
+  return hardware.now_us / 1000;
+}
+
+uint32_t micros() {
+  return hardware.now_us;
+}
+
+void delay_us(uint32_t us) {
+  hardware.now_us += us;
+}
+
+uint32_t cycle_count() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+  return static_cast<uint32_t>(ns * (F_CPU / 1000000) / 1000);
+}
+
+uint32_t random(uint32_t howbig) {
+  // xorshift32, so runs are reproducible
+  uint32_t x = hardware.random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  hardware.random_state = x;
+  return x % howbig;
+}
+
+// The DAC (DAC8565) is addressed by a command byte followed by a 16-bit word;
+// the channel address is in bits 1-2 of the command.
+void spi_write(uint32_t b, uint32_t cont) {
+  (void)cont;
+  hardware.spi_command = b;
+  hardware.spi_command_pending = true;
+}
+
+void spi_write16(uint32_t w, uint32_t cont) {
+  (void)cont;
+  if (hardware.spi_command_pending) {
+    hardware.spi_command_pending = false;
+    size_t channel = (hardware.spi_command >> 1) & 0x3;
+    hardware.dac_words[channel] = w;
+    ++hardware.dac_writes;
+  }
+}
+
+void Hardware::Reset() {
+  now_us = 0;
+  random_state = 0x12345678;
+  spi_command = 0;
+  spi_command_pending = false;
+  std::fill(dac_words, dac_words + 4, 0);
+  dac_writes = 0;
+  std::fill(adc_samples, adc_samples + 4, 0);
+  adc_ticks = 0;
+  adc_conversions = 0;
+  std::fill(eeprom, eeprom + kEEPROMSize, 0xff);
+  eeprom_writes = 0;
+  eeprom_write_budget = UINT32_MAX;
+  for (auto &pin : pins) {
+    pin.config = pin.mode = 0;
+    pin.level = HIGH;
+    pin.isr = nullptr;
+    pin.isr_mode = 0;
+  }
+}
+
+void Hardware::RunAdcConversion() {
+  DMAChannel *dma = DMAChannel::find(DMAMUX_SOURCE_ADC0);
+  if (!dma || !dma->enabled() || !dma->TCD->DADDR)
+    return;
+
+  // The second DMA channel cycles the ADC mux through the four inputs, so the
+  // samples end up interleaved in the buffer.
+  volatile uint16_t *dst = static_cast<volatile uint16_t *>(dma->TCD->DADDR);
+  for (size_t i = 0; i < dma->TCD->BITER; ++i)
+    dst[i] = adc_samples[i & 0x3];
+  ++adc_conversions;
+  dma->Complete();
+}
+
+void Hardware::SpiPush(uint32_t pushr) {
+  if (pushr & SPI_PUSHR_CTAS(1))
+    spi_write16(pushr & 0xffff, pushr & SPI_PUSHR_CONT);
+  else
+    spi_write(pushr & 0xff, pushr & SPI_PUSHR_CONT);
+  if (pushr & SPI_PUSHR_EOQ)
+    SPI0_SR |= SPI_SR_EOQF;
+}
+
+void Hardware::RunSpiDma() {
+  DMAChannel *dma = DMAChannel::find(DMAMUX_SOURCE_SPI0_TX);
+  if (!dma || !dma->enabled())
+    return;
+
+  const volatile uint32_t *src = static_cast<const volatile uint32_t *>(dma->TCD->SADDR);
+  for (size_t i = 0; i < dma->TCD->BITER; ++i)
+    SpiPush(src[i]);
+  dma->Complete();
+}
+
+}; // namespace oc_sim
+
+/*static*/ DMAChannel *DMAChannel::channels_ = nullptr;
+
+DMAChannel::DMAChannel(bool allocate)
+: TCD(&tcd_)
+, enabled_(false)
+, disable_on_completion_(false)
+, interrupt_at_completion_(false)
+, isr_(nullptr)
+, source_(0)
+, next_(channels_) {
+  memset(&tcd_, 0, sizeof(tcd_));
+  channel = channels_ ? channels_->channel + 1 : 0;
+  channels_ = this;
+  if (allocate)
+    begin();
+}
+
+DMAChannel::~DMAChannel() {
+  DMAChannel **c = &channels_;
+  while (*c && *c != this)
+    c = &(*c)->next_;
+  if (*c)
+    *c = next_;
+}
+
+void DMAChannel::begin(bool force_initialization) {
+  if (force_initialization) {
+    memset(&tcd_, 0, sizeof(tcd_));
+    enabled_ = disable_on_completion_ = interrupt_at_completion_ = false;
+    isr_ = nullptr;
+    source_ = 0;
+  }
+}
+
+void DMAChannel::enable() {
+  enabled_ = true;
+  if (DMAMUX_SOURCE_SPI0_TX == source_)
+    oc_sim::hardware.RunSpiDma();
+}
+
+/*static*/ DMAChannel *DMAChannel::find(uint8_t source) {
+  for (DMAChannel *c = channels_; c; c = c->next_) {
+    if (c->source_ == source)
+      return c;
+  }
+  return nullptr;
+}
+
+SimSerial Serial;
+SPIFIFOclass SPIFIFO;
+EEPROMClass EEPROM;
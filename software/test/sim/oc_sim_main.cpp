@@ -0,0 +1,113 @@
+// Command-line driver for the simulator: runs an app for a number of ticks
+// with fixed CV inputs and periodic triggers, and writes the DAC values as CSV.
+//
+// oc_sim -l
+// oc_sim -a <app id|name> [-n ticks] [-c channel=value]... [-t input:period]...
+//        [-s stride]
+
+#include <getopt.h>
+#include <strings.h>
+#include "oc_sim.h"
+
+using oc_sim::Simulator;
+
+static void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-l] [-a app] [-n ticks] [-c channel=value] [-t input:period] [-s stride]\n", name);
+  fprintf(stderr, "  -l                list apps\n");
+  fprintf(stderr, "  -a app            app id (hex) or name\n");
+  fprintf(stderr, "  -n ticks          number of core ticks to run (default: 1s)\n");
+  fprintf(stderr, "  -c channel=value  set CV input 1-4 to ADC value\n");
+  fprintf(stderr, "  -t input:period   trigger input 1-4 every period ticks\n");
+  fprintf(stderr, "  -s stride         print every stride ticks (default: 1)\n");
+}
+
+static int find_app(const char *arg) {
+  for (size_t i = 0; i < Simulator::num_apps(); ++i) {
+    if (!strcasecmp(arg, Simulator::app_name(i)))
+      return i;
+  }
+  char *end = nullptr;
+  unsigned long id = strtoul(arg, &end, 16);
+  if (end && !*end) {
+    for (size_t i = 0; i < Simulator::num_apps(); ++i) {
+      if (Simulator::app_id(i) == id)
+        return i;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  int app = 0;
+  uint32_t ticks = OC_CORE_ISR_FREQ;
+  uint32_t stride = 1;
+  int32_t cv[ADC_CHANNEL_LAST] = { 0 };
+  uint32_t trigger_period[OC::DIGITAL_INPUT_LAST] = { 0 };
+
+  Simulator::Boot();
+
+  int c;
+  while ((c = getopt(argc, argv, "la:n:c:t:s:h")) != -1) {
+    switch (c) {
+      case 'l':
+        for (size_t i = 0; i < Simulator::num_apps(); ++i)
+          printf("%04x %s\n", Simulator::app_id(i), Simulator::app_name(i));
+        return 0;
+      case 'a':
+        app = find_app(optarg);
+        if (app < 0) {
+          fprintf(stderr, "App '%s' not found\n", optarg);
+          return 1;
+        }
+        break;
+      case 'n': ticks = strtoul(optarg, nullptr, 0); break;
+      case 's': stride = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'c': {
+        int channel, value;
+        if (2 != sscanf(optarg, "%d=%d", &channel, &value) || channel < 1 || channel > ADC_CHANNEL_LAST) {
+          usage(argv[0]);
+          return 1;
+        }
+        cv[channel - 1] = value;
+      }
+      break;
+      case 't': {
+        int input;
+        unsigned period;
+        if (2 != sscanf(optarg, "%d:%u", &input, &period) || input < 1 || input > OC::DIGITAL_INPUT_LAST) {
+          usage(argv[0]);
+          return 1;
+        }
+        trigger_period[input - 1] = period;
+      }
+      break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  Simulator::SelectApp(Simulator::app_id(app));
+  for (int channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+    Simulator::SetCV(static_cast<ADC_CHANNEL>(channel), cv[channel]);
+
+  printf("tick,A,B,C,D\n");
+  for (uint32_t tick = 0; tick < ticks; ++tick) {
+    for (int input = OC::DIGITAL_INPUT_1; input < OC::DIGITAL_INPUT_LAST; ++input) {
+      uint32_t period = trigger_period[input];
+      if (period)
+        Simulator::SetGate(static_cast<OC::DigitalInput>(input), (tick % period) < (period + 1) / 2);
+    }
+
+    Simulator::Tick();
+    if (!(tick % Simulator::kUiTicks))
+      Simulator::Loop();
+
+    if (!(tick % stride)) {
+      oc_sim::DacFrame frame = Simulator::dac_frame();
+      printf("%u,%u,%u,%u,%u\n", tick, frame.values[0], frame.values[1], frame.values[2], frame.values[3]);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+// PageStorage startup benchmark: compares the header-first ::Load with the
+// previous scan that reads every page in full. Reports bytes read from the
+// (simulated) EEPROM and host time per load for a few data sizes, with the
+// newest page in the first, middle or last slot.
+//
+// oc_sim_pagestorage_bench [-n loads] [-r runs]
+//
+// As with oc_sim_bench, the fastest of several runs is reported. The bytes
+// read are a better indication of the time spent on hardware, where each
+// byte is a separate EEPROM access.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "util/util_pagestorage.h"
+
+namespace {
+
+volatile uint32_t sink;
+
+struct SimulatedEEPROM {
+  static const size_t LENGTH = 4096;
+  static uint8_t bytes[LENGTH];
+  static size_t bytes_read;
+
+  static void write(size_t addr, const void *data, size_t length) {
+    memcpy(bytes + addr, data, length);
+  }
+
+  static void update(size_t addr, const void *data, size_t length) {
+    write(addr, data, length);
+  }
+
+  // Byte-wise, as with eeprom_read_block
+  static void read(size_t addr, void *data, size_t length) {
+    volatile const uint8_t *src = bytes + addr;
+    uint8_t *dst = static_cast<uint8_t *>(data);
+    bytes_read += length;
+    while (length--)
+      *dst++ = *src++;
+  }
+};
+
+uint8_t SimulatedEEPROM::bytes[SimulatedEEPROM::LENGTH];
+size_t SimulatedEEPROM::bytes_read;
+
+template <size_t size>
+struct Data {
+  static constexpr uint32_t FOURCC = FOURCC<'B','N','C','H'>::value;
+  uint8_t bytes[size];
+};
+
+// Previous PageStorage::Load, for comparison
+template <typename Base, typename DATA_TYPE>
+class FullScanPageStorage : public Base {
+public:
+  bool Load(DATA_TYPE &data) {
+    this->page_index_ = -1;
+    memset(&this->page_, 0, sizeof(this->page_));
+    this->page_.header.generation = -1;
+    typename Base::page_data next_page;
+    for (size_t i = 0; i < Base::PAGES; ++i) {
+      SimulatedEEPROM::read(i * Base::PAGESIZE, &next_page, sizeof(next_page));
+      if ((DATA_TYPE::FOURCC != next_page.header.fourcc) ||
+          (sizeof(DATA_TYPE) != next_page.header.size) ||
+          (next_page.header.checksum != Base::checksum(next_page)) ||
+          (next_page.header.generation < this->page_.header.generation && (int32_t)this->page_.header.generation != -1)) {
+        if (-1 != this->page_index_)
+          break;
+        else
+          continue;
+      }
+      this->page_index_ = i;
+      memcpy(&this->page_, &next_page, sizeof(this->page_));
+    }
+    if (-1 == this->page_index_)
+      return false;
+    memcpy(&data, &this->page_.data, sizeof(DATA_TYPE));
+    return true;
+  }
+};
+
+// ns per load
+template <typename Storage, typename DATA_TYPE>
+double Benchmark(size_t loads, int expected_page) {
+  DATA_TYPE data = {};
+  uint32_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < loads; ++i) {
+    Storage storage;
+    storage.Load(data);
+    found += expected_page == storage.page_index();
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (found != loads)
+    fprintf(stderr, "Loaded wrong page!\n");
+  sink = found + data.bytes[0];
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / loads;
+}
+
+template <typename Storage, typename DATA_TYPE>
+double Benchmark(size_t loads, int expected_page, int runs, size_t &bytes_read) {
+  SimulatedEEPROM::bytes_read = 0;
+  Benchmark<Storage, DATA_TYPE>(1, expected_page);
+  bytes_read = SimulatedEEPROM::bytes_read;
+
+  double best = Benchmark<Storage, DATA_TYPE>(loads, expected_page);
+  while (--runs > 0)
+    best = std::min(best, Benchmark<Storage, DATA_TYPE>(loads, expected_page));
+  return best;
+}
+
+template <size_t size>
+void Report(size_t loads, int runs) {
+  typedef Data<size> DATA_TYPE;
+  typedef PageStorage<SimulatedEEPROM, 0, SimulatedEEPROM::LENGTH, DATA_TYPE> Storage;
+  typedef FullScanPageStorage<Storage, DATA_TYPE> FullScanStorage;
+
+  const size_t pages = Storage::PAGES;
+  for (size_t newest : { size_t(0), pages / 2, pages - 1 }) {
+    // Fill all pages, then wrap around until the newest is in place
+    memset(SimulatedEEPROM::bytes, 0xff, sizeof(SimulatedEEPROM::bytes));
+    Storage storage = {};
+    DATA_TYPE data;
+    storage.Init();
+    for (size_t i = 0; i < pages + newest + 1; ++i) {
+      memset(data.bytes, i, sizeof(data.bytes));
+      storage.Save(data);
+    }
+
+    size_t full_bytes, header_bytes;
+    double full = Benchmark<FullScanStorage, DATA_TYPE>(loads, newest, runs, full_bytes);
+    double header = Benchmark<Storage, DATA_TYPE>(loads, newest, runs, header_bytes);
+    printf("%6zu %5zu %6zu %8zu %8zu %10.1f %10.1f\n",
+           size, pages, newest, full_bytes, header_bytes, full, header);
+  }
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n loads] [-r runs]\n", name);
+  fprintf(stderr, "  -n loads      loads per run (default: 10000)\n");
+  fprintf(stderr, "  -r runs       runs per case, fastest is used (default: 5)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  size_t loads = 10000;
+  int runs = 5;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:h")) != -1) {
+    switch (c) {
+      case 'n': loads = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  printf("%6s %5s %6s %8s %8s %10s %10s\n", "size", "pages", "newest", "full(B)", "hdr(B)", "full(ns)", "hdr(ns)");
+  Report<64>(loads, runs);
+  Report<672>(loads, runs);
+  Report<996>(loads, runs);
+  printf("(%zu byte EEPROM)\n", SimulatedEEPROM::LENGTH);
+  return 0;
+}
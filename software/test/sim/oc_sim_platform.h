@@ -0,0 +1,47 @@
+#ifndef OC_SIM_PLATFORM_H_
+#define OC_SIM_PLATFORM_H_
+
+// Force-included into every simulator translation unit (-include). It claims
+// the include guards of the teensy-specific driver headers that live inside
+// the firmware tree, and provides register-free stand-ins for them instead.
+
+#include "Arduino.h"
+
+// src/drivers/ADC/OC_util_ADC.h
+#define OC_UTIL_ADC_H
+#define ADC_REF_3V3 0
+#define ADC_HIGH_SPEED_16BITS 3
+#define ADC_HIGH_SPEED 4
+
+class ADC {
+public:
+  void setReference(uint8_t, int8_t = -1) { }
+  void setResolution(uint8_t, int8_t = -1) { }
+  void setConversionSpeed(uint8_t, int8_t = -1) { }
+  void setSamplingSpeed(uint8_t, int8_t = -1) { }
+  void setAveraging(uint8_t, int8_t = -1) { }
+  void enableDMA(int8_t = -1) { }
+};
+
+// util/util_SPIFIFO.h
+#define _UTIL_SPIFIFO_h_
+#define SPI_MODE0 0x00
+#define SPI_CONTINUE 1
+
+namespace oc_sim {
+// SPI writes are forwarded to the simulated bus, which decodes DAC frames.
+void spi_write(uint32_t b, uint32_t cont);
+void spi_write16(uint32_t w, uint32_t cont);
+};
+
+class SPIFIFOclass {
+public:
+  void begin(uint8_t, uint32_t, uint32_t = SPI_MODE0) { }
+  void write(uint32_t b, uint32_t cont = 0) { oc_sim::spi_write(b, cont); }
+  void write16(uint32_t w, uint32_t cont = 0) { oc_sim::spi_write16(w, cont); }
+  uint32_t read() { return 0; }
+  void clear() { }
+};
+extern SPIFIFOclass SPIFIFO;
+
+#endif // OC_SIM_PLATFORM_H_
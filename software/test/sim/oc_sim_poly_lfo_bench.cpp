@@ -0,0 +1,93 @@
+// PolyLfo benchmark: host time per PolyLfo::Render (i.e. per POLYLFO_isr
+// tick), with a steady frequency and with the frequency changing every tick.
+// Also times the phase increment calculation on its own.
+//
+// oc_sim_poly_lfo_bench [-n ticks] [-r runs]
+//
+// As with oc_sim_bench, the fastest of several runs is reported.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "frames_poly_lfo.h"
+
+namespace {
+
+volatile uint32_t sink;
+
+static frames::PolyLfo lfo;
+
+// ns per tick
+double BenchmarkRender(size_t ticks, bool steady) {
+  lfo.Init();
+  lfo.set_shape(0x4000);
+  lfo.set_shape_spread(0x9000);
+  lfo.set_spread(0x9000);
+  lfo.set_coupling(0x9000);
+
+  uint32_t dac_codes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tick = 0; tick < ticks; ++tick) {
+    // Same frequencies either way, but steady only changes every 64K ticks
+    int32_t frequency = 7000 + ((steady ? tick >> 16 : tick) & 0xff);
+    lfo.Render(frequency, false, false, 0xff);
+    dac_codes += lfo.dac_code(tick & 3);
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = dac_codes;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ticks;
+}
+
+// ns per call
+double BenchmarkIncrement(size_t ticks) {
+  uint32_t increments = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tick = 0; tick < ticks; ++tick)
+    increments += frames::PolyLfo::FrequencyToPhaseIncrement(tick & 0x3fff, tick % 12);
+  auto end = std::chrono::steady_clock::now();
+  sink = increments;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ticks;
+}
+
+template <typename F>
+double Fastest(int runs, F f) {
+  double best = f();
+  while (--runs > 0)
+    best = std::min(best, f());
+  return best;
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n ticks] [-r runs]\n", name);
+  fprintf(stderr, "  -n ticks      ticks per run (default: 1000000)\n");
+  fprintf(stderr, "  -r runs       runs per case, fastest is used (default: 5)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  size_t ticks = 1000000;
+  int runs = 5;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:h")) != -1) {
+    switch (c) {
+      case 'n': ticks = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  for (bool steady : { true, false }) {
+    double ns = Fastest(runs, [&]{ return BenchmarkRender(ticks, steady); });
+    printf("%-24s %10.2f\n", steady ? "Render (steady freq.)" : "Render (changing freq.)", ns);
+  }
+  double ns = Fastest(runs, [&]{ return BenchmarkIncrement(ticks); });
+  printf("%-24s %10.2f\n", "FrequencyToPhaseIncrement", ns);
+  printf("(ns per call)\n");
+  return 0;
+}
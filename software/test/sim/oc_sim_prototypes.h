@@ -0,0 +1,49 @@
+#ifndef OC_SIM_PROTOTYPES_H_
+#define OC_SIM_PROTOTYPES_H_
+
+// The Arduino build generates prototypes for all functions in the .ino files.
+// These are the ones that the sketch actually relies on.
+
+struct CalibrationState;
+void calibration_load();
+void calibration_draw(const CalibrationState &state);
+void calibration_update(CalibrationState &state);
+
+void ASR_topButton();
+void ASR_lowerButton();
+void ASR_rightButton();
+void ASR_leftButton();
+void ASR_leftButtonLong();
+void ASR_downButtonLong();
+
+void SEQ_upButton();
+void SEQ_downButton();
+void SEQ_rightButton();
+void SEQ_leftButton();
+void SEQ_leftButtonLong();
+void SEQ_upButtonLong();
+void SEQ_downButtonLong();
+
+void CHORDS_topButton();
+void CHORDS_lowerButton();
+void CHORDS_rightButton();
+void CHORDS_leftButton();
+void CHORDS_leftButtonLong();
+void CHORDS_downButtonLong();
+void CHORDS_upButtonLong();
+
+void DQ_topButton();
+void DQ_lowerButton();
+void DQ_rightButton();
+void DQ_leftButton();
+void DQ_leftButtonLong();
+void DQ_downButtonLong();
+
+void QQ_topButton();
+void QQ_lowerButton();
+void QQ_rightButton();
+void QQ_leftButton();
+void QQ_leftButtonLong();
+void QQ_downButtonLong();
+
+#endif // OC_SIM_PROTOTYPES_H_
@@ -0,0 +1,155 @@
+// Quantizer search benchmark: compares the binary search with the direct
+// index (braids::Quantizer::EnableDirectIndex) in the worst case for the
+// hysteresis, i.e. when every call leaves the current cell and has to search
+// the codebook. Reports host time per call (mean and p99.9) for each scale
+// and over all scales. The p99.9 stands in for the worst case, which on the
+// host is dominated by interrupts and scheduling.
+//
+// It also times Configure when cycling through a few masks (as with mask
+// rotation), with and without the codebook cache.
+//
+// oc_sim_quantizer_bench [-n calls] [-r runs]
+//
+// As with oc_sim_bench, the fastest of several runs is reported.
+
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "braids_quantizer.h"
+#include "braids_quantizer_scales.h"
+
+namespace {
+
+static const size_t kNumScales = sizeof(braids::scales) / sizeof(braids::scales[0]);
+
+struct Stats {
+  double mean;
+  uint32_t p999;
+};
+
+std::vector<int32_t> pitches;
+std::vector<uint32_t> samples;
+braids::Quantizer quantizer;
+braids::Quantizer::DirectIndex direct_index;
+volatile int32_t sink;
+
+// Random pitches over +/- 5 octaves
+void GeneratePitches(size_t calls) {
+  uint32_t random = 0x12345678;
+  pitches.resize(calls);
+  for (auto &pitch : pitches) {
+    random = random * 1664525 + 1013904223;
+    pitch = static_cast<int32_t>((random >> 8) % (10 * 12 << 7)) - (5 * 12 << 7);
+  }
+}
+
+Stats Benchmark(size_t scale, bool use_direct_index) {
+  quantizer.Init();
+  quantizer.EnableDirectIndex(use_direct_index ? &direct_index : nullptr);
+  quantizer.Configure(braids::scales[scale]);
+
+  samples.clear();
+  samples.reserve(pitches.size());
+  uint64_t total_ns = 0;
+  int32_t transpose = 0;
+  for (int32_t pitch : pitches) {
+    // Changing the transpose forces a search
+    transpose ^= 1;
+    auto start = std::chrono::steady_clock::now();
+    sink = quantizer.Process(pitch, 0, transpose);
+    auto end = std::chrono::steady_clock::now();
+    uint32_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    total_ns += ns;
+    samples.push_back(ns);
+  }
+
+  Stats stats;
+  stats.mean = static_cast<double>(total_ns) / pitches.size();
+  std::sort(samples.begin(), samples.end());
+  stats.p999 = samples[static_cast<size_t>(0.999 * (samples.size() - 1) + 0.5)];
+  return stats;
+}
+
+Stats Benchmark(size_t scale, bool use_direct_index, int runs) {
+  Stats best = Benchmark(scale, use_direct_index);
+  while (--runs > 0) {
+    Stats stats = Benchmark(scale, use_direct_index);
+    best.mean = std::min(best.mean, stats.mean);
+    best.p999 = std::min(best.p999, stats.p999);
+  }
+  return best;
+}
+
+// Mean time per Configure call, cycling through masks of the chromatic scale
+double BenchmarkConfigure(size_t calls, bool use_cache) {
+  static const uint16_t kMasks[] = { 0xfff, 0xab5, 0x5ad, 0x56b };
+  quantizer.Init();
+  braids::CodebookCache::Clear();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < calls; ++i) {
+    if (!use_cache)
+      braids::CodebookCache::Clear();
+    quantizer.Configure(braids::scales[1], kMasks[i % 4]);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / calls;
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n calls] [-r runs]\n", name);
+  fprintf(stderr, "  -n calls      calls per scale and run (default: 100000)\n");
+  fprintf(stderr, "  -r runs       runs per scale, fastest is used (default: 5)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  size_t calls = 100000;
+  int runs = 5;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:h")) != -1) {
+    switch (c) {
+      case 'n': calls = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  GeneratePitches(calls);
+
+  printf("%-6s %5s %8s %6s %8s %6s\n", "scale", "notes", "search", "p99.9", "direct", "p99.9");
+  Stats search_total = { 0.0, 0 };
+  Stats direct_total = { 0.0, 0 };
+  size_t num_scales = 0;
+  for (size_t scale = 0; scale < kNumScales; ++scale) {
+    if (!braids::scales[scale].num_notes)
+      continue;
+    Stats search = Benchmark(scale, false, runs);
+    Stats direct = Benchmark(scale, true, runs);
+    printf("%-6zu %5u %8.1f %6u %8.1f %6u\n", scale, braids::scales[scale].num_notes,
+           search.mean, search.p999, direct.mean, direct.p999);
+
+    search_total.mean += search.mean;
+    search_total.p999 = std::max(search_total.p999, search.p999);
+    direct_total.mean += direct.mean;
+    direct_total.p999 = std::max(direct_total.p999, direct.p999);
+    ++num_scales;
+  }
+
+  printf("%-12s %8.1f %6u %8.1f %6u\n", "all (ns)",
+         search_total.mean / num_scales, search_total.p999,
+         direct_total.mean / num_scales, direct_total.p999);
+
+  double configure_miss = BenchmarkConfigure(calls, false);
+  double configure_hit = BenchmarkConfigure(calls, true);
+  for (int run = 1; run < runs; ++run) {
+    configure_miss = std::min(configure_miss, BenchmarkConfigure(calls, false));
+    configure_hit = std::min(configure_hit, BenchmarkConfigure(calls, true));
+  }
+  printf("Configure (ns): rebuild %.1f cached %.1f\n", configure_miss, configure_hit);
+  return 0;
+}
@@ -0,0 +1,89 @@
+#ifndef OC_SIM_REGISTERS_H_
+#define OC_SIM_REGISTERS_H_
+
+#include <stdint.h>
+
+// Peripheral registers touched by the firmware sources that are compiled for
+// the simulator. They're just memory; reads return whatever was last written,
+// so code that busy-waits on status bits must be replaced rather than linked.
+
+#define OC_SIM_REGISTER_LIST(X) \
+  X(SIM_SCGC2) X(SIM_SCGC3) X(SIM_SCGC6) \
+  X(SPI0_MCR) X(SPI0_SR) X(SPI0_RSER) X(SPI0_PUSHR) X(SPI0_POPR) \
+  X(SPI0_CTAR0) X(SPI0_CTAR1) \
+  X(VREF_TRM) X(VREF_SC) \
+  X(DAC0_C0) X(DAC0_DAT0L) \
+  X(ADC0_RA) X(ADC0_SC1A) \
+  X(CORE_PIN11_CONFIG) X(CORE_PIN13_CONFIG) \
+  X(ARM_DEMCR) X(ARM_DWT_CTRL)
+
+namespace oc_sim {
+namespace registers {
+#define OC_SIM_DECLARE_REGISTER(name) extern volatile uint32_t name##_;
+OC_SIM_REGISTER_LIST(OC_SIM_DECLARE_REGISTER)
+#undef OC_SIM_DECLARE_REGISTER
+}; // namespace registers
+}; // namespace oc_sim
+
+#define SIM_SCGC2 oc_sim::registers::SIM_SCGC2_
+#define SIM_SCGC3 oc_sim::registers::SIM_SCGC3_
+#define SIM_SCGC6 oc_sim::registers::SIM_SCGC6_
+#define SPI0_MCR oc_sim::registers::SPI0_MCR_
+#define SPI0_SR oc_sim::registers::SPI0_SR_
+#define SPI0_RSER oc_sim::registers::SPI0_RSER_
+#define SPI0_PUSHR oc_sim::registers::SPI0_PUSHR_
+#define SPI0_POPR oc_sim::registers::SPI0_POPR_
+#define SPI0_CTAR0 oc_sim::registers::SPI0_CTAR0_
+#define SPI0_CTAR1 oc_sim::registers::SPI0_CTAR1_
+#define VREF_TRM oc_sim::registers::VREF_TRM_
+#define VREF_SC oc_sim::registers::VREF_SC_
+#define DAC0_C0 oc_sim::registers::DAC0_C0_
+#define DAC0_DAT0L oc_sim::registers::DAC0_DAT0L_
+#define ADC0_RA oc_sim::registers::ADC0_RA_
+#define ADC0_SC1A oc_sim::registers::ADC0_SC1A_
+#define CORE_PIN11_CONFIG oc_sim::registers::CORE_PIN11_CONFIG_
+#define CORE_PIN13_CONFIG oc_sim::registers::CORE_PIN13_CONFIG_
+#define ARM_DEMCR oc_sim::registers::ARM_DEMCR_
+#define ARM_DWT_CTRL oc_sim::registers::ARM_DWT_CTRL_
+
+// The cycle counter runs off the host clock so profiling scopes in the
+// firmware measure host time, scaled to F_CPU cycles.
+#define ARM_DWT_CYCCNT (oc_sim::cycle_count())
+
+#define ARM_DEMCR_TRCENA (1 << 24)
+#define ARM_DWT_CTRL_CYCCNTENA (1 << 0)
+
+#define SIM_SCGC2_DAC0 0x00001000
+#define SIM_SCGC6_SPI0 0x00001000
+#define DAC_C0_DACEN 0x80
+
+#define PORT_PCR_ODE 0x00000020
+#define PORT_PCR_DSE 0x00000040
+#define PORT_PCR_PE 0x00000002
+#define PORT_PCR_PS 0x00000001
+#define PORT_PCR_MUX(n) (((n) & 7) << 8)
+
+#define SPI_MCR_MSTR 0x80000000
+#define SPI_MCR_MDIS 0x00004000
+#define SPI_MCR_HALT 0x00000001
+#define SPI_MCR_CLR_TXF 0x00000800
+#define SPI_MCR_CLR_RXF 0x00000400
+#define SPI_MCR_PCSIS(n) (((n) & 0x1F) << 16)
+#define SPI_SR_EOQF 0x10000000
+#define SPI_RSER_TFFF_RE 0x02000000
+#define SPI_RSER_TFFF_DIRS 0x01000000
+#define SPI_PUSHR_CONT 0x80000000
+#define SPI_PUSHR_CTAS(n) (((n) & 7) << 28)
+#define SPI_PUSHR_EOQ 0x08000000
+#define SPI_PUSHR_PCS(n) (((n) & 31) << 16)
+#define SPI_CTAR_DBR 0x80000000
+#define SPI_CTAR_FMSZ(n) (((n) & 15) << 27)
+#define SPI_CTAR_PBR(n) (((n) & 3) << 16)
+#define SPI_CTAR_BR(n) (((n) & 15) << 0)
+
+#define IRQ_DMA_CH0 0
+#define IRQ_PORTB 88
+#define DMAMUX_SOURCE_ADC0 40
+#define DMAMUX_SOURCE_SPI0_TX 17
+
+#endif // OC_SIM_REGISTERS_H_
@@ -0,0 +1,25 @@
+// The Arduino build concatenates all .ino files into a single translation
+// unit: the main sketch first, then the others in alphabetical order.
+#include <Arduino.h>
+#include "oc_sim_prototypes.h"
+#include "o_c_REV.ino"
+#include "APP_ASR.ino"
+#include "APP_AUTOMATONNETZ.ino"
+#include "APP_A_SEQ.ino"
+#include "APP_BBGEN.ino"
+#include "APP_BYTEBEATGEN.ino"
+#include "APP_CHORDS.ino"
+#include "APP_DQ.ino"
+#include "APP_ENVGEN.ino"
+#include "APP_H1200.ino"
+#include "APP_LORENZ.ino"
+#include "APP_POLYLFO.ino"
+#include "APP_QQ.ino"
+#include "APP_REFS.ino"
+#include "OC_apps.ino"
+#include "OC_calibration.ino"
+
+// Sketch internals that the simulator needs
+namespace oc_sim {
+extern const size_t kNumAvailableApps = NUM_AVAILABLE_APPS;
+};
@@ -0,0 +1,94 @@
+// Trigger delay benchmark: compares the timing wheel (util::TriggerDelay) with
+// the previous shifting bitfield (util_trigger_delay_reference.h). Reports
+// host time per tick for four inputs, as in OC::TriggerDelays::Process, when
+// idle and with triggers pending, for the default and a longer max. delay.
+//
+// oc_sim_trigger_delay_bench [-n ticks] [-r runs]
+//
+// As with oc_sim_bench, the fastest of several runs is reported.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "util/util_trigger_delay.h"
+#include "../util_trigger_delay_reference.h"
+
+namespace {
+
+static constexpr size_t kNumInputs = 4;
+volatile uint32_t sink;
+
+// ns per tick; with `busy` inputs are clocked every few ticks
+template <typename Delay>
+double Benchmark(size_t ticks, bool busy) {
+  Delay delays[kNumInputs];
+  for (auto &d : delays)
+    d.Init();
+
+  uint32_t triggered = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tick = 0; tick < ticks; ++tick) {
+    uint32_t trigger_mask = busy ? (tick % 5 ? 0 : (tick >> 3) & 0xf) : 0;
+    uint32_t mask = 0x1;
+    for (auto &d : delays) {
+      d.Update();
+      if (trigger_mask & mask)
+        d.Push(Delay::kMaxDelay / 2);
+      if (d.triggered())
+        triggered |= mask;
+      mask <<= 1;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = triggered;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / ticks;
+}
+
+template <typename Delay>
+double Benchmark(size_t ticks, bool busy, int runs) {
+  double best = Benchmark<Delay>(ticks, busy);
+  while (--runs > 0)
+    best = std::min(best, Benchmark<Delay>(ticks, busy));
+  return best;
+}
+
+template <size_t max_delay>
+void Report(size_t ticks, int runs) {
+  for (bool busy : { false, true }) {
+    double shift = Benchmark<reference::TriggerDelay<max_delay>>(ticks, busy, runs);
+    double wheel = Benchmark<util::TriggerDelay<max_delay>>(ticks, busy, runs);
+    printf("%9zu %5s %8.2f %8.2f\n", max_delay, busy ? "busy" : "idle", shift, wheel);
+  }
+}
+
+void usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n ticks] [-r runs]\n", name);
+  fprintf(stderr, "  -n ticks      ticks per run (default: 1000000)\n");
+  fprintf(stderr, "  -r runs       runs per case, fastest is used (default: 5)\n");
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  size_t ticks = 1000000;
+  int runs = 5;
+
+  int c;
+  while ((c = getopt(argc, argv, "n:r:h")) != -1) {
+    switch (c) {
+      case 'n': ticks = std::max(1UL, strtoul(optarg, nullptr, 0)); break;
+      case 'r': runs = std::max(1, atoi(optarg)); break;
+      default:
+        usage(argv[0]);
+        return 'h' == c ? 0 : 1;
+    }
+  }
+
+  printf("%9s %5s %8s %8s\n", "max.delay", "", "shift", "wheel");
+  Report<96>(ticks, runs);
+  Report<1024>(ticks, runs);
+  printf("(ns per tick, %zu inputs)\n", kNumInputs);
+  return 0;
+}
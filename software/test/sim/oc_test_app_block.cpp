@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "oc_test_sim_util.h"
+#include "OC_apps.h"
+
+using oc_sim::Simulator;
+using oc_sim::DacFrame;
+
+static const size_t kNumFrames = 4000;
+
+// Triggers at ticks that don't line up with the blocks
+static void TickWithTriggers(size_t ticks) {
+  for (size_t tick = 0; tick < ticks; ++tick) {
+    if (tick % 601 == 5)
+      Simulator::Trigger(OC::DIGITAL_INPUT_1);
+    if (tick % 757 == 398)
+      Simulator::Trigger(OC::DIGITAL_INPUT_2);
+    if (tick % 1201 == 1003)
+      Simulator::Trigger(OC::DIGITAL_INPUT_3);
+    Simulator::Tick();
+  }
+}
+
+static void (*app_begin_block)();
+static void (*app_isr)();
+
+// Run the block setup before every tick instead of once per block
+static void BeginBlockEveryTick() {
+  OC::apps::current_app->BeginBlock = nullptr;
+  OC::apps::current_app->isr = []() {
+    app_begin_block();
+    app_isr();
+  };
+}
+
+static void RestoreApp() {
+  OC::apps::current_app->BeginBlock = app_begin_block;
+  OC::apps::current_app->isr = app_isr;
+}
+
+static void RunApp(bool every_tick, std::vector<DacFrame> &frames) {
+  RunInChild([every_tick]() {
+    if (every_tick)
+      BeginBlockEveryTick();
+    TickWithTriggers(kNumFrames);
+  }, kNumFrames, frames);
+}
+
+// With constant CVs and settings, setting up once per block has to be
+// identical to setting up every tick, including the response to triggers.
+TEST(AppBlock, MatchesSetupEveryTick) {
+  Simulator::Boot();
+
+  size_t block_apps = 0;
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    Simulator::SelectApp(Simulator::app_id(app));
+    app_begin_block = OC::apps::current_app->BeginBlock;
+    app_isr = OC::apps::current_app->isr;
+    if (!app_begin_block)
+      continue;
+    ++block_apps;
+    SCOPED_TRACE(Simulator::app_name(app));
+
+    Simulator::SetCV(ADC_CHANNEL_1, 500);
+    Simulator::SetCV(ADC_CHANNEL_2, -300);
+    Simulator::SetCV(ADC_CHANNEL_3, 200);
+    Simulator::SetCV(ADC_CHANNEL_4, 100);
+    // Settle ADC smoothing; this sets up every tick so the next block starts
+    // at the same state in both runs
+    BeginBlockEveryTick();
+    Simulator::Tick(OC_CORE_ISR_FREQ);
+    RestoreApp();
+
+    std::vector<DacFrame> every_tick, blocks;
+    RunApp(true, every_tick);
+    RunApp(false, blocks);
+    ASSERT_EQ(every_tick.size(), blocks.size());
+    for (size_t i = 0; i < every_tick.size(); ++i)
+      ASSERT_TRUE(every_tick[i] == blocks[i]) << "tick " << i;
+  }
+  EXPECT_EQ(4U, block_apps);
+}
+
+// Triggers are handled on the tick they arrive, so the latency doesn't depend
+// on where in the block they arrive
+TEST(AppBlock, TriggerLatency) {
+  static const size_t kTicks = OC::kAppBlockSize * 4;
+  Simulator::Boot();
+  ASSERT_TRUE(Simulator::SelectApp(OC::apps::find(TWOCC<'B','B'>::value)->id));
+  Simulator::Tick(OC_CORE_ISR_FREQ);
+
+  std::vector<DacFrame> idle;
+  RunInChild([]() { Simulator::Tick(kTicks); }, kTicks, idle);
+
+  for (size_t offset = 0; offset < OC::kAppBlockSize; ++offset) {
+    SCOPED_TRACE(offset);
+    std::vector<DacFrame> triggered;
+    RunInChild([offset]() {
+      Simulator::Tick(offset);
+      Simulator::Trigger(OC::DIGITAL_INPUT_2);
+      Simulator::Tick(kTicks - offset);
+    }, kTicks, triggered);
+
+    size_t latency = 0;
+    while (latency < kTicks && idle[latency] == triggered[latency])
+      ++latency;
+    ASSERT_GT(kTicks, latency);
+    EXPECT_EQ(offset + 1, latency);
+  }
+}
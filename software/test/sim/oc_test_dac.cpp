@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "OC_calibration.h"
+#include "OC_DAC.h"
+
+namespace {
+
+// Reference versions, using divisions
+int32_t interpolate_octaves(const OC::DAC::CalibrationData &data, DAC_CHANNEL channel, int32_t pitch) {
+  CONSTRAIN(pitch, 0, (120 << 7));
+
+  const int32_t octave = pitch / (12 << 7);
+  const int32_t fractional = pitch - octave * (12 << 7);
+
+  int32_t sample = data.calibrated_octaves[channel][octave];
+  if (fractional) {
+    int32_t span = data.calibrated_octaves[channel][octave + 1] - sample;
+    sample += (fractional * span) / (12 << 7);
+  }
+
+  return sample;
+}
+
+int32_t pitch_to_dac(const OC::DAC::CalibrationData &data, DAC_CHANNEL channel, int32_t pitch, int32_t octave_offset) {
+  pitch += (OC::DAC::kOctaveZero + octave_offset) * 12 << 7;
+  return interpolate_octaves(data, channel, pitch);
+}
+
+int32_t pitch_to_scaled_voltage_dac(const OC::DAC::CalibrationData &data, DAC_CHANNEL channel, int32_t pitch, int32_t octave_offset, uint8_t voltage_scaling) {
+  pitch += (octave_offset * 12) << 7;
+  switch (voltage_scaling) {
+    case VOLTAGE_SCALING_CARLOS_ALPHA: pitch = (pitch * 25548) >> 15; break;
+    case VOLTAGE_SCALING_CARLOS_BETA: pitch = (pitch * 20917) >> 15; break;
+    case VOLTAGE_SCALING_CARLOS_GAMMA: pitch = (pitch * 11501) >> 15; break;
+    case VOLTAGE_SCALING_BOHLEN_PIERCE: pitch = (pitch * 25969) >> 14; break;
+    case VOLTAGE_SCALING_QUARTERTONE: pitch = pitch >> 1; break;
+#ifdef BUCHLA_SUPPORT
+    case VOLTAGE_SCALING_1_2V_PER_OCT: pitch = (pitch * 19661) >> 14; break;
+    case VOLTAGE_SCALING_2V_PER_OCT: pitch = pitch << 1; break;
+#endif
+    default: break;
+  }
+  pitch += (OC::DAC::kOctaveZero * 12) << 7;
+  return interpolate_octaves(data, channel, pitch);
+}
+
+class DACTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    oc_sim::Simulator::Boot();
+    saved_ = OC::calibration_data.dac;
+  }
+
+  virtual void TearDown() {
+    OC::calibration_data.dac = saved_;
+  }
+
+  OC::DAC::CalibrationData saved_;
+};
+
+}; // namespace
+
+TEST_F(DACTest, PitchToDac) {
+  OC::DAC::CalibrationData &data = OC::calibration_data.dac;
+
+  // Default, full-scale, flat and non-monotonic calibration data
+  for (int variant = 0; variant < 4; ++variant) {
+    for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel) {
+      for (int octave = 0; octave <= OCTAVES; ++octave) {
+        uint16_t &value = data.calibrated_octaves[channel][octave];
+        switch (variant) {
+          case 1: value = octave * 65535 / OCTAVES; break;
+          case 2: value = 32768; break;
+          case 3: value = (octave & 1) ? 65535 - octave * 997 * (channel + 1) : octave * 131; break;
+          default: break;
+        }
+      }
+    }
+
+    for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel) {
+      DAC_CHANNEL dac_channel = static_cast<DAC_CHANNEL>(channel);
+      for (int32_t octave_offset = -5; octave_offset <= 5; ++octave_offset) {
+        for (int32_t pitch = -(130 << 7); pitch <= (130 << 7); ++pitch) {
+          ASSERT_EQ(pitch_to_dac(data, dac_channel, pitch, octave_offset),
+                    OC::DAC::pitch_to_dac(dac_channel, pitch, octave_offset))
+            << "variant " << variant << " channel " << channel << " pitch " << pitch << " offset " << octave_offset;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(DACTest, PitchToScaledVoltageDac) {
+  const OC::DAC::CalibrationData &data = OC::calibration_data.dac;
+
+  for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel) {
+    DAC_CHANNEL dac_channel = static_cast<DAC_CHANNEL>(channel);
+    for (uint8_t scaling = 0; scaling <= VOLTAGE_SCALING_LAST; ++scaling) {
+      for (int32_t octave_offset = -5; octave_offset <= 5; ++octave_offset) {
+        for (int32_t pitch = -(130 << 7); pitch <= (130 << 7); pitch += 7) {
+          ASSERT_EQ(pitch_to_scaled_voltage_dac(data, dac_channel, pitch, octave_offset, scaling),
+                    OC::DAC::pitch_to_scaled_voltage_dac(dac_channel, pitch, octave_offset, scaling))
+            << "channel " << channel << " scaling " << (int)scaling << " pitch " << pitch << " offset " << octave_offset;
+        }
+      }
+    }
+  }
+}
+
+namespace {
+
+template <bool flip_180, bool invert>
+void CheckFrames() {
+  SCOPED_TRACE(testing::Message() << "flip_180=" << flip_180 << " invert=" << invert);
+
+  const uint32_t values[DAC_CHANNEL_LAST] = { 0, 1234, 40000, OC::DAC::MAX_VALUE };
+  uint32_t frames[OC::DAC::kFrameWords];
+  OC::DAC::BuildFrames<flip_180, invert>(values, 0x01, frames);
+
+  for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel) {
+    uint32_t command = frames[2 * channel];
+    uint32_t data = frames[2 * channel + 1];
+    uint32_t address = flip_180 ? DAC_CHANNEL_LAST - 1 - channel : channel;
+
+    EXPECT_EQ(0x10U | (address << 1), command & 0xffff);
+    EXPECT_EQ(SPI_PUSHR_PCS(0x01) | SPI_PUSHR_CONT, command & 0xffff0000);
+
+    EXPECT_EQ(invert ? OC::DAC::MAX_VALUE - values[channel] : values[channel], data & 0xffff);
+    uint32_t flags = SPI_PUSHR_PCS(0x01) | SPI_PUSHR_CTAS(1);
+    if (DAC_CHANNEL_D == channel)
+      flags |= SPI_PUSHR_EOQ;
+    EXPECT_EQ(flags, data & 0xffff0000);
+  }
+}
+
+}; // namespace
+
+TEST_F(DACTest, Frames) {
+  CheckFrames<false, false>();
+  CheckFrames<false, true>();
+  CheckFrames<true, false>();
+  CheckFrames<true, true>();
+}
+
+TEST_F(DACTest, FramesOnTheWire) {
+  const uint32_t values[DAC_CHANNEL_LAST] = { 100, 20000, 0, OC::DAC::MAX_VALUE };
+  uint32_t frames[OC::DAC::kFrameWords];
+  OC::DAC::BuildFrames<OC::DAC::kFlip180, OC::DAC::kInvertOutput>(values, 0x01, frames);
+  for (auto frame : frames)
+    oc_sim::hardware.SpiPush(frame);
+
+  oc_sim::DacFrame frame = oc_sim::Simulator::dac_frame();
+  for (int channel = DAC_CHANNEL_A; channel < DAC_CHANNEL_LAST; ++channel)
+    EXPECT_EQ(values[channel], frame.values[channel]);
+}
@@ -0,0 +1,136 @@
+#include <string.h>
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "OC_calibration.h"
+#include "OC_debug.h"
+#include "OC_apps.h"
+#include "src/drivers/display.h"
+
+using oc_sim::Simulator;
+using oc_sim::hardware;
+
+TEST(FrameBuffer, DirtyPages) {
+  static FrameBuffer<16, 2, 4> frame_buffer;
+  frame_buffer.Init();
+
+  // First frame is always sent
+  memset(frame_buffer.writeable_frame(), 0, 16);
+  frame_buffer.written();
+  EXPECT_EQ(0xfU, frame_buffer.readable_dirty_pages());
+  frame_buffer.read();
+
+  uint8_t *frame = frame_buffer.writeable_frame();
+  memset(frame, 0, 16);
+  frame[5] = 1;
+  frame[15] = 1;
+  frame_buffer.written();
+  EXPECT_EQ(0xaU, frame_buffer.readable_dirty_pages());
+
+  // Compared to the previous frame, even if it's still readable
+  frame = frame_buffer.writeable_frame();
+  memset(frame, 0, 16);
+  frame[15] = 1;
+  frame_buffer.written();
+  frame_buffer.read();
+  EXPECT_EQ(0x2U, frame_buffer.readable_dirty_pages());
+  frame_buffer.read();
+
+  // Identical frames are dropped
+  frame = frame_buffer.writeable_frame();
+  memset(frame, 0, 16);
+  frame[15] = 1;
+  frame_buffer.written();
+  EXPECT_EQ(0U, frame_buffer.readable());
+
+  frame_buffer.Invalidate();
+  frame = frame_buffer.writeable_frame();
+  memset(frame, 0, 16);
+  frame[15] = 1;
+  frame_buffer.written();
+  EXPECT_EQ(0xfU, frame_buffer.readable_dirty_pages());
+}
+
+class DisplayTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    Simulator::Boot();
+    memset(frame_, 0, sizeof(frame_));
+  }
+
+  // Draw a frame, and run the core ISR until it's sent to the display
+  uint32_t Draw(weegfx::coord_t y) {
+    GRAPHICS_BEGIN_FRAME(false);
+    graphics.setPrintPos(2, 2);
+    graphics.print("Test");
+    if (y >= 0)
+      graphics.drawHLine(10, y, 20);
+    memcpy(frame_, frame, sizeof(frame_));
+    GRAPHICS_END_FRAME();
+
+    uint32_t pages = hardware.display_pages;
+    Simulator::Tick(2 * SH1106_128x64_Driver::kNumPages + 2);
+    EXPECT_EQ(0U, display::frame_buffer.readable());
+    return hardware.display_pages - pages;
+  }
+
+  uint8_t frame_[SH1106_128x64_Driver::kFrameSize];
+};
+
+TEST_F(DisplayTest, OnlyDirtyPagesAreSent) {
+  EXPECT_EQ(static_cast<uint32_t>(SH1106_128x64_Driver::kNumPages), Draw(-1));
+  EXPECT_EQ(0, memcmp(frame_, hardware.display, sizeof(frame_)));
+
+  EXPECT_EQ(0U, Draw(-1));
+  EXPECT_EQ(0, memcmp(frame_, hardware.display, sizeof(frame_)));
+
+  EXPECT_EQ(1U, Draw(40));
+  EXPECT_EQ(0, memcmp(frame_, hardware.display, sizeof(frame_)));
+
+  // Line moves to a different page, so the old one needs clearing
+  EXPECT_EQ(2U, Draw(60));
+  EXPECT_EQ(0, memcmp(frame_, hardware.display, sizeof(frame_)));
+
+  display::AdjustOffset(OC::calibration_data.display_offset);
+  EXPECT_EQ(static_cast<uint32_t>(SH1106_128x64_Driver::kNumPages), Draw(60));
+  EXPECT_EQ(0, memcmp(frame_, hardware.display, sizeof(frame_)));
+}
+
+TEST_F(DisplayTest, MenuOnlyRedrawnOnChange) {
+  ASSERT_TRUE(Simulator::SelectApp(TWOCC<'L','R'>::value));
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 256);
+  Simulator::Redraw();
+  Simulator::Tick(2 * SH1106_128x64_Driver::kNumPages + 2);
+
+  uint32_t redraws = OC::DEBUG::MENU_redraws;
+  uint32_t skipped = OC::DEBUG::MENU_redraws_skipped;
+  uint32_t pages = hardware.display_pages;
+  for (int i = 0; i < 16; ++i) {
+    Simulator::Redraw();
+    Simulator::Tick(Simulator::kUiTicks);
+  }
+  EXPECT_EQ(redraws, OC::DEBUG::MENU_redraws);
+  EXPECT_EQ(skipped + 16, OC::DEBUG::MENU_redraws_skipped);
+  EXPECT_EQ(pages, hardware.display_pages);
+
+  // Displayed frequency includes CV
+  Simulator::SetCV(ADC_CHANNEL_1, 1000);
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 64);
+  Simulator::Redraw();
+  Simulator::Tick(2 * SH1106_128x64_Driver::kNumPages + 2);
+  EXPECT_EQ(redraws + 1, OC::DEBUG::MENU_redraws);
+  EXPECT_LT(pages, hardware.display_pages);
+
+  // Apps without display state are always redrawn, but frames that are the
+  // same as the previous one are never sent.
+  ASSERT_TRUE(Simulator::SelectApp(TWOCC<'S','Q'>::value));
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 256);
+  Simulator::Redraw();
+  Simulator::Tick(2 * SH1106_128x64_Driver::kNumPages + 2);
+  redraws = OC::DEBUG::MENU_redraws;
+  pages = hardware.display_pages;
+  Simulator::Redraw();
+  EXPECT_EQ(redraws + 1, OC::DEBUG::MENU_redraws);
+  EXPECT_EQ(0U, display::frame_buffer.readable());
+  Simulator::Tick(2 * SH1106_128x64_Driver::kNumPages + 2);
+  EXPECT_EQ(pages, hardware.display_pages);
+}
@@ -0,0 +1,178 @@
+#include "gtest/gtest.h"
+#include "peaks_multistage_envelope.h"
+#include "../peaks_multistage_envelope_golden.h"
+
+namespace {
+
+struct Random {
+  uint32_t state;
+  uint32_t Next() {
+    state = state * 1664525 + 1013904223;
+    return state;
+  }
+  uint32_t Next(uint32_t range) {
+    return (Next() >> 8) % range;
+  }
+};
+
+// FNV-1a of every sample's output and state mask
+struct Hash {
+  uint32_t value;
+  void Add(uint16_t output, uint8_t state_mask) {
+    const uint8_t bytes[3] = { static_cast<uint8_t>(output), static_cast<uint8_t>(output >> 8), state_mask };
+    for (uint8_t b : bytes)
+      value = (value ^ b) * 16777619;
+  }
+};
+
+static const uint32_t kHashSeed = 2166136261;
+
+// Short segments so they all get reached
+uint16_t RandomTime(Random &random) {
+  return random.Next(8) ? random.Next(24 << 8) : random.Next(65536);
+}
+
+// As ENVGEN does once per tick
+void Configure(peaks::MultistageEnvelope &env, uint32_t seed, uint8_t type, uint8_t shapes) {
+  Random random = { seed };
+  uint16_t attack = RandomTime(random);
+  uint16_t decay = RandomTime(random);
+  uint16_t sustain = random.Next(65536) >> 1;
+  uint16_t release = RandomTime(random);
+  env.set_attack_shape(static_cast<peaks::EnvelopeShape>(shapes % peaks::ENV_SHAPE_LAST));
+  env.set_decay_shape(static_cast<peaks::EnvelopeShape>((shapes + 3) % peaks::ENV_SHAPE_LAST));
+  env.set_release_shape(static_cast<peaks::EnvelopeShape>((shapes + 7) % peaks::ENV_SHAPE_LAST));
+  env.set_attack_time_multiplier(random.Next(4));
+  env.set_decay_time_multiplier(random.Next(4));
+  env.set_release_time_multiplier(random.Next(4));
+  switch (type) {
+    case 0: env.set_ad(attack, decay, 0, 0); break;
+    case 1: env.set_adsr(attack, decay, sustain, release); break;
+    case 2: env.set_adr(attack, decay, sustain, release, 0, 0); break;
+    case 3: env.set_ar(attack, decay); break;
+    case 4: env.set_adsar(attack, decay, sustain, release); break;
+    case 5: env.set_adar(attack, decay, sustain, release, 0, 0); break;
+    case 6: env.set_ad(attack, decay, 0, 2); break;
+    case 7: env.set_adr(attack, decay, sustain, release, 0, 3); break;
+    case 8: env.set_adar(attack, decay, sustain, release, 0, 4); break;
+    default: env.set_adar(attack, decay, sustain, release, 1, 3); break;
+  }
+  // As on type changes
+  env.reset();
+  env.set_attack_reset_behaviour(static_cast<peaks::EnvResetBehaviour>(random.Next(peaks::RESET_BEHAVIOUR_LAST)));
+  env.set_attack_falling_gate_behaviour(static_cast<peaks::EnvFallingGateBehaviour>(random.Next(peaks::FALLING_GATE_BEHAVIOUR_LAST)));
+  env.set_decay_release_reset_behaviour(static_cast<peaks::EnvResetBehaviour>(random.Next(peaks::RESET_BEHAVIOUR_LAST)));
+  env.set_amplitude(random.Next(65536), random.Next(2));
+  env.set_max_loops(random.Next(65536));
+}
+
+// All envelope types and shapes under random gates, with parameters (e.g.
+// from CV) changing every so often, mid-segment
+struct RandomResults {
+  uint32_t hashes[peaks::ENV_SHAPE_LAST][golden::kEnvelopeTypes];
+  uint16_t samples[peaks::ENV_SHAPE_LAST][golden::kEnvelopeTypes][golden::kRandomSamples];
+  uint32_t eoc;
+};
+
+void RunRandom(peaks::MultistageEnvelope &env, RandomResults &results) {
+  env.Init();
+  Random random = { 0xfeedface };
+  results.eoc = 0;
+  for (uint8_t shapes = 0; shapes < peaks::ENV_SHAPE_LAST; ++shapes) {
+    for (uint8_t type = 0; type < golden::kEnvelopeTypes; ++type) {
+      Hash hash = { kHashSeed };
+      uint16_t *samples = results.samples[shapes][type];
+      for (size_t sweep = 0; sweep < golden::kRandomSweeps; ++sweep) {
+        uint32_t seed = random.Next();
+        bool gate = false;
+        for (size_t tick = 0; tick < golden::kRandomTicks; ++tick) {
+          if (!tick || !random.Next(64))
+            seed = random.Next();
+          Configure(env, seed, type, shapes);
+
+          uint8_t control = 0;
+          if (!random.Next(gate ? 200 : 50)) {
+            gate = !gate;
+            control |= gate ? peaks::CONTROL_GATE_RISING : peaks::CONTROL_GATE_FALLING;
+          }
+          if (gate)
+            control |= peaks::CONTROL_GATE;
+
+          uint16_t output = env.ProcessSingleSample(control);
+          hash.Add(output, env.get_state_mask());
+          if (!(tick % golden::kRandomSampleInterval))
+            *samples++ = output;
+          results.eoc += env.get_state_mask() & peaks::ENV_EOC;
+        }
+      }
+      results.hashes[shapes][type] = hash.value;
+    }
+  }
+}
+
+// One input at a time, so each is seen to take effect on its own; the attack
+// is long enough to last throughout.
+void ChangeParameters(peaks::MultistageEnvelope &env, size_t tick) {
+  const int phase = tick / 1000, step = tick % 1000;
+  env.set_ar(128 << 8, 20 << 8);
+  env.set_attack_shape(static_cast<peaks::EnvelopeShape>(2 == phase ? (step / 50) % peaks::ENV_SHAPE_LAST : 0));
+  env.set_attack_time_multiplier(1 == phase ? (step / 100) % 3 : 0);
+  env.set_level(1, 0 == phase ? 32767 - 8 * step : 32767);
+  if (3 == phase)
+    env.set_ar((128 << 8) + 4 * step, 20 << 8);
+}
+
+struct ParameterChangesResults {
+  uint32_t hash;
+  uint16_t samples[golden::kParameterChangesSamples];
+  uint16_t value;
+};
+
+void RunParameterChanges(peaks::MultistageEnvelope &env, ParameterChangesResults &results) {
+  env.Init();
+  Hash hash = { kHashSeed };
+  for (size_t tick = 0; tick < golden::kParameterChangesTicks; ++tick) {
+    ChangeParameters(env, tick);
+    uint8_t control = tick ? peaks::CONTROL_GATE : peaks::CONTROL_GATE_RISING | peaks::CONTROL_GATE;
+    results.value = env.ProcessSingleSample(control);
+    hash.Add(results.value, env.get_state_mask());
+    if (!(tick % golden::kParameterChangesSampleInterval))
+      results.samples[tick / golden::kParameterChangesSampleInterval] = results.value;
+  }
+  results.hash = hash.value;
+}
+
+};
+
+// Not everything is initialized by Init, so static to start out the same as
+// when the golden output was recorded
+static peaks::MultistageEnvelope env;
+
+TEST(MultistageEnvelopeTest, Golden) {
+  static RandomResults results;
+  RunRandom(env, results);
+  for (uint8_t shapes = 0; shapes < peaks::ENV_SHAPE_LAST; ++shapes) {
+    for (uint8_t type = 0; type < golden::kEnvelopeTypes; ++type) {
+      for (size_t i = 0; i < golden::kRandomSamples; ++i)
+        ASSERT_EQ(golden::random_samples[shapes][type][i], results.samples[shapes][type][i])
+            << "shapes=" << (int)shapes << " type=" << (int)type << " sample=" << i;
+      ASSERT_EQ(golden::random_hashes[shapes][type], results.hashes[shapes][type])
+          << "shapes=" << (int)shapes << " type=" << (int)type;
+    }
+  }
+  // Envelopes ran to completion, not just restarted
+  EXPECT_GT(results.eoc, peaks::ENV_SHAPE_LAST * golden::kEnvelopeTypes * golden::kRandomSweeps * golden::kRandomTicks / 1000);
+}
+
+// Shape, time, multiplier and level changes within a segment take effect
+// immediately
+TEST(MultistageEnvelopeTest, ParameterChanges) {
+  ParameterChangesResults results;
+  RunParameterChanges(env, results);
+  for (size_t i = 0; i < golden::kParameterChangesSamples; ++i)
+    ASSERT_EQ(golden::parameter_changes_samples[i], results.samples[i]) << "sample=" << i;
+  EXPECT_EQ(golden::parameter_changes_hash, results.hash);
+  // Still attacking
+  EXPECT_GT(results.value, 0);
+  EXPECT_LT(results.value, 32767);
+}
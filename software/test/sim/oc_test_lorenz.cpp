@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include <complex>
+#include <math.h>
+#include <vector>
+#include "streams_lorenz_generator.h"
+
+namespace {
+
+static const uint8_t kControlRate = 4;
+
+// Per-tick Euler (the default) vs. control rate with Heun's method
+static streams::LorenzGenerator per_tick, control;
+
+void Configure(streams::LorenzGenerator &lorenz, uint8_t control_rate, uint8_t integrator) {
+  lorenz.Init(0);
+  lorenz.Init(1);
+  lorenz.set_rho1(63 << 8);
+  lorenz.set_rho2(100 << 8);
+  lorenz.set_out_a(streams::LORENZ_OUTPUT_X1);
+  lorenz.set_out_b(streams::LORENZ_OUTPUT_Z1);
+  lorenz.set_out_c(streams::ROSSLER_OUTPUT_X1);
+  lorenz.set_out_d(streams::ROSSLER_OUTPUT_Z2);
+  lorenz.set_control_rate(control_rate);
+  lorenz.set_integrator(integrator);
+}
+
+void Configure() {
+  Configure(per_tick, 0, streams::LORENZ_INTEGRATOR_EULER);
+  Configure(control, kControlRate, streams::LORENZ_INTEGRATOR_HEUN);
+}
+
+void Process(streams::LorenzGenerator &lorenz, int32_t rate) {
+  lorenz.Process(rate << 8, rate << 8, false, false, 2, 2);
+}
+
+typedef std::complex<double> Complex;
+
+void FFT(std::vector<Complex> &x) {
+  const size_t n = x.size();
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(x[i], x[j]);
+  }
+  for (size_t length = 2; length <= n; length <<= 1) {
+    const Complex w = std::polar(1.0, -2 * M_PI / length);
+    for (size_t i = 0; i < n; i += length) {
+      Complex u = 1;
+      for (size_t k = 0; k < length / 2; ++k) {
+        Complex a = x[i + k], b = x[i + k + length / 2] * u;
+        x[i + k] = a + b;
+        x[i + k + length / 2] = a - b;
+        u *= w;
+      }
+    }
+  }
+}
+
+// Fraction of the (Welch-averaged) power in each octave band
+static const size_t kBands = 8;
+static const size_t kSegment = 1024;
+
+void OctaveBands(const std::vector<double> &signal, double *bands) {
+  std::fill(bands, bands + kBands, 0.0);
+  double total = 0;
+  for (size_t start = 0; start + kSegment <= signal.size(); start += kSegment / 2) {
+    double mean = 0;
+    for (size_t i = 0; i < kSegment; ++i)
+      mean += signal[start + i];
+    mean /= kSegment;
+
+    std::vector<Complex> x(kSegment);
+    for (size_t i = 0; i < kSegment; ++i)
+      x[i] = (signal[start + i] - mean) * (0.5 - 0.5 * cos(2 * M_PI * i / kSegment));
+    FFT(x);
+    for (size_t i = 1; i < kSegment / 2; ++i) {
+      size_t band = 0;
+      while ((2U << band) <= i && band < kBands - 1)
+        ++band;
+      bands[band] += std::norm(x[i]);
+      total += std::norm(x[i]);
+    }
+  }
+  for (size_t band = 0; band < kBands; ++band)
+    bands[band] /= total;
+}
+
+};
+
+TEST(LorenzTest, ControlRateInterpolates) {
+  Configure();
+  const size_t period = 1 << kControlRate;
+  uint16_t codes[period + 1][streams::kNumChannels];
+  for (size_t tick = 0; tick < 200 * period; ++tick)
+    Process(control, 230);
+
+  // Within a control period, each output changes in (near) equal steps
+  for (int periods = 0; periods < 100; ++periods) {
+    for (uint8_t i = 0; i < streams::kNumChannels; ++i)
+      codes[0][i] = control.dac_code(i);
+    for (size_t tick = 1; tick <= period; ++tick) {
+      Process(control, 230);
+      for (uint8_t i = 0; i < streams::kNumChannels; ++i)
+        codes[tick][i] = control.dac_code(i);
+    }
+    for (uint8_t i = 0; i < streams::kNumChannels; ++i) {
+      int32_t step = codes[1][i] - codes[0][i];
+      for (size_t tick = 2; tick <= period; ++tick)
+        ASSERT_NEAR(step, codes[tick][i] - codes[tick - 1][i], 1) << "ch=" << (int)i;
+    }
+  }
+}
+
+// The state is interpolated rather than the outputs, so combined outputs are
+// still rendered on every tick
+TEST(LorenzTest, ControlRateXor) {
+  Configure();
+  control.set_out_a(streams::LORENZ_OUTPUT_X1);
+  control.set_out_b(streams::LORENZ_OUTPUT_Y1);
+  control.set_out_c(streams::LORENZ_OUTPUT_LX1_XOR_LY1);
+  for (size_t tick = 0; tick < 200 << kControlRate; ++tick) {
+    Process(control, 230);
+    ASSERT_EQ(control.dac_code(0) ^ control.dac_code(1), control.dac_code(2)) << "tick=" << tick;
+  }
+}
+
+// Until the attractors diverge, as chaotic systems do, the control rate
+// version follows the per-tick trajectory, one control period later
+TEST(LorenzTest, ControlRateTrajectory) {
+  const size_t period = 1 << kControlRate;
+  for (int32_t rate : { 120, 160, 200 }) {
+    Configure();
+    int32_t max_error = 0;
+    std::vector<uint16_t> per_tick_codes[streams::kNumChannels];
+    for (size_t tick = 0; tick < 4096; ++tick) {
+      Process(per_tick, rate);
+      Process(control, rate);
+      for (uint8_t i = 0; i < streams::kNumChannels; ++i)
+        per_tick_codes[i].push_back(per_tick.dac_code(i));
+      // The first periods glide from zero
+      if (tick < 2 * period)
+        continue;
+      for (uint8_t i = 0; i < streams::kNumChannels; ++i)
+        max_error = std::max(max_error, abs(per_tick_codes[i][tick - period] - control.dac_code(i)));
+    }
+    EXPECT_LT(max_error, 256) << "rate=" << rate;
+  }
+}
+
+// Over long runs the trajectories differ, but the spectra should be very
+// close; outputs are sampled once per control period.
+TEST(LorenzTest, ControlRateSpectrum) {
+  const size_t kSettle = 1 << 18;
+  const size_t kSamples = 1 << 16;
+  for (int32_t rate : { 160, 200, 230, 255 }) {
+    Configure();
+    std::vector<double> per_tick_signal[streams::kNumChannels], control_signal[streams::kNumChannels];
+    for (size_t tick = 0; tick < kSettle + (kSamples << kControlRate); ++tick) {
+      Process(per_tick, rate);
+      Process(control, rate);
+      if (tick >= kSettle && !(tick & ((1 << kControlRate) - 1))) {
+        for (uint8_t i = 0; i < streams::kNumChannels; ++i) {
+          per_tick_signal[i].push_back(per_tick.dac_code(i));
+          control_signal[i].push_back(control.dac_code(i));
+        }
+      }
+    }
+
+    for (uint8_t i = 0; i < streams::kNumChannels; ++i) {
+      double per_tick_bands[kBands], control_bands[kBands];
+      OctaveBands(per_tick_signal[i], per_tick_bands);
+      OctaveBands(control_signal[i], control_bands);
+      for (size_t band = 0; band < kBands; ++band)
+        EXPECT_NEAR(per_tick_bands[band], control_bands[band], 0.1) << "rate=" << rate << " ch=" << (int)i << " band=" << band;
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "OC_apps.h"
+#include "OC_debug.h"
+
+TEST(CycleHistogram, Buckets) {
+  EXPECT_EQ(0U, debug::CycleHistogram::bucket_index(0));
+  EXPECT_EQ(1U, debug::CycleHistogram::bucket_index(1));
+  EXPECT_EQ(2U, debug::CycleHistogram::bucket_index(2));
+  EXPECT_EQ(2U, debug::CycleHistogram::bucket_index(3));
+  EXPECT_EQ(3U, debug::CycleHistogram::bucket_index(4));
+  EXPECT_EQ(debug::CycleHistogram::kNumBuckets - 1, debug::CycleHistogram::bucket_index(0xffffffff));
+
+  for (size_t i = 0; i < debug::CycleHistogram::kNumBuckets; ++i)
+    EXPECT_EQ(i, debug::CycleHistogram::bucket_index(debug::CycleHistogram::bucket_value(i)));
+}
+
+TEST(CycleHistogram, HighWaterMark) {
+  debug::CycleHistogram histogram;
+  histogram.push(100, 1, 10);
+  histogram.push(7200, 2, 20);
+  histogram.push(50, 3, 30);
+
+  EXPECT_EQ(3U, histogram.count());
+  EXPECT_EQ(7200U, histogram.max_value());
+  EXPECT_EQ(2U, histogram.max_tag());
+  EXPECT_EQ(20U, histogram.max_timestamp());
+  EXPECT_EQ(1U, histogram.bucket(debug::CycleHistogram::bucket_index(7200)));
+
+  histogram.Reset();
+  EXPECT_EQ(0U, histogram.count());
+  EXPECT_EQ(0U, histogram.max_value());
+}
+
+TEST(CycleHistogram, CoreISR) {
+  oc_sim::Simulator::Boot();
+  OC::DEBUG::ResetHistograms();
+  oc_sim::Simulator::Tick(1000);
+
+  const debug::CycleHistogram &histogram = OC::DEBUG::ISR_histogram;
+  EXPECT_EQ(1000U, histogram.count());
+  EXPECT_EQ(OC::apps::current_app->id, histogram.max_tag());
+  EXPECT_LT(histogram.max_timestamp(), 1000U);
+  EXPECT_EQ(1000U / oc_sim::Simulator::kUiTicks, OC::DEBUG::UI_histogram.count());
+}
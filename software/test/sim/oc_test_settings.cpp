@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "OC_apps.h"
+#include "OC_apps_storage.h"
+#include <string.h>
+#include <vector>
+
+using oc_sim::Simulator;
+
+namespace OC {
+void save_app_data();
+};
+
+namespace {
+
+// As written per apps::SaveStep
+static const size_t kSaveBytesPerStep = 32;
+
+struct Random {
+  uint32_t state;
+  uint32_t Next() {
+    state = state * 1664525 + 1013904223;
+    return state;
+  }
+};
+
+// Interrupt saves with few and many changes at every byte, using the storage
+// layout of the firmware; the data must always load, with each byte either the
+// previous or the new value, and saving again must complete the save.
+template <typename Storage, typename Data>
+void CrashAtAnyByte(uint32_t seed) {
+  Random random = { seed };
+  Data previous;
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(&previous);
+  for (size_t i = 0; i < sizeof(Data); ++i)
+    bytes[i] = random.Next() >> 24;
+  {
+    Storage storage;
+    Data data;
+    ASSERT_FALSE(storage.Load(data));
+    ASSERT_TRUE(storage.Save(previous));
+  }
+
+  std::vector<uint8_t> eeprom;
+  for (int save = 0; save < 6; ++save) {
+    SCOPED_TRACE(save);
+    Data next = previous;
+    const size_t changes = save & 1 ? 40 : 1 + save;
+    for (size_t i = 0; i < changes; ++i) {
+      uint32_t r = random.Next();
+      reinterpret_cast<uint8_t *>(&next)[(r >> 8) % sizeof(Data)] += 1 + (r & 0x7f);
+    }
+
+    eeprom.assign(oc_sim::eeprom, oc_sim::eeprom + oc_sim::kEEPROMSize);
+    uint32_t save_writes = oc_sim::eeprom_writes;
+    {
+      Storage storage;
+      Data data;
+      ASSERT_TRUE(storage.Load(data));
+      ASSERT_TRUE(storage.Save(next));
+    }
+    save_writes = oc_sim::eeprom_writes - save_writes;
+
+    for (uint32_t crash = 0; crash <= save_writes; ++crash) {
+      std::copy(eeprom.begin(), eeprom.end(), oc_sim::eeprom);
+      Storage storage;
+      Data data;
+      ASSERT_TRUE(storage.Load(data));
+      ASSERT_EQ(0, memcmp(&previous, &data, sizeof(Data)));
+
+      oc_sim::eeprom_write_budget = crash;
+      ASSERT_TRUE(storage.BeginSave(next));
+      while (!storage.SaveStep(kSaveBytesPerStep)) { }
+      oc_sim::eeprom_write_budget = UINT32_MAX;
+
+      Storage reloaded;
+      ASSERT_TRUE(reloaded.Load(data)) << "crash=" << crash;
+      const uint8_t *loaded = reinterpret_cast<const uint8_t *>(&data);
+      for (size_t i = 0; i < sizeof(Data); ++i) {
+        ASSERT_TRUE(loaded[i] == reinterpret_cast<const uint8_t *>(&previous)[i] ||
+                    loaded[i] == reinterpret_cast<const uint8_t *>(&next)[i]) << "crash=" << crash << " i=" << i;
+      }
+
+      reloaded.Save(next);
+      ASSERT_TRUE(Storage().Load(data)) << "crash=" << crash;
+      ASSERT_EQ(0, memcmp(&next, &data, sizeof(Data))) << "crash=" << crash;
+    }
+
+    std::copy(eeprom.begin(), eeprom.end(), oc_sim::eeprom);
+    Storage storage;
+    Data data;
+    ASSERT_TRUE(storage.Load(data));
+    ASSERT_TRUE(storage.Save(next));
+    previous = next;
+  }
+}
+
+}; // namespace
+
+class SettingsStorageTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    Simulator::Boot();
+    std::fill(oc_sim::eeprom, oc_sim::eeprom + oc_sim::kEEPROMSize, 0xff);
+  }
+};
+
+// There's only room for one page each, so both have a journal
+TEST_F(SettingsStorageTest, Layout) {
+  EXPECT_EQ(1U, +OC::GlobalSettingsStorage::PAGES);
+  EXPECT_EQ(1U, +OC::AppDataStorage::PAGES);
+  EXPECT_LT(static_cast<size_t>(OC::GlobalSettingsStorage::JOURNAL_ADDR), static_cast<size_t>(EEPROM_GLOBALSETTINGS_END));
+  EXPECT_LT(static_cast<size_t>(OC::AppDataStorage::JOURNAL_ADDR), static_cast<size_t>(EEPROM_APPDATA_END));
+}
+
+TEST_F(SettingsStorageTest, GlobalSettingsCrashAtAnyByte) {
+  CrashAtAnyByte<OC::GlobalSettingsStorage, OC::GlobalSettings>(0x1234);
+}
+
+TEST_F(SettingsStorageTest, AppDataCrashAtAnyByte) {
+  CrashAtAnyByte<OC::AppDataStorage, OC::AppData>(0x5678);
+}
+
+// App data is serialized one app per step before anything is written
+TEST_F(SettingsStorageTest, SaveAppDataIncrementally) {
+  OC::apps::Init(false);
+  const uint32_t writes = oc_sim::eeprom_writes;
+  OC::save_app_data();
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    EXPECT_FALSE(OC::apps::SaveStep());
+    EXPECT_EQ(writes, oc_sim::eeprom_writes);
+  }
+
+  size_t steps = 0;
+  while (!OC::apps::SaveStep()) {
+    EXPECT_GE(kSaveBytesPerStep * (steps + 1), oc_sim::eeprom_writes - writes);
+    ++steps;
+  }
+  EXPECT_LT(0U, steps);
+
+  OC::AppDataStorage storage;
+  OC::AppData data;
+  ASSERT_TRUE(storage.Load(data));
+  EXPECT_LT(0U, data.used);
+  EXPECT_GE(+OC::AppData::kAppDataSize, data.used);
+}
@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+#include "oc_test_sim_util.h"
+#include "OC_apps.h"
+#include "OC_calibration.h"
+#include <string.h>
+
+using oc_sim::Simulator;
+using oc_sim::DacFrame;
+
+class SimulatorTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    Simulator::Boot();
+  }
+
+  virtual void TearDown() {
+    Simulator::set_capture(nullptr);
+  }
+};
+
+TEST_F(SimulatorTest, Boot) {
+  EXPECT_LT(0U, Simulator::num_apps());
+  EXPECT_EQ(0U, Simulator::ticks());
+}
+
+TEST_F(SimulatorTest, VirtualTime) {
+  uint32_t start = micros();
+  Simulator::Tick(OC_CORE_ISR_FREQ);
+  EXPECT_EQ(OC_CORE_ISR_FREQ, Simulator::ticks());
+  EXPECT_EQ(OC_CORE_ISR_FREQ * OC_CORE_TIMER_RATE, micros() - start);
+}
+
+TEST_F(SimulatorTest, Capture) {
+  std::vector<DacFrame> frames;
+  Simulator::set_capture(&frames);
+  Simulator::Tick(100);
+  EXPECT_EQ(100U, frames.size());
+}
+
+TEST_F(SimulatorTest, CV) {
+  Simulator::SetCV(ADC_CHANNEL_2, 1234);
+  Simulator::SetCV(ADC_CHANNEL_4, -567);
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 64);
+  EXPECT_NEAR(1234, OC::ADC::value(ADC_CHANNEL_2), 1);
+  EXPECT_NEAR(-567, OC::ADC::value(ADC_CHANNEL_4), 1);
+  EXPECT_NEAR(0, OC::ADC::value(ADC_CHANNEL_1), 1);
+}
+
+TEST_F(SimulatorTest, AdcSnapshot) {
+  Simulator::SetCV(ADC_CHANNEL_1, 1536);
+  Simulator::SetCV(ADC_CHANNEL_3, -800);
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 64);
+
+  const OC::ADC::Snapshot &snapshot = OC::ADC::snapshot();
+  const OC::ADC::CalibrationData &calibration = OC::calibration_data.adc;
+  for (int i = ADC_CHANNEL_1; i < ADC_CHANNEL_LAST; ++i) {
+    ADC_CHANNEL channel = static_cast<ADC_CHANNEL>(i);
+    int32_t value = calibration.offset[channel] - static_cast<int32_t>(snapshot.smoothed[channel]);
+    int32_t raw_value = calibration.offset[channel] - static_cast<int32_t>(snapshot.raw[channel]);
+    EXPECT_EQ(value, snapshot.value[channel]);
+    EXPECT_EQ((value * calibration.pitch_cv_scale) >> 12, snapshot.pitch[channel]);
+    EXPECT_EQ((raw_value * calibration.pitch_cv_scale) >> 12, snapshot.raw_pitch[channel]);
+    EXPECT_EQ(snapshot.value[channel], OC::ADC::value(channel));
+    EXPECT_EQ(snapshot.pitch[channel], OC::ADC::pitch_value(channel));
+    EXPECT_EQ(snapshot.raw_pitch[channel], OC::ADC::raw_pitch_value(channel));
+  }
+  EXPECT_NEAR(1536, snapshot.value[ADC_CHANNEL_1], 1);
+
+  // A published snapshot doesn't change when the next scan completes
+  const OC::ADC::Snapshot copy = snapshot;
+  Simulator::SetCV(ADC_CHANNEL_1, 0);
+  Simulator::Tick(Simulator::kAdcTicksPerScan);
+  EXPECT_NE(&snapshot, &OC::ADC::snapshot());
+  EXPECT_EQ(0, memcmp(&copy, &snapshot, sizeof(copy)));
+  EXPECT_GT(snapshot.value[ADC_CHANNEL_1], OC::ADC::value(ADC_CHANNEL_1));
+}
+
+TEST_F(SimulatorTest, AdcFilterPresets) {
+  for (int i = ADC_CHANNEL_1; i < ADC_CHANNEL_LAST; ++i) {
+    ADC_CHANNEL channel = static_cast<ADC_CHANNEL>(i);
+    EXPECT_EQ(OC::ADC::FILTER_PRESET_DEFAULT, OC::calibration_data.adc_filter_preset(channel));
+    EXPECT_EQ(OC::ADC_FILTER_ONE_POLE, OC::ADC::filter_type(channel));
+    EXPECT_EQ(+OC::ADCFilter::kDefaultShift, OC::ADC::filter_shift(channel));
+  }
+
+  OC::CalibrationData calibration = OC::calibration_data;
+  calibration.set_adc_filter_preset(ADC_CHANNEL_2, OC::ADC::FILTER_PRESET_MEDIAN);
+  calibration.set_adc_filter_preset(ADC_CHANNEL_4, OC::ADC::FILTER_PRESET_SMOOTH);
+  EXPECT_EQ(OC::ADC::FILTER_PRESET_DEFAULT, calibration.adc_filter_preset(ADC_CHANNEL_1));
+  EXPECT_EQ(OC::ADC::FILTER_PRESET_MEDIAN, calibration.adc_filter_preset(ADC_CHANNEL_2));
+  EXPECT_EQ(OC::ADC::FILTER_PRESET_DEFAULT, calibration.adc_filter_preset(ADC_CHANNEL_3));
+  EXPECT_EQ(OC::ADC::FILTER_PRESET_SMOOTH, calibration.adc_filter_preset(ADC_CHANNEL_4));
+
+  // A step settles within a scan with the fast preset, but only slowly with
+  // the smooth one
+  OC::ADC::set_filter_preset(ADC_CHANNEL_1, OC::ADC::FILTER_PRESET_FAST);
+  OC::ADC::set_filter_preset(ADC_CHANNEL_2, OC::ADC::FILTER_PRESET_SMOOTH);
+  EXPECT_EQ(OC::ADC_FILTER_BOX, OC::ADC::filter_type(ADC_CHANNEL_1));
+  EXPECT_EQ(+OC::ADC::kSmoothShift, OC::ADC::filter_shift(ADC_CHANNEL_2));
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 256);
+  EXPECT_NEAR(0, OC::ADC::value(ADC_CHANNEL_2), 16);
+  Simulator::SetCV(ADC_CHANNEL_1, 1000);
+  Simulator::SetCV(ADC_CHANNEL_2, 1000);
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 3);
+  EXPECT_NEAR(1000, OC::ADC::value(ADC_CHANNEL_1), 1);
+  EXPECT_LT(OC::ADC::value(ADC_CHANNEL_2), 500);
+  Simulator::Tick(Simulator::kAdcTicksPerScan * 256);
+  EXPECT_NEAR(1000, OC::ADC::value(ADC_CHANNEL_2), 16);
+}
+
+TEST_F(SimulatorTest, Trigger) {
+  Simulator::Tick(1);
+  EXPECT_EQ(0U, OC::DigitalInputs::clocked());
+
+  Simulator::Trigger(OC::DIGITAL_INPUT_3);
+  Simulator::Tick(1);
+  EXPECT_EQ(0x1U << OC::DIGITAL_INPUT_3, OC::DigitalInputs::clocked());
+  EXPECT_EQ(1U, OC::DigitalInputs::edges(OC::DIGITAL_INPUT_3));
+  EXPECT_EQ(0U, OC::DigitalInputs::edges(OC::DIGITAL_INPUT_1));
+  EXPECT_EQ(0U, OC::DigitalInputs::edge_period(OC::DIGITAL_INPUT_3));
+
+  Simulator::Tick(1);
+  EXPECT_EQ(0U, OC::DigitalInputs::clocked());
+  EXPECT_EQ(0U, OC::DigitalInputs::edges(OC::DIGITAL_INPUT_3));
+
+  // All edges within a tick are timestamped; the cycle counter runs on host
+  // time in the simulator, so only the order is deterministic
+  Simulator::Trigger(OC::DIGITAL_INPUT_3);
+  Simulator::Trigger(OC::DIGITAL_INPUT_3);
+  Simulator::Tick(1);
+  ASSERT_EQ(2U, OC::DigitalInputs::edges(OC::DIGITAL_INPUT_3));
+  EXPECT_GE(OC::DigitalInputs::edge_offset(OC::DIGITAL_INPUT_3, 0),
+            OC::DigitalInputs::edge_offset(OC::DIGITAL_INPUT_3, 1));
+  EXPECT_EQ(OC::DigitalInputs::edge_timestamp(OC::DIGITAL_INPUT_3, 1) - OC::DigitalInputs::edge_timestamp(OC::DIGITAL_INPUT_3, 0),
+            OC::DigitalInputs::edge_period(OC::DIGITAL_INPUT_3));
+
+  // Only the rising edge at the jack clocks the input
+  Simulator::SetGate(OC::DIGITAL_INPUT_1, true);
+  Simulator::Tick(1);
+  EXPECT_EQ(0x1U << OC::DIGITAL_INPUT_1, OC::DigitalInputs::clocked());
+  Simulator::SetGate(OC::DIGITAL_INPUT_1, true);
+  Simulator::Tick(1);
+  EXPECT_EQ(0U, OC::DigitalInputs::clocked());
+  EXPECT_TRUE(OC::DigitalInputs::read_immediate<OC::DIGITAL_INPUT_1>());
+}
+
+// Restoring arbitrary data clamps every setting into range, after which saving
+// and restoring has to be lossless.
+TEST_F(SimulatorTest, SettingsRoundTrip) {
+  uint32_t random = 0xfeed;
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    SCOPED_TRACE(Simulator::app_name(app));
+    OC::App *instance = OC::apps::find(Simulator::app_id(app));
+    ASSERT_NE(nullptr, instance);
+    const size_t storage_size = instance->storageSize();
+
+    std::vector<uint8_t> noise(storage_size), saved(storage_size + 1, 0xa5), resaved(storage_size + 1, 0x5a);
+    for (auto &b : noise) {
+      random = random * 1664525 + 1013904223;
+      b = random >> 24;
+    }
+
+    EXPECT_EQ(storage_size, instance->Restore(noise.data()));
+    EXPECT_EQ(storage_size, instance->Save(saved.data()));
+    EXPECT_EQ(0xa5, saved.back());
+    EXPECT_EQ(storage_size, instance->Restore(saved.data()));
+    EXPECT_EQ(storage_size, instance->Save(resaved.data()));
+    resaved.back() = saved.back();
+    EXPECT_TRUE(saved == resaved);
+  }
+}
+
+static void RunScript(uint16_t app_id, std::vector<DacFrame> &frames) {
+  RunInChild([app_id]() {
+    Simulator::SelectApp(app_id);
+    for (int i = 0; i < 16; ++i) {
+      Simulator::SetCV(ADC_CHANNEL_1, i * 200);
+      Simulator::SetCV(ADC_CHANNEL_2, 1000 - i * 100);
+      Simulator::Trigger(static_cast<OC::DigitalInput>(i & 0x3));
+      Simulator::Tick(500);
+      Simulator::Loop();
+    }
+  }, 16 * 500, frames);
+}
+
+TEST_F(SimulatorTest, Deterministic) {
+  for (size_t app = 0; app < Simulator::num_apps(); ++app) {
+    SCOPED_TRACE(Simulator::app_name(app));
+
+    std::vector<DacFrame> first, second;
+    RunScript(Simulator::app_id(app), first);
+    RunScript(Simulator::app_id(app), second);
+
+    ASSERT_EQ(first.size(), second.size());
+    EXPECT_TRUE(first == second);
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef OC_TEST_SIM_UTIL_H_
+#define OC_TEST_SIM_UTIL_H_
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <functional>
+#include <vector>
+#include "gtest/gtest.h"
+#include "oc_sim.h"
+
+// Apps don't necessarily reset all their state in Init, so runs that need to
+// be compared happen in a child process that starts from the current state.
+// The frames captured in the child are passed back via a pipe.
+static inline void RunInChild(std::function<void()> script, size_t num_frames,
+                              std::vector<oc_sim::DacFrame> &frames) {
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  pid_t pid = fork();
+  ASSERT_LE(0, pid);
+  if (!pid) {
+    close(fds[0]);
+    std::vector<oc_sim::DacFrame> captured;
+    oc_sim::Simulator::set_capture(&captured);
+    script();
+    oc_sim::Simulator::set_capture(nullptr);
+    captured.resize(num_frames);
+
+    const char *data = reinterpret_cast<const char *>(captured.data());
+    size_t len = captured.size() * sizeof(oc_sim::DacFrame);
+    while (len) {
+      ssize_t written = write(fds[1], data, len);
+      if (written <= 0) break;
+      data += written;
+      len -= written;
+    }
+    _exit(len ? 1 : 0);
+  }
+
+  close(fds[1]);
+  frames.resize(num_frames);
+  char *data = reinterpret_cast<char *>(frames.data());
+  size_t len = frames.size() * sizeof(oc_sim::DacFrame);
+  while (len) {
+    ssize_t n = read(fds[0], data, len);
+    if (n <= 0) break;
+    data += n;
+    len -= n;
+  }
+  close(fds[0]);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+  ASSERT_EQ(0U, len);
+}
+
+#endif // OC_TEST_SIM_UTIL_H_